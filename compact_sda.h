@@ -0,0 +1,601 @@
+/*
+MIT License
+
+Copyright 2020 Than Minh Duy (macodeth)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+OR OTHER DEALINGS IN THE SOFTWARE.
+
+*/
+
+
+#ifndef SYMMETRIC_DYNAMIC_ARRAY_COMPACT
+#define SYMMETRIC_DYNAMIC_ARRAY_COMPACT
+
+
+
+#include<algorithm>
+#include<cstddef>
+#include<cstdint>
+#include<initializer_list>
+#include<iterator>
+#include<limits>
+#include<memory>
+#include<stdexcept>
+#include<type_traits>
+#include<utility>
+
+
+
+//
+//    sda with a one pointer header: begin, end and tail are 32-bit
+//    offsets stored in front of the elements, head is offset 0
+//
+//       compact_sda : [block*]
+//       block       : [begin end tail] # # # 1 2 3 4 # #
+//
+//    an empty compact_sda owns no block, sizeof is sizeof(void*)
+//    with a stateless allocator
+//
+//    same growth and same rule as sda: insert and erase move the
+//    side with fewer elements, growing keeps the other side's
+//    empty capacity
+//    at most 2^32 - 1 elements
+//
+
+
+template<class T, class Allocator = std::allocator<T>>
+class compact_sda
+{
+   public:
+   typedef T value_type;
+   typedef Allocator allocator_type;
+   typedef value_type& reference;
+   typedef const value_type& const_reference;
+   typedef value_type* pointer;
+   typedef const value_type* const_pointer;
+   typedef pointer iterator;
+   typedef const_pointer const_iterator;
+   typedef std::reverse_iterator<iterator> reverse_iterator;
+   typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+   typedef std::ptrdiff_t difference_type;
+   typedef std::size_t size_type;
+
+
+   private:
+   typedef std::allocator_traits<allocator_type> alloc_trait;
+   typedef std::uint32_t offset_type;
+
+   struct header
+   {
+      offset_type begin;
+      offset_type end;
+      offset_type tail;
+   };
+
+   //    allocation unit, aligned for both header and elements
+   static constexpr size_type unit_align = alignof(value_type) > alignof(header) ?
+      alignof(value_type) : alignof(header);
+   struct alignas(unit_align) unit
+   {
+      unsigned char bytes[unit_align];
+   };
+   static constexpr size_type header_units = (sizeof(header) + sizeof(unit) - 1) / sizeof(unit);
+
+   typedef typename alloc_trait::template rebind_alloc<unit> unit_allocator;
+   typedef std::allocator_traits<unit_allocator> unit_trait;
+
+   struct Impl : public unit_allocator
+   {
+      unit* block_ = nullptr;
+
+      Impl() = default;
+      Impl(const allocator_type& alloc) : unit_allocator(alloc) {}
+   } impl_;
+
+
+   //---------------------------
+   //    BLOCK
+   //---------------------------
+   header* head() const noexcept
+   {
+      return reinterpret_cast<header*>(impl_.block_);
+   }
+   pointer base() const noexcept
+   {
+      return reinterpret_cast<pointer>(impl_.block_ + header_units);
+   }
+   pointer begin_pointer() const noexcept
+   {
+      return impl_.block_ ? base() + head()->begin : nullptr;
+   }
+   pointer end_pointer() const noexcept
+   {
+      return impl_.block_ ? base() + head()->end : nullptr;
+   }
+   static size_type units(size_type capacity) noexcept
+   {
+      return header_units + (capacity * sizeof(value_type) + sizeof(unit) - 1) / sizeof(unit);
+   }
+   unit* allocate(size_type capacity)
+   {
+      if(capacity > max_size()) throw std::length_error("std::length_error");
+      unit* block = unit_trait::allocate(impl_, units(capacity));
+      ::new(static_cast<void*>(block)) header{0, 0, offset_type(capacity)};
+      return block;
+   }
+   void deallocate() noexcept
+   {
+      if(!impl_.block_) return;
+      destroy(begin_pointer(), end_pointer());
+      unit_trait::deallocate(impl_, impl_.block_, units(head()->tail));
+      impl_.block_ = nullptr;
+   }
+
+   template<class... Args>
+   void construct(pointer p, Args&&... args)
+   {
+      allocator_type alloc(impl_);
+      alloc_trait::construct(alloc, p, std::forward<Args>(args)...);
+   }
+   void destroy(pointer start, pointer finish) noexcept
+   {
+      allocator_type alloc(impl_);
+      for(; start != finish; start++) alloc_trait::destroy(alloc, start);
+   }
+   void uninitialized_move(pointer start, pointer finish, pointer d_first)
+   {
+      for(; start != finish; start++, d_first++) construct(d_first, std::move_if_noexcept(*start));
+   }
+
+   //------------------------------------------------------
+   //    RELOCATE
+   //    move into a new block, front empty slots before
+   //    the elements and n raw slots at index k,
+   //    the gap is counted in size()
+   //------------------------------------------------------
+   pointer relocate(size_type capacity, size_type front, size_type k = 0, size_type n = 0)
+   {
+      size_type count = size();
+      unit* block = allocate(capacity);
+      pointer new_first = reinterpret_cast<pointer>(block + header_units) + front;
+      if(impl_.block_)
+      {
+         uninitialized_move(begin_pointer(), begin_pointer() + k, new_first);
+         uninitialized_move(begin_pointer() + k, end_pointer(), new_first + k + n);
+      }
+      deallocate();
+      impl_.block_ = block;
+      head()->begin = offset_type(front);
+      head()->end = offset_type(front + count + n);
+      return new_first + k;
+   }
+
+   //---------------------------
+   //    GROWTH FORMULA
+   //---------------------------
+   size_type new_capacity_front_growing() const noexcept
+   {
+      size_type capacity = front_capacity();
+      return empty_back_capacity() + capacity + (capacity >> 2) + 2;
+   }
+   size_type new_capacity_back_growing() const noexcept
+   {
+      size_type capacity = back_capacity();
+      return empty_front_capacity() + capacity + (capacity >> 2) + 2;
+   }
+
+   //-------------------------------------------------------------
+   //    OPEN GAP
+   //    make n slots at index k, shifting the side with fewer
+   //    elements, or reallocating when that side has no room
+   //
+   //    place(p, raw) fills each slot in order, raw slots need
+   //    construction, the others hold moved-from elements
+   //-------------------------------------------------------------
+   template<class Place>
+   pointer open_gap(size_type k, size_type n, Place place)
+   {
+      size_type count = size();
+      bool front_room = empty_front_capacity() >= n;
+      bool back_room = empty_back_capacity() >= n;
+      bool back = k >= count - k;
+      if(back_room && (back || !front_room))
+      {
+         pointer p = begin_pointer() + k;
+         pointer e = end_pointer();
+         if(n <= count - k)
+         {
+            uninitialized_move(e - n, e, e);
+            std::move_backward(p, e - n, e);
+            head()->end += offset_type(n);
+            for(pointer q = p; q != p + n; q++) place(q, false);
+         }
+         else
+         {
+            uninitialized_move(p, e, p + n);
+            head()->end += offset_type(n);
+            for(pointer q = p; q != p + n; q++) place(q, q >= e);
+         }
+         return p;
+      }
+      if(front_room)
+      {
+         pointer h = begin_pointer();
+         pointer p = h + k;
+         if(n <= k)
+         {
+            uninitialized_move(h, h + n, h - n);
+            std::move(h + n, p, h);
+         }
+         else
+            uninitialized_move(h, p, h - n);
+         head()->begin -= offset_type(n);
+         for(pointer q = p - n; q != p; q++) place(q, q < h);
+         return p - n;
+      }
+
+      //    no room: the end being grown gets the new capacity
+      pointer p;
+      if(k == count)
+      {
+         size_type capacity = std::max(new_capacity_back_growing(), empty_front_capacity() + count + n);
+         p = relocate(capacity, empty_front_capacity(), k, n);
+      }
+      else if(k == 0)
+      {
+         size_type capacity = std::max(new_capacity_front_growing(), empty_back_capacity() + count + n);
+         p = relocate(capacity, capacity - count - n - empty_back_capacity(), k, n);
+      }
+      else
+      {
+         size_type capacity = count + n + (count >> 2) + 2;
+         p = relocate(capacity, (capacity - count - n) >> 1, k, n);
+      }
+      for(pointer q = p; q != p + n; q++) place(q, true);
+      return p;
+   }
+
+
+   public:
+   //--------------------
+   //    CONSTRUCTOR
+   //--------------------
+   compact_sda() = default;
+
+   explicit compact_sda(const allocator_type& alloc) : impl_(alloc) {}
+
+   explicit compact_sda(size_type n, const allocator_type& alloc = allocator_type()) : impl_(alloc)
+   {
+      resize(n);
+   }
+   compact_sda(size_type n, const value_type& val, const allocator_type& alloc = allocator_type()) : impl_(alloc)
+   {
+      resize(n, val);
+   }
+   template<class InputIterator, typename = typename std::enable_if<std::is_convertible<typename
+      std::iterator_traits<InputIterator>::iterator_category, std::input_iterator_tag>::value>::type>
+   compact_sda(InputIterator first, InputIterator last, const allocator_type& alloc = allocator_type()) : impl_(alloc)
+   {
+      insert(end(), first, last);
+   }
+   compact_sda(std::initializer_list<value_type> il, const allocator_type& alloc = allocator_type())
+   : compact_sda(il.begin(), il.end(), alloc) {}
+
+   compact_sda(const compact_sda& other)
+   : impl_(alloc_trait::select_on_container_copy_construction(other.get_allocator()))
+   {
+      insert(end(), other.begin(), other.end());
+   }
+   compact_sda(compact_sda&& other) noexcept : impl_(other.get_allocator())
+   {
+      std::swap(impl_.block_, other.impl_.block_);
+   }
+   ~compact_sda()
+   {
+      deallocate();
+   }
+
+   compact_sda& operator= (const compact_sda& other)
+   {
+      if(this != &other) assign(other.begin(), other.end());
+      return *this;
+   }
+   compact_sda& operator= (compact_sda&& other) noexcept
+   {
+      swap(other);
+      return *this;
+   }
+   compact_sda& operator= (std::initializer_list<value_type> il)
+   {
+      assign(il.begin(), il.end());
+      return *this;
+   }
+   template<class InputIterator>
+   void assign(InputIterator first, InputIterator last)
+   {
+      clear();
+      insert(end(), first, last);
+   }
+   void assign(size_type n, const value_type& val)
+   {
+      clear();
+      insert(end(), n, val);
+   }
+   allocator_type get_allocator() const noexcept
+   {
+      return allocator_type(impl_);
+   }
+
+   //------------------
+   //    ITERATORS
+   //------------------
+   iterator begin() noexcept { return begin_pointer(); }
+   const_iterator begin() const noexcept { return begin_pointer(); }
+   const_iterator cbegin() const noexcept { return begin_pointer(); }
+   iterator end() noexcept { return end_pointer(); }
+   const_iterator end() const noexcept { return end_pointer(); }
+   const_iterator cend() const noexcept { return end_pointer(); }
+   reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+   const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+   reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+   const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+
+   //------------------------
+   //    CAPACITY
+   //------------------------
+   size_type size() const noexcept
+   {
+      return impl_.block_ ? head()->end - head()->begin : 0;
+   }
+   size_type capacity() const noexcept
+   {
+      return impl_.block_ ? head()->tail : 0;
+   }
+   size_type front_capacity() const noexcept
+   {
+      return impl_.block_ ? head()->end : 0;
+   }
+   size_type back_capacity() const noexcept
+   {
+      return impl_.block_ ? head()->tail - head()->begin : 0;
+   }
+   size_type empty_front_capacity() const noexcept
+   {
+      return impl_.block_ ? head()->begin : 0;
+   }
+   size_type empty_back_capacity() const noexcept
+   {
+      return impl_.block_ ? head()->tail - head()->end : 0;
+   }
+   size_type max_size() const noexcept
+   {
+      return std::numeric_limits<offset_type>::max();
+   }
+   bool empty() const noexcept
+   {
+      return size() == 0;
+   }
+
+   //-------------------------
+   //    RESERVE, SHRINK
+   //-------------------------
+   void reserve(size_type n)
+   {
+      if(n > capacity()) relocate(n, (n - size()) >> 1);
+   }
+   void reserve_back(size_type n)
+   {
+      if(n > back_capacity()) relocate(empty_front_capacity() + n, empty_front_capacity());
+   }
+   void reserve_front(size_type n)
+   {
+      if(n > front_capacity()) relocate(empty_back_capacity() + n, n - size());
+   }
+   //    an empty array gives its block back
+   void shrink_to_fit()
+   {
+      if(size() == capacity()) return;
+      if(size()) relocate(size(), 0);
+      else deallocate();
+   }
+
+   //-----------------------
+   //    ELEMENT ACCESS
+   //-----------------------
+   reference operator[] (size_type n) { return begin_pointer()[n]; }
+   const_reference operator[] (size_type n) const { return begin_pointer()[n]; }
+   reference at(size_type n)
+   {
+      if(n >= size()) throw std::out_of_range("std::out_of_range");
+      return begin_pointer()[n];
+   }
+   const_reference at(size_type n) const
+   {
+      if(n >= size()) throw std::out_of_range("std::out_of_range");
+      return begin_pointer()[n];
+   }
+   reference front() { return *begin_pointer(); }
+   const_reference front() const { return *begin_pointer(); }
+   reference back() { return end_pointer()[-1]; }
+   const_reference back() const { return end_pointer()[-1]; }
+   pointer data() noexcept { return begin_pointer(); }
+   const_pointer data() const noexcept { return begin_pointer(); }
+
+   //------------------------
+   //    PUSH, POP
+   //------------------------
+   template<class... Args>
+   reference emplace_back(Args&&... args)
+   {
+      if(empty_back_capacity())
+      {
+         construct(end_pointer(), std::forward<Args>(args)...);
+         head()->end++;
+      }
+      else
+      {
+         value_type tmp(std::forward<Args>(args)...);
+         open_gap(size(), 1, [&](pointer p, bool) { construct(p, std::move(tmp)); });
+      }
+      return back();
+   }
+   template<class... Args>
+   reference emplace_front(Args&&... args)
+   {
+      if(empty_front_capacity())
+      {
+         construct(begin_pointer() - 1, std::forward<Args>(args)...);
+         head()->begin--;
+      }
+      else
+      {
+         value_type tmp(std::forward<Args>(args)...);
+         open_gap(0, 1, [&](pointer p, bool) { construct(p, std::move(tmp)); });
+      }
+      return front();
+   }
+   void push_back(const value_type& val) { emplace_back(val); }
+   void push_back(value_type&& val) { emplace_back(std::move(val)); }
+   void push_front(const value_type& val) { emplace_front(val); }
+   void push_front(value_type&& val) { emplace_front(std::move(val)); }
+   void pop_back()
+   {
+      destroy(end_pointer() - 1, end_pointer());
+      head()->end--;
+   }
+   void pop_front()
+   {
+      destroy(begin_pointer(), begin_pointer() + 1);
+      head()->begin++;
+   }
+
+   //-------------------------
+   //    INSERT, EMPLACE
+   //-------------------------
+   template<class... Args>
+   iterator emplace(const_iterator pos, Args&&... args)
+   {
+      value_type tmp(std::forward<Args>(args)...);
+      return open_gap(pos - begin(), 1, [&](pointer p, bool raw)
+      {
+         if(raw) construct(p, std::move(tmp));
+         else *p = std::move(tmp);
+      });
+   }
+   iterator insert(const_iterator pos, const value_type& val)
+   {
+      return emplace(pos, val);
+   }
+   iterator insert(const_iterator pos, value_type&& val)
+   {
+      return emplace(pos, std::move(val));
+   }
+   iterator insert(const_iterator pos, size_type n, const value_type& val)
+   {
+      if(n == 0) return begin() + (pos - begin());
+      value_type tmp(val);
+      return open_gap(pos - begin(), n, [&](pointer p, bool raw)
+      {
+         if(raw) construct(p, tmp);
+         else *p = tmp;
+      });
+   }
+   template<class InputIterator, typename = typename std::enable_if<std::is_convertible<typename
+      std::iterator_traits<InputIterator>::iterator_category, std::input_iterator_tag>::value>::type>
+   iterator insert(const_iterator pos, InputIterator first, InputIterator last)
+   {
+      size_type k = pos - begin();
+      if constexpr (std::is_base_of<std::forward_iterator_tag, typename
+         std::iterator_traits<InputIterator>::iterator_category>::value)
+      {
+         size_type n = std::distance(first, last);
+         if(n == 0) return begin() + k;
+         return open_gap(k, n, [&](pointer p, bool raw)
+         {
+            if(raw) construct(p, *first);
+            else *p = *first;
+            ++first;
+         });
+      }
+      else
+      {
+         for(size_type i = k; first != last; ++first, i++) emplace(begin() + i, *first);
+         return begin() + k;
+      }
+   }
+   iterator insert(const_iterator pos, std::initializer_list<value_type> il)
+   {
+      return insert(pos, il.begin(), il.end());
+   }
+
+   //-------------------------
+   //    ERASE
+   //    the shorter side moves
+   //-------------------------
+   iterator erase(const_iterator pos)
+   {
+      return erase(pos, pos + 1);
+   }
+   iterator erase(const_iterator first, const_iterator last)
+   {
+      pointer f = begin() + (first - begin());
+      pointer l = begin() + (last - begin());
+      size_type n = l - f;
+      if(n == 0) return f;
+      if(size_type(f - begin_pointer()) < size_type(end_pointer() - l))
+      {
+         std::move_backward(begin_pointer(), f, l);
+         destroy(begin_pointer(), begin_pointer() + n);
+         head()->begin += offset_type(n);
+         return l;
+      }
+      std::move(l, end_pointer(), f);
+      destroy(end_pointer() - n, end_pointer());
+      head()->end -= offset_type(n);
+      return f;
+   }
+   void clear() noexcept
+   {
+      if(!impl_.block_) return;
+      destroy(begin_pointer(), end_pointer());
+      head()->end = head()->begin;
+   }
+   void resize(size_type n)
+   {
+      if(n <= size()) erase(begin() + n, end());
+      else
+      {
+         reserve_back(n);
+         for(; size() < n; head()->end++) construct(end_pointer());
+      }
+   }
+   void resize(size_type n, const value_type& val)
+   {
+      if(n <= size()) erase(begin() + n, end());
+      else insert(end(), n - size(), val);
+   }
+
+   void swap(compact_sda& other) noexcept
+   {
+      std::swap(impl_.block_, other.impl_.block_);
+   }
+};
+
+
+#endif
@@ -0,0 +1,411 @@
+/*
+MIT License
+
+Copyright 2020 Than Minh Duy (macodeth)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+OR OTHER DEALINGS IN THE SOFTWARE.
+
+*/
+
+
+
+#ifndef SYMMETRIC_DYNAMIC_ARRAY_CONCURRENT
+#define SYMMETRIC_DYNAMIC_ARRAY_CONCURRENT
+
+
+
+#include<algorithm>
+#include<atomic>
+#include<cstddef>
+#include<functional>
+#include<iterator>
+#include<memory>
+#include<mutex>
+#include<shared_mutex>
+#include<stdexcept>
+#include<utility>
+
+#include "sda.h"
+
+
+
+//
+//    sorted sequence shared by many writers: the values are cut
+//    into segments, each an sda behind its own mutex, and fence
+//    keys route a value to its segment
+//
+//       fences_   :          10        42
+//       segments_ : [1 4 7] [10 15 30] [42 50 61 90]
+//
+//    insert(val) / erase(val) lock the directory shared and one
+//    segment, writers on different segments run in parallel;
+//    contains(val) and the reads below take the segment locks
+//    shared, readers never wait for each other
+//
+//    positional reads and erases, snapshot() and for_each() lock
+//    the segments they need in ascending order while writers hold
+//    only one, so they see a consistent sequence; size() is an
+//    atomic counter updated under the segment lock
+//
+//    at(pos) and erase_at(pos) cannot know which segment holds
+//    pos without the sizes of all segments before it, so they
+//    lock every segment from the first one up to it: a positional
+//    call near the end serializes with all writers, prefer
+//    erase(val) and contains(val) on a hot path
+//
+//    rebalance() splits segments above 2 * segment_size and merges
+//    neighbours that fit in one, it takes the directory exclusively:
+//    run it from a background thread when needs_rebalance()
+//
+//    a writer that leaves its segment above 4 * segment_size splits
+//    that segment by itself: the pieces past the first are copied
+//    under the segment lock taken shared, then the directory is
+//    locked exclusively just to trim the segment and insert the
+//    pieces and their fences, O(segment_size) and not O(size())
+//
+//    reads are not optimistic: a writer may reallocate or shift the
+//    sda a reader walks, so a version check after the fact would
+//    come too late to avoid reading freed memory
+//
+
+
+template<class T, class Compare = std::less<T>, class Allocator = std::allocator<T>>
+class concurrent_sda
+{
+   public:
+   typedef sda<T, Allocator> segment_array;
+   typedef typename segment_array::allocator_type allocator_type;
+   typedef typename segment_array::value_type value_type;
+   typedef typename segment_array::size_type size_type;
+   typedef Compare value_compare;
+
+
+   private:
+   struct segment
+   {
+      std::shared_mutex lock;
+      segment_array array;
+      //    bumped by every write under the exclusive lock
+      size_type version = 0;
+   };
+   typedef std::unique_ptr<segment> segment_pointer;
+
+   //    fences_[i - 1] routes values to segment i, never empty
+   sda<segment_pointer> segments_;
+   segment_array fences_;
+   mutable std::shared_mutex directory_;
+   //    bumped by every change of segments_ under the exclusive lock
+   size_type layout_ = 0;
+   std::atomic<size_type> size_{0};
+   std::atomic<bool> unbalanced_{false};
+   size_type segment_size_;
+   Compare comp_;
+
+
+   //    last segment whose fence is not greater than val
+   size_type route(const value_type& val) const
+   {
+      return std::upper_bound(fences_.begin(), fences_.end(), val, comp_) - fences_.begin();
+   }
+   //    locks segments [0, count) on construction or lock(), shared
+   //    for readers, releases them on destruction
+   class segment_locks
+   {
+      const concurrent_sda* a_;
+      size_type count_ = 0;
+      bool shared_;
+
+      public:
+      explicit segment_locks(const concurrent_sda* a, bool shared = false) noexcept : a_(a), shared_(shared) {}
+      segment_locks(const segment_locks&) = delete;
+      segment_locks& operator= (const segment_locks&) = delete;
+      ~segment_locks()
+      {
+         while(count_)
+         {
+            segment& s = *a_->segments_[--count_];
+            if(shared_) s.lock.unlock_shared();
+            else s.lock.unlock();
+         }
+      }
+      segment& lock()
+      {
+         segment& s = *a_->segments_[count_];
+         if(shared_) s.lock.lock_shared();
+         else s.lock.lock();
+         count_++;
+         return s;
+      }
+      void lock_all()
+      {
+         while(count_ < a_->segments_.size()) lock();
+      }
+   };
+   //    lock the prefix up to the segment holding pos,
+   //    pos becomes the offset in that segment
+   segment& locate(segment_locks& locks, size_type& pos) const
+   {
+      for(size_type i = 0; i < segments_.size(); i++)
+      {
+         segment& s = locks.lock();
+         if(pos < s.array.size()) return s;
+         pos -= s.array.size();
+      }
+      throw std::out_of_range("std::out_of_range");
+   }
+   void new_segment(sda<segment_pointer>& out)
+   {
+      out.push_back(segment_pointer(new segment));
+   }
+   template<class V>
+   void insert_value(V&& val)
+   {
+      size_type n, i, layout;
+      {
+         std::shared_lock<std::shared_mutex> directory(directory_);
+         i = route(val);
+         layout = layout_;
+         segment& s = *segments_[i];
+         std::lock_guard<std::shared_mutex> guard(s.lock);
+         s.array.insert(std::upper_bound(s.array.begin(), s.array.end(), val, comp_), std::forward<V>(val));
+         s.version++;
+         size_.fetch_add(1, std::memory_order_relaxed);
+         n = s.array.size();
+      }
+      if(n > 4 * segment_size_)
+         split(i, layout);
+      else if(n > 2 * segment_size_)
+         unbalanced_.store(true, std::memory_order_relaxed);
+   }
+   //    a segment of n values keeps the first kept(n), the rest is
+   //    cut into pieces of segment_size, the first piece keeps the
+   //    remainder
+   size_type kept(size_type n) const noexcept
+   {
+      return n <= 2 * segment_size_ ? n : n - (n / segment_size_ - 1) * segment_size_;
+   }
+   template<class Iterator>
+   void cut(Iterator first, Iterator last, sda<segment_pointer>& out, segment_array& fences)
+   {
+      for(; first != last; first += segment_size_)
+      {
+         new_segment(out);
+         out.back()->array.assign(first, first + segment_size_);
+         fences.push_back(out.back()->array.front());
+      }
+   }
+   //    split segment i, found under layout: the pieces are copied
+   //    while readers go on, the exclusive section trims the segment
+   //    and links them, or moves them itself if a writer came in between
+   void split(size_type i, size_type layout)
+   {
+      sda<segment_pointer> pieces;
+      segment_array fences;
+      size_type version;
+      {
+         std::shared_lock<std::shared_mutex> directory(directory_);
+         if(layout != layout_) return;
+         segment& s = *segments_[i];
+         std::shared_lock<std::shared_mutex> guard(s.lock);
+         if(s.array.size() <= 4 * segment_size_) return;
+         cut(s.array.cbegin() + kept(s.array.size()), s.array.cend(), pieces, fences);
+         version = s.version;
+      }
+      std::unique_lock<std::shared_mutex> directory(directory_);
+      //    another writer split it first, or a rebalance ran
+      if(layout != layout_) return;
+      segment_array& a = segments_[i]->array;
+      if(version != segments_[i]->version)
+      {
+         pieces.clear();
+         fences.clear();
+         cut(std::make_move_iterator(a.begin() + kept(a.size())), std::make_move_iterator(a.end()), pieces, fences);
+      }
+      size_type keep = a.size() - pieces.size() * segment_size_;
+      while(a.size() > keep) a.pop_back();
+      fences_.insert(fences_.begin() + i, fences.begin(), fences.end());
+      segments_.insert(segments_.begin() + i + 1, std::make_move_iterator(pieces.begin()),
+         std::make_move_iterator(pieces.end()));
+      layout_++;
+   }
+
+
+   public:
+   explicit concurrent_sda(size_type segment_size = 4096, const Compare& comp = Compare())
+   : segment_size_(segment_size ? segment_size : 1), comp_(comp)
+   {
+      new_segment(segments_);
+   }
+   concurrent_sda(const concurrent_sda&) = delete;
+   concurrent_sda& operator= (const concurrent_sda&) = delete;
+
+   //------------------
+   //    CAPACITY
+   //------------------
+   size_type size() const noexcept
+   {
+      return size_.load(std::memory_order_relaxed);
+   }
+   bool empty() const noexcept
+   {
+      return size() == 0;
+   }
+   size_type segment_count() const
+   {
+      std::shared_lock<std::shared_mutex> directory(directory_);
+      return segments_.size();
+   }
+   bool needs_rebalance() const noexcept
+   {
+      return unbalanced_.load(std::memory_order_relaxed);
+   }
+
+   //------------------
+   //    INSERT, ERASE
+   //------------------
+   void insert(const value_type& val)
+   {
+      insert_value(val);
+   }
+   void insert(value_type&& val)
+   {
+      insert_value(std::move(val));
+   }
+   //    erase one element equal to val, false if none
+   bool erase(const value_type& val)
+   {
+      std::shared_lock<std::shared_mutex> directory(directory_);
+      //    equal values may spill over the fence into earlier segments
+      for(size_type i = route(val); ; i--)
+      {
+         segment& s = *segments_[i];
+         std::lock_guard<std::shared_mutex> guard(s.lock);
+         auto it = std::lower_bound(s.array.begin(), s.array.end(), val, comp_);
+         if(it != s.array.end() && !comp_(val, *it))
+         {
+            s.array.erase(it);
+            s.version++;
+            size_.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+         }
+         if(i == 0 || comp_(fences_[i - 1], val)) return false;
+      }
+   }
+   //    erase the pos-th element, locks segments [0, the one holding pos]
+   void erase_at(size_type pos)
+   {
+      std::shared_lock<std::shared_mutex> directory(directory_);
+      segment_locks locks(this);
+      segment& s = locate(locks, pos);
+      s.array.erase(s.array.begin() + pos);
+      s.version++;
+      size_.fetch_sub(1, std::memory_order_relaxed);
+   }
+   void clear()
+   {
+      std::unique_lock<std::shared_mutex> directory(directory_);
+      sda<segment_pointer> out;
+      new_segment(out);
+      segments_.swap(out);
+      fences_.clear();
+      layout_++;
+      size_.store(0, std::memory_order_relaxed);
+      unbalanced_.store(false, std::memory_order_relaxed);
+   }
+
+   //------------------
+   //    READ
+   //------------------
+   bool contains(const value_type& val) const
+   {
+      std::shared_lock<std::shared_mutex> directory(directory_);
+      for(size_type i = route(val); ; i--)
+      {
+         segment& s = *segments_[i];
+         std::shared_lock<std::shared_mutex> guard(s.lock);
+         if(std::binary_search(s.array.begin(), s.array.end(), val, comp_)) return true;
+         if(i == 0 || comp_(fences_[i - 1], val)) return false;
+      }
+   }
+   //    copy of the pos-th element, locks segments [0, the one holding pos]
+   value_type at(size_type pos) const
+   {
+      std::shared_lock<std::shared_mutex> directory(directory_);
+      segment_locks locks(this, true);
+      segment& s = locate(locks, pos);
+      return s.array[pos];
+   }
+   //    f(const value_type&) over a consistent view, writers wait
+   template<class F>
+   void for_each(F f) const
+   {
+      std::shared_lock<std::shared_mutex> directory(directory_);
+      segment_locks locks(this, true);
+      locks.lock_all();
+      for(const segment_pointer& s : segments_)
+         for(const value_type& val : s->array) f(val);
+   }
+   //    copy of the whole sequence at one point in time
+   segment_array snapshot() const
+   {
+      std::shared_lock<std::shared_mutex> directory(directory_);
+      segment_locks locks(this, true);
+      locks.lock_all();
+      segment_array out;
+      out.reserve_back(size());
+      for(const segment_pointer& s : segments_)
+         out.insert(out.end(), s->array.begin(), s->array.end());
+      return out;
+   }
+
+   //-------------------------------------------
+   //    REBALANCE
+   //    pieces of segment_size out of segments
+   //    above 2 * segment_size, neighbours that
+   //    fit in segment_size merge
+   //-------------------------------------------
+   void rebalance()
+   {
+      std::unique_lock<std::shared_mutex> directory(directory_);
+      unbalanced_.store(false, std::memory_order_relaxed);
+      sda<segment_pointer> out;
+      segment_array fences;
+      for(size_type i = 0; i < segments_.size(); i++)
+      {
+         segment_array& a = segments_[i]->array;
+         if(!out.empty() && out.back()->array.size() + a.size() <= segment_size_)
+         {
+            segment_array& b = out.back()->array;
+            b.insert(b.end(), std::make_move_iterator(a.begin()), std::make_move_iterator(a.end()));
+            continue;
+         }
+         if(!out.empty()) fences.push_back(fences_[i - 1]);
+         out.push_back(std::move(segments_[i]));
+         size_type keep = kept(a.size());
+         cut(std::make_move_iterator(a.begin() + keep), std::make_move_iterator(a.end()), out, fences);
+         while(a.size() > keep) a.pop_back();
+      }
+      segments_.swap(out);
+      fences_.swap(fences);
+      layout_++;
+   }
+};
+
+
+#endif
@@ -0,0 +1,113 @@
+#include<iostream>
+#include<chrono>
+#include<cstdint>
+#include<cstdlib>
+#include<cstring>
+#include<random>
+
+#include "sda_external.h"
+
+using namespace std;
+
+//
+//
+//	SDA EXTERNAL BENCHMARK
+//	sda_external on arrays several times larger than its cache,
+//	with background I/O and with synchronous I/O
+//
+//	  sda_external_bench [elements] [cache MB] [block KB] [directory]
+//
+
+
+struct timer
+{
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	double ms() const
+	{
+		return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+	}
+};
+
+template<class A>
+void report(const char* name, A& a, const timer& t, size_t& reads, size_t& writes)
+{
+	auto s = a.stats();
+	cout << "  " << name << "\t" << t.ms() << " ms\t" << s.reads - reads << " reads\t"
+		<< s.writes - writes << " writes" << endl;
+	reads = s.reads;
+	writes = s.writes;
+}
+
+void run(size_t n, size_t cache, size_t block, const char* directory, bool background)
+{
+	cout << (background ? "background I/O" : "synchronous I/O") << endl;
+	sda_external<uint64_t> a(cache, block, directory, background);
+	size_t reads = 0, writes = 0;
+	uint64_t sum = 0;
+	mt19937_64 rng(50);
+
+	{
+		timer t;
+		for(size_t i = 0; i < n; i++) a.push_back(i);
+		a.flush();
+		report("push_back", a, t, reads, writes);
+	}
+	{
+		timer t;
+		a.for_each([&sum](uint64_t x) { sum += x; });
+		report("for_each", a, t, reads, writes);
+	}
+	{
+		timer t;
+		a.for_each_reverse([&sum](uint64_t x) { sum += x; });
+		report("reverse", a, t, reads, writes);
+	}
+	{
+		timer t;
+		for(auto it = a.begin(); it != a.end(); ++it) sum += *it;
+		report("iterator", a, t, reads, writes);
+	}
+	{
+		timer t;
+		for(size_t i = 0; i < 10000; i++) sum += a[rng() % n];
+		report("10000 reads", a, t, reads, writes);
+	}
+	{
+		timer t;
+		for(size_t i = 0; i < 10000; i++) a.insert(rng() % a.size(), i);
+		for(size_t i = 0; i < 10000; i++) a.erase(rng() % a.size());
+		a.flush();
+		report("10000 ins+del", a, t, reads, writes);
+	}
+	{
+		timer t;
+		for(size_t i = 0; i < 1000000; i++) a.push_front(i);
+		for(size_t i = 0; i < 1000000; i++) a.pop_back();
+		a.flush();
+		report("1M push_front", a, t, reads, writes);
+	}
+	auto s = a.stats();
+	cout << "  " << a.size() << " elements, " << a.block_count() << " blocks, "
+		<< s.frames << " cached, " << s.prefetches << " read ahead (" << sum % 10 << ")" << endl;
+}
+
+int main(int argc, char** argv)
+{
+	size_t n = argc > 1 ? strtoull(argv[1], nullptr, 10) : 64 << 20;
+	size_t cache = (argc > 2 ? strtoull(argv[2], nullptr, 10) : 64) << 20;
+	size_t block = (argc > 3 ? strtoull(argv[3], nullptr, 10) : 64) << 10;
+	const char* directory = argc > 4 ? argv[4] : nullptr;
+
+	cout << n << " elements of 8 bytes, " << (n * 8 >> 20) << " MB, cache "
+		<< (cache >> 20) << " MB, blocks of " << (block >> 10) << " KB" << endl;
+	try
+	{
+		run(n, cache, block, directory, true);
+		run(n, cache, block, directory, false);
+	}
+	catch(const exception& e)
+	{
+		cerr << e.what() << endl;
+		return 1;
+	}
+}
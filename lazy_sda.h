@@ -0,0 +1,532 @@
+/*
+MIT License
+
+Copyright 2020 Than Minh Duy (macodeth)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+OR OTHER DEALINGS IN THE SOFTWARE.
+
+*/
+
+
+#ifndef SYMMETRIC_DYNAMIC_ARRAY_LAZY
+#define SYMMETRIC_DYNAMIC_ARRAY_LAZY
+
+
+
+#include<cstdint>
+#include<memory>
+#include<iterator>
+#include<initializer_list>
+#include<stdexcept>
+
+#include "sda.h"
+
+
+
+//
+//    positional edits are not applied to the array right away,
+//    they only cut a sequence of pieces kept in an implicit treap
+//
+//       piece: [offset, offset + length) of the array (untouched)
+//          or  [offset, offset + length) of the pending values
+//
+//    k edits cost O(k log k), the first read merges every piece
+//    into a new array in one pass, O(n + k)
+//
+
+
+template<class T, class Allocator = std::allocator<T>>
+class lazy_sda
+{
+   public:
+   typedef sda<T, Allocator> array_type;
+   typedef typename array_type::allocator_type allocator_type;
+   typedef typename array_type::value_type value_type;
+   typedef typename array_type::pointer pointer;
+   typedef typename array_type::const_pointer const_pointer;
+   typedef typename array_type::size_type size_type;
+   typedef typename array_type::difference_type difference_type;
+   typedef typename array_type::reference reference;
+   typedef typename array_type::const_reference const_reference;
+   typedef typename array_type::iterator iterator;
+   typedef typename array_type::const_iterator const_iterator;
+   typedef typename array_type::reverse_iterator reverse_iterator;
+   typedef typename array_type::const_reverse_iterator const_reverse_iterator;
+
+
+   private:
+   static constexpr size_type npos = ~size_type(0);
+
+   struct piece
+   {
+      size_type left;
+      size_type right;
+      size_type offset;
+      size_type length;
+      size_type total;        // elements in this subtree
+      std::uint32_t priority;
+      bool pending;           // piece of values_ instead of array_
+   };
+
+   //    the log is state of the array, not of its value,
+   //    so const reads are allowed to merge it
+   mutable array_type array_;
+   mutable array_type values_;
+   mutable sda<piece> pieces_;
+   mutable size_type root_ = npos;
+   mutable bool logging_ = false;
+   size_type size_ = 0;
+   std::uint32_t seed_ = 0x9E3779B9u;
+
+
+   //-------------------------
+   //    IMPLICIT TREAP
+   //-------------------------
+   std::uint32_t random() noexcept
+   {
+      seed_ ^= seed_ << 13;
+      seed_ ^= seed_ >> 17;
+      seed_ ^= seed_ << 5;
+      return seed_;
+   }
+   size_type total(size_type t) const noexcept
+   {
+      return t == npos ? 0 : pieces_[t].total;
+   }
+   void update(size_type t) noexcept
+   {
+      piece& p = pieces_[t];
+      p.total = total(p.left) + p.length + total(p.right);
+   }
+   size_type new_piece(bool pending, size_type offset, size_type length, std::uint32_t priority)
+   {
+      pieces_.push_back(piece{npos, npos, offset, length, length, priority, pending});
+      return pieces_.size() - 1;
+   }
+
+   //    l receives the first k elements of t, r the rest
+   void split(size_type t, size_type k, size_type& l, size_type& r)
+   {
+      if(t == npos)
+      {
+         l = r = npos;
+         return;
+      }
+      size_type left_total = total(pieces_[t].left);
+      size_type length = pieces_[t].length;
+      if(k <= left_total)
+      {
+         size_type child = pieces_[t].left;
+         split(child, k, l, child);
+         pieces_[t].left = child;
+         update(t);
+         r = t;
+      }
+      else if(k >= left_total + length)
+      {
+         size_type child = pieces_[t].right;
+         split(child, k - left_total - length, child, r);
+         pieces_[t].right = child;
+         update(t);
+         l = t;
+      }
+      else
+      {
+         //    cut the piece itself, the tail keeps the priority
+         //    of the head so the heap order still holds
+         size_type cut = k - left_total;
+         size_type tail = new_piece(pieces_[t].pending, pieces_[t].offset + cut,
+            length - cut, pieces_[t].priority);
+         pieces_[tail].right = pieces_[t].right;
+         pieces_[t].right = npos;
+         pieces_[t].length = cut;
+         update(tail);
+         update(t);
+         l = t;
+         r = tail;
+      }
+   }
+   size_type merge(size_type a, size_type b)
+   {
+      if(a == npos) return b;
+      if(b == npos) return a;
+      if(pieces_[a].priority > pieces_[b].priority)
+      {
+         size_type child = merge(pieces_[a].right, b);
+         pieces_[a].right = child;
+         update(a);
+         return a;
+      }
+      size_type child = merge(a, pieces_[b].left);
+      pieces_[b].left = child;
+      update(b);
+      return b;
+   }
+
+   //    start logging, the whole array is the first piece
+   void open_log()
+   {
+      if(logging_) return;
+      logging_ = true;
+      root_ = array_.empty() ? npos : new_piece(false, 0, array_.size(), random());
+   }
+   //    values_[first, values_.size()) become a piece at pos
+   void log_insert(size_type pos, size_type first)
+   {
+      size_type n = values_.size() - first;
+      if(!n) return;
+      open_log();
+      size_type l, r;
+      split(root_, pos, l, r);
+      root_ = merge(merge(l, new_piece(true, first, n, random())), r);
+      size_ += n;
+   }
+
+   void throw_out_of_range() const
+   {
+      throw std::out_of_range("std::out_of_range");
+   }
+
+
+   /*
+   ================================================================
+   ================================================================
+
+
+                        PUBLIC FUNCTION
+
+
+   ================================================================
+   ================================================================
+   */
+
+
+   public:
+   //--------------------
+   //    CONSTRUCTOR
+   //--------------------
+   lazy_sda() = default;
+
+   explicit lazy_sda(array_type&& array) noexcept : array_(std::move(array)), size_(array_.size()) {}
+
+   lazy_sda(std::initializer_list<value_type> il) : array_(il), size_(array_.size()) {}
+
+   lazy_sda(lazy_sda&& other) noexcept
+   : array_(std::move(other.array_)), values_(std::move(other.values_)),
+     pieces_(std::move(other.pieces_)), root_(other.root_), logging_(other.logging_), size_(other.size_)
+   {
+      other.root_ = npos;
+      other.logging_ = false;
+      other.size_ = 0;
+   }
+
+   lazy_sda& operator= (lazy_sda&& other) noexcept
+   {
+      swap(other);
+      return *this;
+   }
+
+   //-------------------------------------------------------
+   //    MERGE
+   //    apply every pending edit, moves each surviving
+   //    element once into a new array of the final size
+   //-------------------------------------------------------
+   void flush() const
+   {
+      if(!logging_) return;
+
+      array_type merged;
+      merged.reserve_back(size_);
+      sda<size_type> stack;
+      size_type t = root_;
+      while(t != npos || !stack.empty())
+      {
+         for(; t != npos; t = pieces_[t].left) stack.push_back(t);
+         t = stack.back();
+         stack.pop_back();
+         const piece& p = pieces_[t];
+         pointer source = p.pending ? values_.data() : array_.data();
+         for(size_type i = p.offset; i != p.offset + p.length; i++)
+            merged.push_back(std::move(source[i]));
+         t = p.right;
+      }
+
+      array_ = std::move(merged);
+      values_.clear();
+      pieces_.clear();
+      root_ = npos;
+      logging_ = false;
+   }
+   //    pieces in the log, 0 when nothing is pending
+   size_type pending() const noexcept
+   {
+      return logging_ ? pieces_.size() : 0;
+   }
+   //    the underlying array, merged
+   array_type& array()
+   {
+      flush();
+      return array_;
+   }
+   //    take the merged array out, leave this empty
+   array_type release()
+   {
+      flush();
+      size_ = 0;
+      return std::move(array_);
+   }
+
+   //------------------
+   //    ITERATORS
+   //------------------
+   iterator begin()
+   {
+      flush();
+      return array_.begin();
+   }
+   const_iterator begin() const
+   {
+      flush();
+      return array_.begin();
+   }
+   iterator end()
+   {
+      flush();
+      return array_.end();
+   }
+   const_iterator end() const
+   {
+      flush();
+      return array_.end();
+   }
+   reverse_iterator rbegin()
+   {
+      flush();
+      return array_.rbegin();
+   }
+   const_reverse_iterator rbegin() const
+   {
+      flush();
+      return array_.rbegin();
+   }
+   reverse_iterator rend()
+   {
+      flush();
+      return array_.rend();
+   }
+   const_reverse_iterator rend() const
+   {
+      flush();
+      return array_.rend();
+   }
+
+   //------------------------
+   //    CAPACITY
+   //------------------------
+   size_type size() const noexcept
+   {
+      return size_;
+   }
+   bool empty() const noexcept
+   {
+      return size_ == 0;
+   }
+
+   //-----------------------
+   //    ELEMENT ACCESS
+   //-----------------------
+   reference operator[] (size_type n)
+   {
+      flush();
+      return array_[n];
+   }
+   const_reference operator[] (size_type n) const
+   {
+      flush();
+      return array_[n];
+   }
+   reference at(size_type n)
+   {
+      if(n >= size_) throw_out_of_range();
+      return (*this)[n];
+   }
+   const_reference at(size_type n) const
+   {
+      if(n >= size_) throw_out_of_range();
+      return (*this)[n];
+   }
+   reference front()
+   {
+      return (*this)[0];
+   }
+   const_reference front() const
+   {
+      return (*this)[0];
+   }
+   reference back()
+   {
+      return (*this)[size_ - 1];
+   }
+   const_reference back() const
+   {
+      return (*this)[size_ - 1];
+   }
+   pointer data()
+   {
+      flush();
+      return array_.data();
+   }
+   const_pointer data() const
+   {
+      flush();
+      return array_.data();
+   }
+   //    read through the log without merging it, O(log k)
+   const_reference peek(size_type n) const
+   {
+      if(!logging_) return array_[n];
+      size_type t = root_;
+      for(;;)
+      {
+         const piece& p = pieces_[t];
+         size_type left_total = total(p.left);
+         if(n < left_total) t = p.left;
+         else if(n < left_total + p.length)
+            return p.pending ? values_[p.offset + n - left_total] : array_[p.offset + n - left_total];
+         else
+         {
+            n -= left_total + p.length;
+            t = p.right;
+         }
+      }
+   }
+
+   //----------------
+   //    INSERT
+   //----------------
+   void clear() noexcept
+   {
+      array_.clear();
+      values_.clear();
+      pieces_.clear();
+      root_ = npos;
+      logging_ = false;
+      size_ = 0;
+   }
+   void insert(size_type pos, const value_type& val)
+   {
+      emplace(pos, val);
+   }
+   void insert(size_type pos, value_type&& val)
+   {
+      emplace(pos, std::move(val));
+   }
+   void insert(size_type pos, size_type n, const value_type& val)
+   {
+      size_type first = values_.size();
+      values_.resize_back(first + n, val);
+      log_insert(pos, first);
+   }
+   template<class InputIterator, typename = typename array_type::template RequireInputIterator<InputIterator>>
+   void insert(size_type pos, InputIterator first, InputIterator last)
+   {
+      size_type offset = values_.size();
+      for(; first != last; ++first) values_.push_back(*first);
+      log_insert(pos, offset);
+   }
+   void insert(size_type pos, std::initializer_list<value_type> il)
+   {
+      insert(pos, il.begin(), il.end());
+   }
+   template<class... Args>
+   void emplace(size_type pos, Args&&... args)
+   {
+      size_type first = values_.size();
+      values_.emplace_back(std::forward<Args>(args)...);
+      log_insert(pos, first);
+   }
+
+   //--------------
+   //    ERASE
+   //--------------
+   void erase(size_type pos)
+   {
+      erase(pos, pos + 1);
+   }
+   void erase(size_type first, size_type last)
+   {
+      if(first == last) return;
+      open_log();
+      size_type l, m, r;
+      split(root_, last, m, r);
+      split(m, first, l, m);
+      root_ = merge(l, r);
+      size_ -= last - first;
+   }
+
+   //------------------------------------------------
+   //    PUSH, POP
+   //    go straight to the array while nothing is
+   //    pending, they never shift any element
+   //------------------------------------------------
+   void push_back(const value_type& val)
+   {
+      if(!logging_) { array_.push_back(val); size_++; }
+      else insert(size_, val);
+   }
+   void push_back(value_type&& val)
+   {
+      if(!logging_) { array_.push_back(std::move(val)); size_++; }
+      else insert(size_, std::move(val));
+   }
+   void push_front(const value_type& val)
+   {
+      if(!logging_) { array_.push_front(val); size_++; }
+      else insert(0, val);
+   }
+   void push_front(value_type&& val)
+   {
+      if(!logging_) { array_.push_front(std::move(val)); size_++; }
+      else insert(0, std::move(val));
+   }
+   void pop_back()
+   {
+      if(!logging_) { array_.pop_back(); size_--; }
+      else erase(size_ - 1);
+   }
+   void pop_front()
+   {
+      if(!logging_) { array_.pop_front(); size_--; }
+      else erase(0);
+   }
+
+   void swap(lazy_sda& other) noexcept
+   {
+      array_.swap(other.array_);
+      values_.swap(other.values_);
+      pieces_.swap(other.pieces_);
+      std::swap(root_, other.root_);
+      std::swap(logging_, other.logging_);
+      std::swap(size_, other.size_);
+      std::swap(seed_, other.seed_);
+   }
+};
+
+
+#endif
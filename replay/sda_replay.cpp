@@ -0,0 +1,219 @@
+#include<iostream>
+#include<fstream>
+#include<iterator>
+#include<vector>
+#include<deque>
+#include<chrono>
+#include<cstdint>
+#include<cstdlib>
+#include<cstring>
+#include<string>
+
+#include "sda_journal.h"
+
+using namespace std;
+
+//
+//
+//	SDA REPLAY
+//	replay a journal (sda_journal.h) against sda, vector and deque,
+//	report time, allocations and peak memory of each
+//
+//	  sda_replay trace.bin [repeat]
+//	  sda_replay -g trace.bin [ops]     write a random trace
+//
+
+
+// allocations and live bytes of the current run
+struct counters
+{
+	size_t allocations = 0;
+	size_t bytes = 0;
+	size_t peak = 0;
+} stats;
+
+template<class T>
+struct counting_allocator
+{
+	typedef T value_type;
+
+	counting_allocator() = default;
+	template<class U>
+	counting_allocator(const counting_allocator<U>&) noexcept {}
+
+	T* allocate(size_t n)
+	{
+		stats.allocations++;
+		stats.bytes += n * sizeof(T);
+		if(stats.bytes > stats.peak) stats.peak = stats.bytes;
+		return allocator<T>().allocate(n);
+	}
+	void deallocate(T* p, size_t n) noexcept
+	{
+		stats.bytes -= n * sizeof(T);
+		allocator<T>().deallocate(p, n);
+	}
+	template<class U>
+	bool operator==(const counting_allocator<U>&) const noexcept { return true; }
+	template<class U>
+	bool operator!=(const counting_allocator<U>&) const noexcept { return false; }
+};
+
+// element of an unusual size
+template<size_t N>
+struct raw
+{
+	unsigned char bytes[N];
+};
+
+
+// vector and deque have no front capacity and no slide,
+// front ops become inserts at begin(), slides do nothing
+template<class C>
+void apply(C& c, const sda_journal_reader& in, const sda_journal_reader::record& r)
+{
+	typedef typename C::value_type T;
+	in.check(r, c.size());
+	switch(r.op)
+	{
+		case sda_op::push_back: c.push_back(in.value<T>(r, 0)); break;
+		case sda_op::push_front: c.insert(c.begin(), in.value<T>(r, 0)); break;
+		case sda_op::pop_back: c.pop_back(); break;
+		case sda_op::pop_front: c.erase(c.begin()); break;
+		case sda_op::insert:
+		case sda_op::join:
+		{
+			vector<T> v;
+			for(size_t i = 0; i < r.count; i++) v.push_back(in.value<T>(r, i));
+			if(r.count) c.insert(c.begin() + r.pos, v.begin(), v.end());
+			break;
+		}
+		case sda_op::erase: c.erase(c.begin() + r.pos, c.begin() + r.pos + r.count); break;
+		case sda_op::reserve:
+		case sda_op::reserve_front:
+		case sda_op::reserve_back:
+			if constexpr (is_same<C, vector<T, counting_allocator<T>>>::value)
+				c.reserve(r.pos);
+			break;
+		case sda_op::slide_to_front:
+		case sda_op::slide_to_back:
+			break;
+		case sda_op::resize_front:
+			if(r.pos < c.size()) c.erase(c.begin(), c.end() - r.pos);
+			else if(r.pos > c.size()) c.insert(c.begin(), r.pos - c.size(), T());
+			for(size_t i = 0; i < r.count; i++) c[i] = in.value<T>(r, i);
+			break;
+		case sda_op::resize_back:
+			c.resize(r.pos);
+			for(size_t i = 0; i < r.count; i++) c[r.pos - r.count + i] = in.value<T>(r, i);
+			break;
+		case sda_op::shrink_to_fit: c.shrink_to_fit(); break;
+		case sda_op::clear: c.clear(); break;
+		case sda_op::set: c[r.pos] = in.value<T>(r, 0); break;
+	}
+}
+template<class T, class A, class P>
+void apply(sda<T, A, P>& c, const sda_journal_reader& in, const sda_journal_reader::record& r)
+{
+	in.apply(c, r);
+}
+
+template<class C>
+void run(const char* name, const vector<unsigned char>& trace, int repeat)
+{
+	double best = 0;
+	size_t size = 0;
+	for(int k = 0; k < repeat; k++)
+	{
+		stats = counters();
+		sda_journal_reader in(trace.data(), trace.size());
+		sda_journal_reader::record r;
+		auto start = chrono::steady_clock::now();
+		{
+			C c;
+			while(in.next(r)) apply(c, in, r);
+			size = c.size();
+		}
+		double t = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+		if(k == 0 || t < best) best = t;
+	}
+	cout << name << "\t" << best << " ms\t" << stats.allocations << " allocations\t"
+		<< stats.peak / 1024 << " KB peak\t" << size << " elements" << endl;
+}
+
+template<class T>
+void run_all(const vector<unsigned char>& trace, int repeat)
+{
+	run<sda<T, counting_allocator<T>>>("sda", trace, repeat);
+	run<vector<T, counting_allocator<T>>>("vector", trace, repeat);
+	run<deque<T, counting_allocator<T>>>("deque", trace, repeat);
+}
+
+// a mixed workload: pushes and pops at both ends,
+// inserts and erases mostly near the ends
+void generate(const char* file, size_t ops)
+{
+	journaled_sda<int> a;
+	for(size_t i = 0; i < ops; i++)
+	{
+		size_t n = a.size();
+		int value = rand();
+		switch(rand() % 8)
+		{
+			case 0: case 1: a.push_back(value); break;
+			case 2: a.push_front(value); break;
+			case 3: if(n) a.pop_front(); break;
+			case 4: a.insert(a.begin() + (n ? rand() % (n / 8 + 1) : 0), value); break;
+			case 5: a.insert(a.end() - (n ? rand() % (n / 8 + 1) : 0), value); break;
+			case 6: if(n > 4) { size_t k = rand() % (n - 4); a.erase(a.begin() + k, a.begin() + k + 1 + rand() % 4); } break;
+			case 7: if(n) a.set(rand() % n, value); break;
+		}
+	}
+	ofstream out(file, ios::binary);
+	out.write(reinterpret_cast<const char*>(a.journal().data()), a.journal().size());
+	cout << file << ": " << a.journal().records() << " records, "
+		<< a.journal().size() << " bytes" << endl;
+}
+
+int main(int argc, char** argv)
+{
+	if(argc >= 3 && strcmp(argv[1], "-g") == 0)
+	{
+		generate(argv[2], argc > 3 ? strtoul(argv[3], nullptr, 10) : 100000);
+		return 0;
+	}
+	if(argc < 2)
+	{
+		cerr << "usage: sda_replay trace.bin [repeat]" << endl
+			<< "       sda_replay -g trace.bin [ops]" << endl;
+		return 1;
+	}
+	ifstream file(argv[1], ios::binary);
+	vector<unsigned char> trace((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+	int repeat = argc > 2 ? atoi(argv[2]) : 1;
+	if(repeat < 1) repeat = 1;
+
+	try
+	{
+		sda_journal_reader in(trace.data(), trace.size());
+		cout << argv[1] << ": " << trace.size() << " bytes, value size " << in.value_size() << endl;
+		switch(in.value_size())
+		{
+			case 0: case 4: run_all<uint32_t>(trace, repeat); break;
+			case 1: run_all<uint8_t>(trace, repeat); break;
+			case 2: run_all<uint16_t>(trace, repeat); break;
+			case 8: run_all<uint64_t>(trace, repeat); break;
+			case 16: run_all<raw<16>>(trace, repeat); break;
+			case 32: run_all<raw<32>>(trace, repeat); break;
+			case 64: run_all<raw<64>>(trace, repeat); break;
+			default:
+				cerr << "value size " << in.value_size() << " not supported" << endl;
+				return 1;
+		}
+	}
+	catch(const exception& e)
+	{
+		cerr << e.what() << endl;
+		return 1;
+	}
+}
@@ -37,6 +37,30 @@ OR OTHER DEALINGS IN THE SOFTWARE.
 #include<exception>
 #include<type_traits>
 #include<limits>
+#include<cstdint>
+#include<numeric>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include<sys/mman.h>
+#include<unistd.h>
+#define SDA_PAGE_RELEASE
+#endif
+
+//    C++20 : sda can be used in constant evaluation
+#if defined(__cpp_constexpr_dynamic_alloc) && __cpp_constexpr_dynamic_alloc >= 201907L \
+   && defined(__cpp_lib_constexpr_dynamic_alloc)
+#define SDA_CONSTEXPR constexpr
+#define SDA_HAS_CONSTEXPR
+#else
+#define SDA_CONSTEXPR
+#endif
+
+//    software prefetch, no-op where the builtin is missing
+#if defined(__GNUC__) || defined(__clang__)
+#define SDA_PREFETCH(p, rw) __builtin_prefetch(static_cast<const void*>(p), rw)
+#else
+#define SDA_PREFETCH(p, rw) ((void)(p))
+#endif
 
 
 
@@ -50,7 +74,65 @@ OR OTHER DEALINGS IN THE SOFTWARE.
 //
 
 
-template<class T, class Allocator = std::allocator<T>>
+//
+//    POLICY
+//    compile-time knobs of sda, derive from sda_policy
+//    and override only what you need:
+//
+//       struct my_policy : sda_policy
+//       {
+//          static constexpr std::size_t shrink_high = 8;
+//       };
+//       sda<int, std::allocator<int>, my_policy> a;
+//
+struct sda_policy
+{
+   //    AUTO SHRINK (off when shrink_high == 0)
+   //    after erase, pop, resize a side whose empty capacity exceeds
+   //    shrink_high * size() + shrink_min is cut back to
+   //    shrink_low * size() + shrink_min
+   static constexpr std::size_t shrink_high = 0;
+   static constexpr std::size_t shrink_low = 1;
+   static constexpr std::size_t shrink_min = 64;
+   //    memory blocks of at least release_bytes give the pages of
+   //    their empty capacity back in place (madvise), until the whole
+   //    empty capacity exceeds shrink_realloc * size() + shrink_min
+   static constexpr std::size_t release_bytes = std::size_t(1) << 21;
+   static constexpr std::size_t shrink_realloc = 16;
+   //    ALIGNMENT (natural alignment of T when 0)
+   //    begin_ is placed on an alignment-byte boundary by
+   //    grow, reserve, slide and assign whenever slack allows,
+   //    each block gets up to alignment / gcd(sizeof(T), alignment) - 1
+   //    elements of extra capacity, the allocator's blocks must be
+   //    aligned to gcd(sizeof(T), alignment)
+   static constexpr std::size_t alignment = 0;
+   //    PREFETCH (off when 0)
+   //    shifts of non-trivially copyable elements longer than
+   //    prefetch elements prefetch that far ahead
+   static constexpr std::size_t prefetch = 0;
+   //    COST MODEL (side chosen by insert, emplace)
+   //    shifting costs one per element, a side without enough
+   //    empty capacity adds a reallocation: realloc_percent
+   //    percent of size() (doubled for types whose move or
+   //    destructor is not trivial) plus realloc_fixed
+   static constexpr std::size_t realloc_percent = 25;
+   static constexpr std::size_t realloc_fixed = 64;
+};
+
+//    sda_policy with auto shrink turned on
+struct sda_shrink_policy : sda_policy
+{
+   static constexpr std::size_t shrink_high = 4;
+};
+
+//    sda_policy with data() on a cache line boundary
+struct sda_aligned_policy : sda_policy
+{
+   static constexpr std::size_t alignment = 64;
+};
+
+
+template<class T, class Allocator = std::allocator<T>, class Policy = sda_policy>
 class sda
 {
    public:
@@ -74,7 +156,58 @@ class sda
       std::iterator_traits<InputIterator>::iterator_category,
       std::input_iterator_tag>::value>::type;
 
+   template<typename ForwardIterator>
+   using RequireForwardIterator = typename
+      std::enable_if< std::is_convertible < typename
+      std::iterator_traits<ForwardIterator>::iterator_category,
+      std::forward_iterator_tag>::value>::type;
+
+   //    false for single pass (input) iterators
+   template<typename InputIterator>
+   static constexpr bool is_multi_pass = std::is_base_of<std::forward_iterator_tag, typename
+      std::iterator_traits<InputIterator>::iterator_category>::value;
+
+   //    allocator with its own construct / destroy members
+   //    (std::allocator has them up to C++17, they do nothing more)
+   template<class A, class = void>
+   struct has_construct : std::false_type {};
+   template<class A>
+   struct has_construct<A, std::void_t<decltype(std::declval<A&>().construct(
+      std::declval<value_type*>(), std::declval<const value_type&>()))>>
+   : std::negation<std::is_same<A, std::allocator<value_type>>> {};
+   template<class A, class = void>
+   struct has_destroy : std::false_type {};
+   template<class A>
+   struct has_destroy<A, std::void_t<decltype(std::declval<A&>().destroy(std::declval<value_type*>()))>>
+   : std::negation<std::is_same<A, std::allocator<value_type>>> {};
+
    static constexpr bool trivial_copy = std::is_trivially_copyable<value_type>::value;
+   //    destructor calls that do nothing are skipped, unless the
+   //    allocator wants to see them
+   static constexpr bool trivial_destroy = std::is_trivially_destructible<value_type>::value
+      && !has_destroy<Allocator>::value;
+   //    fills may write bytes instead of constructing
+   static constexpr bool byte_fill = trivial_copy && !has_construct<Allocator>::value;
+
+   //    elements per 64-byte cache line, for Policy::prefetch
+   static constexpr std::size_t prefetch_step = sizeof(value_type) < 64 ? 64 / sizeof(value_type) : 1;
+
+   //    writable view of empty capacity
+   struct span
+   {
+      pointer first;
+      size_type count;
+
+      constexpr pointer data() const noexcept { return first; }
+      constexpr size_type size() const noexcept { return count; }
+      constexpr pointer begin() const noexcept { return first; }
+      constexpr pointer end() const noexcept { return first + count; }
+   };
+
+   static_assert(Policy::shrink_low <= Policy::shrink_high || Policy::shrink_high == 0,
+      "shrink_low must not exceed shrink_high");
+   static_assert((Policy::alignment & (Policy::alignment - 1)) == 0,
+      "alignment must be 0 or a power of two");
 
 
    private:
@@ -85,53 +218,93 @@ class sda
       pointer begin_;
       pointer end_;
 
-      Impl() : Allocator(), head_(nullptr), tail_(nullptr), begin_(nullptr), end_(nullptr) {}
+      SDA_CONSTEXPR Impl() : Allocator(), head_(nullptr), tail_(nullptr), begin_(nullptr), end_(nullptr) {}
 
-      Impl(const allocator_type& alloc) : Allocator(alloc), head_(nullptr), tail_(nullptr), begin_(nullptr), end_(nullptr) {}
+      SDA_CONSTEXPR Impl(const allocator_type& alloc) : Allocator(alloc), head_(nullptr), tail_(nullptr), begin_(nullptr), end_(nullptr) {}
 
-      Impl(allocator_type&& alloc) : Allocator(std::move(alloc)), head_(nullptr), tail_(nullptr), begin_(nullptr), end_(nullptr) {}
+      SDA_CONSTEXPR Impl(allocator_type&& alloc) : Allocator(std::move(alloc)), head_(nullptr), tail_(nullptr), begin_(nullptr), end_(nullptr) {}
 
-      Impl(Impl&& other) : Allocator(std::move(other)), head_(other.head_), tail_(other.tail_), begin_(other.begin_), end_(other.end_)
+      SDA_CONSTEXPR Impl(Impl&& other) : Allocator(std::move(other)), head_(other.head_), tail_(other.tail_), begin_(other.begin_), end_(other.end_)
       {
          other.head_ = other.tail_ = other.begin_ = other.end_ = nullptr;
       }
 
-      Impl(size_type n, const allocator_type& alloc = allocator_type()) : Allocator(alloc)
+      SDA_CONSTEXPR ~Impl()
       {
-         head_ = alloc_trait::allocate(*this, n);
-         tail_ = head_ + n;
-         begin_ = head_;
-         end_ = tail_;
+         if(head_) deallocate();
+      }
+
+      SDA_CONSTEXPR Impl(size_type n, const allocator_type& alloc = allocator_type())
+      : Allocator(alloc), head_(nullptr), tail_(nullptr), begin_(nullptr), end_(nullptr)
+      {
+         relocate(n, 0);
+         end_ = begin_ + n;
       }
       //   completely destroy, deallocate allocated memory
-      void deallocate()
+      SDA_CONSTEXPR void deallocate()
       {
          destroy(begin_, end_);
-         alloc_trait::deallocate(*this, head_, tail_ - head_);
+         if(head_) alloc_trait::deallocate(*this, head_, tail_ - head_);
          head_ = tail_ = begin_ = end_ = nullptr;
       }
       //    destroy part of allocated memory
-      void destroy(pointer start, pointer finish)
+      SDA_CONSTEXPR void destroy(pointer start, pointer finish)
       {
-         for(; start != finish; start++) alloc_trait::destroy(*this, start);
+         destroy_range(*this, start, finish);
       }
 
       //---------------------------
       //    GROWTH FORMULA
       //---------------------------
-      size_type new_capacity_front_growing()
+      SDA_CONSTEXPR size_type new_capacity_front_growing()
       {
          size_type front_capacity = end_ - head_;
          return tail_ - end_ + front_capacity + (front_capacity >> 2) + 2;
       }
-      size_type new_capacity_back_growing()
+      SDA_CONSTEXPR size_type new_capacity_back_growing()
       {
          size_type back_capacity = tail_ - begin_;
          return begin_ - head_ + back_capacity + (back_capacity >> 2) + 2;
       }
-      pointer balance_begin(pointer head, size_type size, size_type capacity)
+      SDA_CONSTEXPR pointer balance_begin(pointer head, size_type size, size_type capacity)
       {
-         return head + ((capacity - size) >> 1);
+         return align(head + ((capacity - size) >> 1), head, head + (capacity - size));
+      }
+
+      //---------------------------
+      //    ALIGNMENT
+      //---------------------------
+      //    elements from one boundary to the next, extra elements
+      //    a new block needs to align begin_
+      static constexpr size_type align_period = Policy::alignment > alignof(value_type) ?
+         Policy::alignment / std::gcd(sizeof(value_type), Policy::alignment) : 1;
+      static constexpr size_type align_pad = align_period - 1;
+
+      //    nearest pointer to p in [first, last] on an alignment
+      //    boundary, p itself when there is none (also when the
+      //    block is less aligned than sizeof(value_type) needs)
+      SDA_CONSTEXPR pointer align(pointer p, pointer first, pointer last) const noexcept
+      {
+         if constexpr (align_pad != 0)
+         {
+            if(constant_evaluated()) return p;
+            std::size_t over = reinterpret_cast<std::uintptr_t>(to_address(p)) % Policy::alignment;
+            if(over % (Policy::alignment / align_period) != 0) return p;
+            size_type up = 0;
+            while((over + up * sizeof(value_type)) % Policy::alignment != 0) up++;
+            size_type down = up ? align_period - up : 0;
+            bool fits_up = size_type(last - p) >= up;
+            if(size_type(p - first) >= down && (down <= up || !fits_up))
+               return p - down;
+            if(fits_up)
+               return p + up;
+         }
+         else
+         {
+            (void)first;
+            (void)last;
+         }
+         return p;
       }
 
       //-----------------------------------------------------------------
@@ -140,58 +313,37 @@ class sda
       //    grow_front : change front capacity only
       //    grow_back  : change back capacity only
       //-----------------------------------------------------------------
-      pointer grow(size_type capacity)
+      SDA_CONSTEXPR pointer grow(size_type capacity)
       {
-         size_type size = end_ - begin_;
-
-         pointer new_head = alloc_trait::allocate(*this, capacity);
-         if(new_head)
-         {
-            pointer new_begin = balance_begin(new_head, size, capacity);
-            uninitialized_move(begin_, end_, new_begin);
-            deallocate();
-            head_ = new_head;
-            tail_ = head_ + capacity;
-            begin_ = new_begin;
-            end_ = begin_ + size;
-         }
-         return new_head;
+         return relocate(capacity, (capacity - (end_ - begin_)) >> 1);
       }
-      pointer grow_front(size_type new_front_capacity = 0)
+      SDA_CONSTEXPR pointer grow_front(size_type new_front_capacity = 0)
       {
          size_type capacity = new_front_capacity ? 
             tail_ - end_ + new_front_capacity : new_capacity_front_growing();
-         size_type size = end_ - begin_;
-         
-         pointer new_head = alloc_trait::allocate(*this, capacity);
-         if(new_head)
-         {
-            pointer new_tail = new_head + capacity;
-            pointer new_end = new_tail - (tail_ - end_);
-            pointer new_begin = new_end - size;
-            uninitialized_move(begin_, end_, new_begin);
-            deallocate();
-            head_ = new_head;
-            tail_ = new_tail;
-            end_ = new_end;
-            begin_ = new_begin;
-         }
-         return new_head;
+         return relocate(capacity, capacity - (tail_ - begin_));
       }
-      pointer grow_back(size_type new_back_capacity = 0)
+      SDA_CONSTEXPR pointer grow_back(size_type new_back_capacity = 0)
       {
          size_type capacity = new_back_capacity ? 
             begin_ - head_ + new_back_capacity : new_capacity_back_growing();
+         return relocate(capacity, begin_ - head_);
+      }
+      //    move data to a new memory block,
+      //    empty front capacity becomes front
+      //    (plus up to align_pad elements to align begin_)
+      SDA_CONSTEXPR pointer relocate(size_type capacity, size_type front)
+      {
          size_type size = end_ - begin_;
 
-         pointer new_head = alloc_trait::allocate(*this, capacity);
+         pointer new_head = alloc_trait::allocate(*this, capacity + align_pad);
          if(new_head)
          {
-            pointer new_begin = new_head + (begin_ - head_);
+            pointer new_begin = align(new_head + front, new_head + front, new_head + front + align_pad);
             uninitialized_move(begin_, end_, new_begin);
             deallocate();
             head_ = new_head;
-            tail_ = head_ + capacity;
+            tail_ = head_ + capacity + align_pad;
             begin_ = new_begin;
             end_ = begin_ + size;
          }
@@ -199,7 +351,7 @@ class sda
       }
    } impl_;
    
-   static void swap(Impl& a, Impl& b)
+   static SDA_CONSTEXPR void swap(Impl& a, Impl& b)
    {
       std::swap(a.head_, b.head_);
       std::swap(a.tail_, b.tail_);
@@ -210,27 +362,36 @@ class sda
    //--------------------
    //    MOVE ASSIGN
    //--------------------
-   void moveAssign(sda& other)
+   SDA_CONSTEXPR void moveAssign(sda& other)
    {
-      if constexpr (std::integral_constant<bool, 
-          alloc_trait::propagate_on_container_move_assignment::value>() 
-          or (impl_ == other.impl_))
+      if(this == &other) return;
+      if constexpr (alloc_trait::propagate_on_container_move_assignment::value)
+      {
+         impl_.deallocate();
+         static_cast<Allocator&>(impl_) = std::move(static_cast<Allocator&>(other.impl_));
+         swap(impl_, other.impl_);
+      }
+      else if(same_allocator(other))
       {
          impl_.deallocate();
          swap(impl_, other.impl_);
       }
       else
-         assign(other.begin(), other.end());
+      {
+         //    blocks of other cannot be taken over: move the elements
+         assign(std::make_move_iterator(other.begin()), std::make_move_iterator(other.end()));
+         other.clear();
+      }
    }
    
    //-------------------
    //    EXCEPTION
    //-------------------
-   void throw_length_error()
+   [[noreturn]] void throw_length_error()
    {
       throw std::length_error("std::length_error");
    }
-   void throw_out_of_range()
+   [[noreturn]] void throw_out_of_range()
    {
       throw std::out_of_range("std::out_of_range");
    }
@@ -241,34 +402,156 @@ class sda
    //----------------------------------------------
    
    //    separate, no overlapped - 3 functions
+   //    (the two moves inside constructed data may overlap
+   //    when called from move_generic, hence memmove)
    //    data in moved region is already constructed
    //    or hasn't called destructor (can be dereferenced)
-   static void move_separate(pointer first, pointer last, pointer d_first)
+   //    memcpy is not allowed in constant evaluation,
+   //    element-wise paths are taken there instead
+   static constexpr bool constant_evaluated() noexcept
+   {
+#ifdef SDA_HAS_CONSTEXPR
+      return std::is_constant_evaluated();
+#else
+      return false;
+#endif
+   }
+   //    raw address behind a pointer, for allocators whose
+   //    pointer is a class (offset pointers in shared memory)
+   template<class P>
+   static constexpr P* to_address(P* p) noexcept
+   {
+      return p;
+   }
+   template<class P>
+   static constexpr auto to_address(const P& p) noexcept
+   {
+      return to_address(p.operator->());
+   }
+   template<class... Args>
+   static SDA_CONSTEXPR void construct(pointer p, Args&&... args)
+   {
+#ifdef SDA_HAS_CONSTEXPR
+      std::construct_at(to_address(p), std::forward<Args>(args)...);
+#else
+      ::new(static_cast<void*>(to_address(p))) value_type(std::forward<Args>(args)...);
+#endif
+   }
+
+   //----------------------------------------------
+   //    KERNELS
+   //----------------------------------------------
+
+   //    empty ranges may come with null pointers, which memcpy and
+   //    memmove do not accept; short ranges are left to the library,
+   //    it already copies them through overlapping vector registers
+   static void move_bytes(void* d, const void* s, std::size_t n) noexcept
    {
-      if constexpr (trivial_copy)
-         memcpy(d_first, first, sizeof(value_type) * (last - first));
+      if(n) memmove(d, s, n);
+   }
+   static void copy_bytes(void* d, const void* s, std::size_t n) noexcept
+   {
+      if(n) memcpy(d, s, n);
+   }
+   //    n copies of val: memset when every byte of val is the same,
+   //    otherwise a 64-byte pattern stored block by block
+   static void fill_bytes(value_type* p, std::size_t n, const value_type& val) noexcept
+   {
+      unsigned char v[sizeof(value_type)];
+      memcpy(v, std::addressof(val), sizeof(value_type));
+      if(std::all_of(v + 1, v + sizeof(value_type), [&v](unsigned char b) { return b == v[0]; }))
+      {
+         if(n) memset(p, v[0], n * sizeof(value_type));
+         return;
+      }
+      constexpr std::size_t block = sizeof(value_type) < 64 ? 64 / sizeof(value_type) : 1;
+      std::size_t i = 0;
+      if(n >= 2 * block)
+      {
+         unsigned char pattern[block * sizeof(value_type)];
+         for(std::size_t k = 0; k < block; k++) memcpy(pattern + k * sizeof(value_type), v, sizeof(value_type));
+         for(; i + block <= n; i += block) memcpy(p + i, pattern, sizeof(pattern));
+      }
+      std::uninitialized_fill(p + i, p + n, val);
+   }
+   static SDA_CONSTEXPR void destroy_range(allocator_type& alloc, pointer first, pointer last)
+   {
+      if constexpr (!trivial_destroy)
+         for(; first != last; ++first) alloc_trait::destroy(alloc, to_address(first));
+      else
+      {
+         (void)alloc;
+         (void)first;
+         (void)last;
+      }
+   }
+
+   static SDA_CONSTEXPR void move_separate(pointer first, pointer last, pointer d_first)
+   {
+      if(constant_evaluated())
+         std::move(first, last, d_first);
+      else if constexpr (trivial_copy)
+         move_bytes(to_address(d_first), to_address(first), sizeof(value_type) * (last - first));
+      else if constexpr (Policy::prefetch != 0)
+      {
+         //    one prefetch of source and destination per cache line
+         size_type n = last - first;
+         size_type ahead = n > Policy::prefetch ? n - Policy::prefetch : 0;
+         for(size_type i = 0; i < ahead; i++)
+         {
+            if(i % prefetch_step == 0)
+            {
+               SDA_PREFETCH(first + i + Policy::prefetch, 0);
+               SDA_PREFETCH(d_first + i + Policy::prefetch, 1);
+            }
+            d_first[i] = std::move(first[i]);
+         }
+         std::move(first + ahead, last, d_first + ahead);
+      }
       else std::move(first, last, d_first);
    }
-   static void move_backward_separate(pointer first, pointer last, pointer d_last)
+   static SDA_CONSTEXPR void move_backward_separate(pointer first, pointer last, pointer d_last)
    {
-      if constexpr (trivial_copy)
-         memcpy(d_last - (last - first), first, sizeof(value_type) * (last - first));
+      if(constant_evaluated())
+         std::move_backward(first, last, d_last);
+      else if constexpr (trivial_copy)
+         move_bytes(to_address(d_last - (last - first)), to_address(first), sizeof(value_type) * (last - first));
+      else if constexpr (Policy::prefetch != 0)
+      {
+         size_type n = last - first;
+         size_type ahead = n > Policy::prefetch ? n - Policy::prefetch : 0;
+         for(size_type i = 1; i <= ahead; i++)
+         {
+            if((i - 1) % prefetch_step == 0)
+            {
+               SDA_PREFETCH(last - i - Policy::prefetch, 0);
+               SDA_PREFETCH(d_last - i - Policy::prefetch, 1);
+            }
+            d_last[-difference_type(i)] = std::move(last[-difference_type(i)]);
+         }
+         std::move_backward(first, last - ahead, d_last - ahead);
+      }
       else std::move_backward(first, last, d_last);
    }
    //    move to uninitialized region of data
-   static void uninitialized_move(pointer first, pointer last, pointer d_first)
+   static SDA_CONSTEXPR void uninitialized_move(pointer first, pointer last, pointer d_first)
    {
-      if constexpr (trivial_copy)
-         memcpy(d_first, first, sizeof(value_type) * (last - first));
+      if(constant_evaluated())
+         for(; first != last; ++first, ++d_first) construct(d_first, std::move(*first));
+      else if constexpr (trivial_copy)
+         copy_bytes(to_address(d_first), to_address(first), sizeof(value_type) * (last - first));
       else std::uninitialized_move(first, last, d_first);
    }
 
-   // copy data in [first, last) to array begins at d_first
-   static void copy(pointer first, pointer last, pointer d_first)
+   // copy data in [first, last) to uninitialized array begins at d_first
+   template<class ForwardIterator>
+   static SDA_CONSTEXPR void uninitialized_copy(ForwardIterator first, ForwardIterator last, pointer d_first)
    {
-      if constexpr (trivial_copy)
-         memcpy(d_first, first, sizeof(value_type) * (last - first));
-      else std::copy(first, last, d_first);
+      if(constant_evaluated())
+         for(; first != last; ++first, ++d_first) construct(d_first, *first);
+      else if constexpr (trivial_copy && std::is_convertible<ForwardIterator, const_pointer>::value)
+         copy_bytes(to_address(d_first), to_address(const_pointer(first)), sizeof(value_type) * (last - first));
+      else std::uninitialized_copy(first, last, d_first);
    }
 
 
@@ -278,7 +561,7 @@ class sda
    //------------------------------------------------
 
    //    move forward, maybe overlapped or not
-   static void move_generic(allocator_type& alloc, pointer first, pointer last, pointer d_first)
+   static SDA_CONSTEXPR void move_generic(allocator_type& alloc, pointer first, pointer last, pointer d_first)
    {
       size_type k = first - d_first;
       size_type n = last - first;
@@ -288,19 +571,17 @@ class sda
          {
             uninitialized_move(first, first + k, d_first);
             move_separate(first + k, last, first);
-            for(pointer p = last - k; p != last; p++)
-               std::allocator_traits<allocator_type>::destroy(alloc, p);
+            destroy_range(alloc, last - k, last);
          }
          else
          {
             uninitialized_move(first, last, d_first);
-            for(pointer p = first; p != last; p++)
-               std::allocator_traits<allocator_type>::destroy(alloc, p);
+            destroy_range(alloc, first, last);
          }
       }
    }
    //    move backward, maybe overlapped or not
-   static void move_backward_generic(allocator_type& alloc, pointer first, pointer last, pointer d_last)
+   static SDA_CONSTEXPR void move_backward_generic(allocator_type& alloc, pointer first, pointer last, pointer d_last)
    {
       size_type k = d_last - last;
       size_type n = last - first;
@@ -310,26 +591,48 @@ class sda
          {
             uninitialized_move(last - k, last, last);
             move_backward_separate(first, last - k, last);
-            for(pointer p = first; p != first + k; p++)
-               std::allocator_traits<allocator_type>::destroy(alloc, p);
+            destroy_range(alloc, first, first + k);
          }
          else
          {
             uninitialized_move(first, last, d_last - n);
-            for(pointer p = first; p != last; p++)
-               std::allocator_traits<allocator_type>::destroy(alloc, p);
+            destroy_range(alloc, first, last);
          }
       }
    }
-   static void uninitialized_fill(allocator_type& alloc, pointer first, pointer last, const value_type& val)
+   //    move all data to begin at new_begin, inside current block
+   SDA_CONSTEXPR void slide(pointer new_begin)
+   {
+      size_type size_temp = size();
+      if(new_begin < impl_.begin_)
+         move_generic(impl_, impl_.begin_, impl_.end_, new_begin);
+      else
+         move_backward_generic(impl_, impl_.begin_, impl_.end_, new_begin + size_temp);
+      impl_.begin_ = new_begin;
+      impl_.end_ = new_begin + size_temp;
+   }
+   static SDA_CONSTEXPR void uninitialized_fill(allocator_type& alloc, pointer first, pointer last, const value_type& val)
    {
+      if constexpr (byte_fill)
+         if(!constant_evaluated())
+         {
+            fill_bytes(to_address(first), last - first, val);
+            return;
+         }
       for(; first != last; first++)
-         std::allocator_traits<allocator_type>::construct(alloc, first, val);
+         alloc_trait::construct(alloc, to_address(first), val);
    }
-   static void fill(allocator_type& alloc, pointer first, pointer last, const value_type& val)
+   //    value-initialized elements, zero bytes for trivial types
+   static SDA_CONSTEXPR void uninitialized_value_construct(allocator_type& alloc, pointer first, pointer last)
    {
-      alloc.destroy(first, last);
-      uninitialized_fill(first, last, val);
+      if constexpr (byte_fill && std::is_trivially_default_constructible<value_type>::value)
+         if(!constant_evaluated())
+         {
+            fill_bytes(to_address(first), last - first, value_type());
+            return;
+         }
+      for(; first != last; first++)
+         alloc_trait::construct(alloc, to_address(first));
    }
 
 
@@ -339,24 +642,23 @@ class sda
    //    only construction or moving is needed
    //-----------------------------------------------
    template<class... Args>
-   void emplace_back_construct(Args&&... args)
+   SDA_CONSTEXPR void emplace_back_construct(Args&&... args)
    {
-      alloc_trait::construct(impl_, impl_.end_, std::forward<Args>(args)...);
+      alloc_trait::construct(impl_, to_address(impl_.end_), std::forward<Args>(args)...);
       impl_.end_++;
    }   
    template<class... Args>
-   void emplace_front_construct(Args&&... args)
+   SDA_CONSTEXPR void emplace_front_construct(Args&&... args)
    {
       impl_.begin_--;
-      alloc_trait::construct(impl_, impl_.begin_, std::forward<Args>(args)...);
+      alloc_trait::construct(impl_, to_address(impl_.begin_), std::forward<Args>(args)...);
    }
 
 
    template<class... Args>
-   void emplace_construct(size_type pos, Args&&... args)
+   SDA_CONSTEXPR void emplace_construct(size_type pos, bool back, Args&&... args)
    {
-      bool near_end = is_back_smaller(pos);
-      if(near_end)
+      if(back)
       {
          move_backward_generic(impl_, impl_.begin_ + pos, impl_.end_, impl_.end_ + 1);
          impl_.end_++;            
@@ -366,13 +668,12 @@ class sda
          move_generic(impl_, impl_.begin_, impl_.begin_ + pos, impl_.begin_ - 1);
          impl_.begin_--;
       }
-      alloc_trait::construct(impl_, impl_.begin_ + pos, std::forward<Args>(args)...);
+      alloc_trait::construct(impl_, to_address(impl_.begin_ + pos), std::forward<Args>(args)...);
    }
    template<class... Args>
-   void insert_multiple_construct(size_type pos, size_type n, const value_type& val)
+   SDA_CONSTEXPR void insert_multiple_construct(size_type pos, bool back, size_type n, const value_type& val)
    {
-      bool near_end = is_back_smaller(pos);
-      if(near_end)
+      if(back)
       {
          move_backward_generic(impl_, impl_.begin_ + pos, impl_.end_, impl_.end_ + n);
          impl_.end_ += n;
@@ -385,13 +686,12 @@ class sda
       uninitialized_fill(impl_, impl_.begin_ + pos, impl_.begin_ + pos + n, val);
    }
    template<class InputIterator, typename = RequireInputIterator<InputIterator>>
-   void insert_range_construct(size_type pos, InputIterator first, InputIterator last)
+   SDA_CONSTEXPR void insert_range_construct(size_type pos, bool back, InputIterator first, InputIterator last)
    {
-      bool near_end = is_back_smaller(pos);
       size_type n = std::distance(first, last);
-      if(near_end)
+      if(back)
       {
-         move_backward_generic(impl_, impl_.begin_ + pos, impl_.end_, impl_.end + n);
+         move_backward_generic(impl_, impl_.begin_ + pos, impl_.end_, impl_.end_ + n);
          impl_.end_ += n;
       }
       else
@@ -399,7 +699,32 @@ class sda
          move_generic(impl_, impl_.begin_, impl_.begin_ + pos, impl_.begin_ - n);
          impl_.begin_ -= n;
       }
-      copy(first, last, impl_.begin_ + pos);
+      uninitialized_copy(first, last, impl_.begin_ + pos);
+   }
+
+   //-------------------------------------------------------------
+   //    STREAMING INSERT
+   //    single pass iterators can't be counted beforehand,
+   //    elements are staged in the empty capacity of the nearer
+   //    side (growing like push does), then the staged block
+   //    is rotated into place with one shift
+   //-------------------------------------------------------------
+   template<class InputIterator>
+   SDA_CONSTEXPR void insert_stream(size_type pos, InputIterator first, InputIterator last)
+   {
+      if(is_back_smaller(pos))
+      {
+         size_type old_size = size();
+         for(; first != last; ++first) emplace_back(*first);
+         std::rotate(impl_.begin_ + pos, impl_.begin_ + old_size, impl_.end_);
+      }
+      else
+      {
+         size_type n = 0;
+         for(; first != last; ++first, ++n) emplace_front(*first);
+         std::reverse(impl_.begin_, impl_.begin_ + n);
+         std::rotate(impl_.begin_, impl_.begin_ + n, impl_.begin_ + n + pos);
+      }
    }
 
 
@@ -409,13 +734,13 @@ class sda
    //    require reallocation
    //-----------------------------------------------
    template<class... Args>
-   void emplace_back_realloc(Args&&... args)
+   SDA_CONSTEXPR void emplace_back_realloc(Args&&... args)
    {
       pointer new_head = impl_.grow_back();
       if(new_head) emplace_back_construct(std::forward<Args>(args)...);
    }   
    template<class... Args>
-   void emplace_front_realloc(Args&&... args)
+   SDA_CONSTEXPR void emplace_front_realloc(Args&&... args)
    {
       pointer new_head = impl_.grow_front();
       if(new_head) emplace_front_construct(std::forward<Args>(args)...);
@@ -423,33 +748,31 @@ class sda
 
 
    template<class... Args>
-   void emplace_realloc(size_type pos, Args&&... args)
+   SDA_CONSTEXPR void emplace_realloc(size_type pos, bool back, Args&&... args)
    {
-      bool near_end = is_back_smaller(pos);
-      if(near_end)
+      if(back)
       {
          pointer new_head = impl_.grow_back();
          if(new_head)
-            emplace_construct(pos, std::forward<Args>(args)...);            
+            emplace_construct(pos, true, std::forward<Args>(args)...);            
       }
       else
       {
          pointer new_head = impl_.grow_front();
          if(new_head)
-            emplace_construct(pos, std::forward<Args>(args)...);
+            emplace_construct(pos, false, std::forward<Args>(args)...);
       }
    }
 
-   void insert_multiple_realloc(size_type pos, size_type n, const value_type& val)
+   SDA_CONSTEXPR void insert_multiple_realloc(size_type pos, bool back, size_type n, const value_type& val)
    {
-      bool near_end = is_back_smaller(pos);
-      if(near_end)
+      if(back)
       {
          pointer new_head = impl_.grow_back();
          while((empty_back_capacity() < n) && new_head)
             impl_.grow_back();
          if(new_head)
-            insert_multiple_construct(pos, n, val);            
+            insert_multiple_construct(pos, true, n, val);            
       }
       else
       {
@@ -457,21 +780,20 @@ class sda
          while((empty_front_capacity() < n) && new_head)
             impl_.grow_front();
          if(new_head)
-            insert_multiple_construct(pos, n, val);
+            insert_multiple_construct(pos, false, n, val);
       }
    }
    template<class InputIterator, typename = RequireInputIterator<InputIterator>>
-   void insert_range_realloc(size_type pos, InputIterator first, InputIterator last)
+   SDA_CONSTEXPR void insert_range_realloc(size_type pos, bool back, InputIterator first, InputIterator last)
    {
-      bool near_end = is_back_smaller(pos);
       size_type n = std::distance(first, last);
-      if(near_end)
+      if(back)
       {
          pointer new_head = impl_.grow_back();
          while((empty_back_capacity() < n) && new_head)
             impl_.grow_back();
          if(new_head)
-            insert_range_construct(pos, first, last);
+            insert_range_construct(pos, true, first, last);
       }
       else
       {
@@ -479,26 +801,169 @@ class sda
          while((empty_front_capacity() < n) && new_head)
             impl_.grow_front();
          if(new_head)
-            insert_range_construct(pos, first, last);
+            insert_range_construct(pos, false, first, last);
       }
    }
 
-   bool is_back_smaller(size_type pos) const noexcept
+   //-------------------------------------------------------------
+   //    AUTO SHRINK
+   //    a side over the high watermark is cut to the low one,
+   //    big blocks release its pages in place once per doubling
+   //    of that side, the others (or a block that is mostly
+   //    empty) are reallocated
+   //-------------------------------------------------------------
+   SDA_CONSTEXPR size_type shrink_limit(size_type factor) const noexcept
+   {
+      return size() * factor + Policy::shrink_min;
+   }
+   static SDA_CONSTEXPR bool crossed_power_of_two(size_type before, size_type after) noexcept
+   {
+      return after > before && (before ^ after) > before;
+   }
+   static bool release_pages(pointer first, pointer last) noexcept
+   {
+#ifdef SDA_PAGE_RELEASE
+      static const std::uintptr_t page = sysconf(_SC_PAGESIZE);
+      std::uintptr_t a = (reinterpret_cast<std::uintptr_t>(to_address(first)) + page - 1) & ~(page - 1);
+      std::uintptr_t b = reinterpret_cast<std::uintptr_t>(to_address(last)) & ~(page - 1);
+      if(a < b) madvise(reinterpret_cast<void*>(a), b - a, MADV_DONTNEED);
+      return true;
+#else
+      (void)first;
+      (void)last;
+      return false;
+#endif
+   }
+   //    empty capacities before the shrinking operation
+   SDA_CONSTEXPR void auto_shrink(size_type old_front, size_type old_back)
+   {
+      if constexpr (Policy::shrink_high != 0)
+      {
+         size_type high = shrink_limit(Policy::shrink_high);
+         size_type front = empty_front_capacity();
+         size_type back = empty_back_capacity();
+         bool front_over = front > high;
+         bool back_over = back > high;
+         if(!front_over && !back_over) return;
+
+         size_type low = shrink_limit(Policy::shrink_low);
+         bool in_place = !constant_evaluated()
+            && capacity() * sizeof(value_type) >= Policy::release_bytes
+            && empty_capacity() <= shrink_limit(Policy::shrink_realloc);
+         if(in_place)
+         {
+            if(front_over && crossed_power_of_two(old_front, front))
+               in_place = release_pages(impl_.head_, impl_.begin_ - low);
+            if(back_over && crossed_power_of_two(old_back, back))
+               in_place = release_pages(impl_.end_ + low, impl_.tail_);
+         }
+         if(!in_place)
+         {
+            size_type new_front = front_over ? low : front;
+            size_type new_back = back_over ? low : back;
+            impl_.relocate(size() + new_front + new_back, new_front);
+         }
+      }
+      else
+      {
+         (void)old_front;
+         (void)old_back;
+      }
+   }
+
+   //-------------------------------------------------
+   //    MERGE
+   //    a sorted batch of m elements is merged into the
+   //    empty capacity next to begin_ or end_, only the
+   //    elements between the batch and that end move
+   //-------------------------------------------------
+   template<class V>
+   SDA_CONSTEXPR void place(pointer d, bool constructed, V&& val)
+   {
+      if(constructed) *d = std::forward<V>(val);
+      else alloc_trait::construct(impl_, to_address(d), std::forward<V>(val));
+   }
+   //    needs empty_front_capacity() >= m
+   template<class ForwardIterator, class Compare>
+   SDA_CONSTEXPR void merge_front(ForwardIterator first, size_type m, Compare& comp)
+   {
+      pointer old_begin = impl_.begin_;
+      pointer i = old_begin;
+      pointer d = old_begin - m;
+      impl_.begin_ = d;
+      while(m)
+      {
+         if(i != impl_.end_ && !comp(*first, *i))
+         {
+            place(d, d >= old_begin, std::move(*i));
+            ++i;
+         }
+         else
+         {
+            place(d, d >= old_begin, *first);
+            ++first;
+            m--;
+         }
+         ++d;
+      }
+   }
+   //    needs empty_back_capacity() >= m
+   template<class BidirectionalIterator, class Compare>
+   SDA_CONSTEXPR void merge_back(BidirectionalIterator last, size_type m, Compare& comp)
+   {
+      pointer old_end = impl_.end_;
+      pointer i = old_end;
+      pointer d = old_end + m;
+      impl_.end_ = d;
+      while(m)
+      {
+         --d;
+         BidirectionalIterator j = std::prev(last);
+         if(i != impl_.begin_ && comp(*j, *(i - 1)))
+         {
+            --i;
+            place(d, d < old_end, std::move(*i));
+         }
+         else
+         {
+            place(d, d < old_end, *j);
+            last = j;
+            m--;
+         }
+      }
+   }
+
+   //    blocks of other can be taken over by this array
+   SDA_CONSTEXPR bool same_allocator(const sda& other) const
+   {
+      return alloc_trait::is_always_equal::value || get_allocator() == other.get_allocator();
+   }
+   //    move [first, last) of from into a new block of to
+   static SDA_CONSTEXPR void move_out(Impl& to, Impl& from, pointer first, pointer last)
+   {
+      size_type n = last - first;
+      to.relocate(n, 0);
+      uninitialized_move(first, last, to.begin_);
+      to.end_ = to.begin_ + n;
+      from.destroy(first, last);
+   }
+
+   SDA_CONSTEXPR bool is_back_smaller(size_type pos) const noexcept
    {
       return pos > (size() - pos);
    }
 
-   bool is_back_smaller(const_iterator pos) const noexcept
+   SDA_CONSTEXPR bool is_back_smaller(const_iterator pos) const noexcept
    {
       return (pos - impl_.begin_) > (impl_.end_ - pos);
    }
 
-   bool is_back_smaller(size_type first, size_type last) const noexcept
+   SDA_CONSTEXPR bool is_back_smaller(size_type first, size_type last) const noexcept
    {
       return first > (size() - last);
    }
 
-   bool is_back_smaller(const_iterator first, const_iterator last) const noexcept
+   SDA_CONSTEXPR bool is_back_smaller(const_iterator first, const_iterator last) const noexcept
    {
       return (first - impl_.begin_) > (impl_.end_ - last);
    }
@@ -522,34 +987,57 @@ class sda
    //--------------------
    sda() = default;
 
-   explicit sda(const allocator_type& alloc) noexcept : impl_(alloc) {}
+   explicit SDA_CONSTEXPR sda(const allocator_type& alloc) noexcept : impl_(alloc) {}
 
-   sda(size_type n, const value_type& val, const allocator_type& alloc = allocator_type()) : impl_(n, alloc) 
+   SDA_CONSTEXPR sda(size_type n, const value_type& val, const allocator_type& alloc = allocator_type()) : impl_(n, alloc) 
    {
       uninitialized_fill(impl_, impl_.begin_, impl_.end_, val);
    }
 
-   explicit sda(size_type n, const allocator_type& alloc = allocator_type()) : impl_(n, alloc) {}
+   explicit SDA_CONSTEXPR sda(size_type n, const allocator_type& alloc = allocator_type()) : impl_(n, alloc)
+   {
+      uninitialized_value_construct(impl_, impl_.begin_, impl_.end_);
+   }
 
    template<class InputIterator, typename = RequireInputIterator<InputIterator>>
-   sda(InputIterator first, InputIterator last, const allocator_type& alloc = allocator_type())
-   : impl_(std::distance(first, last), alloc)
+   SDA_CONSTEXPR sda(InputIterator first, InputIterator last, const allocator_type& alloc = allocator_type())
+   : impl_(alloc)
    {
-      std::uninitialized_copy(first, last, impl_.begin_);
+      if constexpr (is_multi_pass<InputIterator>)
+      {
+         size_type n = std::distance(first, last);
+         impl_.relocate(n, 0);
+         uninitialized_copy(first, last, impl_.begin_);
+         impl_.end_ = impl_.begin_ + n;
+      }
+      else
+         for(; first != last; ++first) emplace_back(*first);
    }
    
-   sda(const sda& other) : sda(other, alloc_trait::select_on_container_copy_construction(other.get_allocator())) {}
+   SDA_CONSTEXPR sda(const sda& other) : sda(other, alloc_trait::select_on_container_copy_construction(other.get_allocator())) {}
 
-   sda(const sda& other, const allocator_type& alloc) : sda(other.begin(), other.end(), alloc) {}
+   SDA_CONSTEXPR sda(const sda& other, const allocator_type& alloc) : sda(other.begin(), other.end(), alloc) {}
    
-   sda(sda&& other) noexcept : impl_(std::move(other.impl_)) {}
+   SDA_CONSTEXPR sda(sda&& other) noexcept : impl_(std::move(other.impl_)) {}
 
-   sda(sda&& other, const allocator_type& alloc) : impl_(std::move(other.impl_), alloc) {}
+   SDA_CONSTEXPR sda(sda&& other, const allocator_type& alloc) : impl_(alloc)
+   {
+      if(same_allocator(other))
+         swap(impl_, other.impl_);
+      else
+      {
+         size_type n = other.size();
+         impl_.relocate(n, 0);
+         uninitialized_move(other.impl_.begin_, other.impl_.end_, impl_.begin_);
+         impl_.end_ = impl_.begin_ + n;
+         other.clear();
+      }
+   }
    
-   sda(std::initializer_list<value_type> il, const allocator_type& alloc = allocator_type())
+   SDA_CONSTEXPR sda(std::initializer_list<value_type> il, const allocator_type& alloc = allocator_type())
    : sda(il.begin(), il.end(), alloc) {}
 
-   allocator_type get_allocator() const
+   SDA_CONSTEXPR allocator_type get_allocator() const
    {
       return impl_;
    }
@@ -558,30 +1046,35 @@ class sda
    //    ASSIGN
    //----------------
    template<class InputIterator, typename = RequireInputIterator<InputIterator>>
-   void assign(InputIterator first, InputIterator last)
+   SDA_CONSTEXPR void assign(InputIterator first, InputIterator last)
    {
-      size_type n = std::distance(first, last);
       clear();
-      reserve(n);
-      if(capacity() >= n)
+      if constexpr (is_multi_pass<InputIterator>)
       {
-         impl_.begin_ = impl_.balance_begin(impl_.head_, n);
-         impl_.end_ = impl_.begin_ + n;
-         copy(first, last, impl_.begin_);
+         size_type n = std::distance(first, last);
+         reserve(n);
+         if(capacity() >= n)
+         {
+            impl_.begin_ = impl_.balance_begin(impl_.head_, n, capacity());
+            impl_.end_ = impl_.begin_ + n;
+            uninitialized_copy(first, last, impl_.begin_);
+         }
       }
+      else
+         for(; first != last; ++first) emplace_back(*first);
    }
-   void assign(size_type n, const value_type& val)
+   SDA_CONSTEXPR void assign(size_type n, const value_type& val)
    {
       clear();
       reserve(n);
       if(capacity() >= n)
       {
-         impl_.begin_ = impl_.balance_begin(impl_.head_, n);
+         impl_.begin_ = impl_.balance_begin(impl_.head_, n, capacity());
          impl_.end_ = impl_.begin_ + n;
-         fill(impl_, impl_.begin_, impl_.end_, val);
+         uninitialized_fill(impl_, impl_.begin_, impl_.end_, val);
       }
    }
-   void assign(std::initializer_list<value_type> il)
+   SDA_CONSTEXPR void assign(std::initializer_list<value_type> il)
    {
       assign(il.begin(), il.end());
    }
@@ -594,22 +1087,25 @@ class sda
    //-------------------
    //    OPERATOR =
    //-------------------
-   sda& operator= (const sda& other)
+   SDA_CONSTEXPR sda& operator= (const sda& other)
    {
-      if(alloc_trait::propagate_on_container_copy_assignment::value)
+      if(this == &other) return *this;
+      if constexpr (alloc_trait::propagate_on_container_copy_assignment::value)
       {
-         if (impl_ != other.impl_) clear();
-         impl_ = other.impl_;
+         //    memory of the old allocator goes back to it
+         if(!same_allocator(other)) impl_.deallocate();
+         static_cast<Allocator&>(impl_) = static_cast<const Allocator&>(other.impl_);
       }
       assign(other.begin(), other.end());
       return *this;
    }
-   sda& operator= (sda&& other) noexcept
+   SDA_CONSTEXPR sda& operator= (sda&& other)
+      noexcept(alloc_trait::propagate_on_container_move_assignment::value || alloc_trait::is_always_equal::value)
    {
       moveAssign(other);
       return *this;
    }
-   sda& operator= (std::initializer_list<value_type> il)
+   SDA_CONSTEXPR sda& operator= (std::initializer_list<value_type> il)
    {
       assign(il.begin(), il.end());
       return *this;
@@ -619,92 +1115,92 @@ class sda
    //------------------
    //    ITERATORS
    //------------------
-   iterator begin() noexcept
+   SDA_CONSTEXPR iterator begin() noexcept
    {
       return iterator(impl_.begin_);
    }   
-   const_iterator begin() const noexcept
+   SDA_CONSTEXPR const_iterator begin() const noexcept
    {
       return const_iterator(impl_.begin_);
    }
-   iterator end() noexcept
+   SDA_CONSTEXPR iterator end() noexcept
    {
       return iterator(impl_.end_);
    }
-   const_iterator end() const noexcept
+   SDA_CONSTEXPR const_iterator end() const noexcept
    {
       return const_iterator(impl_.end_);
    }
-   reverse_iterator rbegin() noexcept
+   SDA_CONSTEXPR reverse_iterator rbegin() noexcept
    {
-      return reverse_iterator(impl_.end_ - 1);
+      return reverse_iterator(impl_.end_);
    }
-   const_reverse_iterator rbegin() const noexcept
+   SDA_CONSTEXPR const_reverse_iterator rbegin() const noexcept
    {
-      return const_reverse_iterator(impl_.end_ - 1);
+      return const_reverse_iterator(impl_.end_);
    }
-   reverse_iterator rend() noexcept
+   SDA_CONSTEXPR reverse_iterator rend() noexcept
    {
-      return reverse_iterator(impl_.begin_ - 1);
+      return reverse_iterator(impl_.begin_);
    }
-   const_reverse_iterator rend() const noexcept
+   SDA_CONSTEXPR const_reverse_iterator rend() const noexcept
    {
-      return const_reverse_iterator(impl_.begin_ - 1);
+      return const_reverse_iterator(impl_.begin_);
    }
-   const_iterator cbegin() const noexcept
+   SDA_CONSTEXPR const_iterator cbegin() const noexcept
    {
       return const_iterator(impl_.begin_);
    }
-   const_iterator cend() const noexcept
+   SDA_CONSTEXPR const_iterator cend() const noexcept
    {
       return const_iterator(impl_.end_);
    }
-   const_reverse_iterator crbegin() const noexcept
+   SDA_CONSTEXPR const_reverse_iterator crbegin() const noexcept
    {
-      return const_reverse_iterator(impl_.end_ - 1);
+      return const_reverse_iterator(impl_.end_);
    }
-   const_reverse_iterator crend() const noexcept
+   SDA_CONSTEXPR const_reverse_iterator crend() const noexcept
    {
-      return const_reverse_iterator(impl_.begin_ - 1);
+      return const_reverse_iterator(impl_.begin_);
    }
 
 
    //------------------------
    //    CAPACITY
    //------------------------
-   size_type size() const noexcept
+   SDA_CONSTEXPR size_type size() const noexcept
    {
       return impl_.end_ - impl_.begin_;
    }
-   size_type front_capacity() const noexcept
+   SDA_CONSTEXPR size_type front_capacity() const noexcept
    {
       return impl_.end_ - impl_.head_;
    }
-   size_type back_capacity() const noexcept
+   SDA_CONSTEXPR size_type back_capacity() const noexcept
    {
       return impl_.tail_ - impl_.begin_;
    }
-   size_type capacity() const noexcept
+   SDA_CONSTEXPR size_type capacity() const noexcept
    {
       return impl_.tail_ - impl_.head_;
    }
-   size_type empty_front_capacity() const noexcept
+   SDA_CONSTEXPR size_type empty_front_capacity() const noexcept
    {
       return impl_.begin_ - impl_.head_;
    }
-   size_type empty_back_capacity() const noexcept
+   SDA_CONSTEXPR size_type empty_back_capacity() const noexcept
    {
       return impl_.tail_ - impl_.end_;
    }
-   size_type empty_capacity() const noexcept
+   SDA_CONSTEXPR size_type empty_capacity() const noexcept
    {
       return empty_front_capacity() + empty_back_capacity();
    }
-   size_type max_size() const noexcept
+   SDA_CONSTEXPR size_type max_size() const noexcept
    {
       return std::numeric_limits<size_type>::max();
    }
-   bool empty() const noexcept
+   SDA_CONSTEXPR bool empty() const noexcept
    {
       return impl_.begin_ == impl_.end_;
    }
@@ -712,24 +1208,26 @@ class sda
    //-------------------------
    //    RESERVE, SHRINK
    //-------------------------
-   void reserve(size_type n)
+   SDA_CONSTEXPR void reserve(size_type n)
    {
       if(n > max_size()) throw_length_error();
       if(n > capacity()) impl_.grow(n);
    }
-   void reserve_back(size_type n)
+   SDA_CONSTEXPR void reserve_back(size_type n)
    {
       if(n +  empty_front_capacity() > max_size()) throw_length_error();
       if(n > back_capacity()) impl_.grow_back(n);
    }
-   void reserve_front(size_type n)
+   SDA_CONSTEXPR void reserve_front(size_type n)
    {
       if(n + empty_back_capacity() > max_size()) throw_length_error();
       if(n > front_capacity()) impl_.grow_front(n);
    }
-   void shrink_to_fit()
+   SDA_CONSTEXPR void shrink_to_fit()
    {
-      if(size() != capacity())
+      //    a relocation keeps up to align_pad slots to align begin_,
+      //    fewer than that is already as tight as it gets
+      if(capacity() > size() + (size() ? impl_.align_pad : 0))
       {
          if(size()) impl_.grow(size());
          else impl_.deallocate();
@@ -744,63 +1242,81 @@ class sda
    //    empty front capacity = n
    //    n must be smaller or equal to respective empty capacity
    //-------------------------------------------------------------
-   void slide_to_back(size_type n = 0)
+   //    with Policy::alignment the empty capacity left
+   //    can be a little larger than n
+   SDA_CONSTEXPR void slide_to_back(size_type n = 0)
    {
-      size_type size_temp = size();
-      pointer old_begin = impl_.begin_;
-      move_backward_generic(impl_, impl_.begin_, impl_.end_, impl_.tail_ - n);
-      impl_.end_ = impl_.tail_ - n;
-      impl_.begin_ = impl_.end_ - size_temp;
-      impl_.destroy(old_begin, impl_.begin_);
-      return;
+      pointer new_begin = impl_.tail_ - n - size();
+      slide(impl_.align(new_begin, impl_.head_, new_begin));
    }
-   void slide_to_front(size_type n = 0)
+   SDA_CONSTEXPR void slide_to_front(size_type n = 0)
    {
-      size_type size_temp = size();
-      pointer old_end = impl_.end_;
-      move_generic(impl_, impl_.begin_, impl_.end_, impl_.head_ + n);
-      impl_.begin_ = impl_.head_ + n;
-      impl_.end_ = impl_.begin_ + size_temp;
-      impl_.destroy(impl_.end_, old_end);
-      return;
+      pointer new_begin = impl_.head_ + n;
+      slide(impl_.align(new_begin, new_begin, impl_.tail_ - size()));
+   }
+
+   //-------------------------------------------------------------
+   //    COST MODEL
+   //    insert_cost  : cost of making room for n elements at pos
+   //                   by shifting towards the back / front
+   //    insert_at_back : the side insert, emplace will take,
+   //                   ties go to the side with fewer elements
+   //-------------------------------------------------------------
+   //    a reallocation moves every element and destroys the old
+   //    ones, both count double unless they are trivial
+   SDA_CONSTEXPR size_type insert_cost(size_type pos, size_type n, bool back) const noexcept
+   {
+      constexpr size_type weight = std::is_trivially_move_constructible<value_type>::value
+         && std::is_trivially_destructible<value_type>::value ? 1 : 2;
+      size_type shifted = back ? size() - pos : pos;
+      size_type room = back ? empty_back_capacity() : empty_front_capacity();
+      if(room >= n) return shifted;
+      return shifted + size() / 100 * Policy::realloc_percent * weight
+         + size() % 100 * Policy::realloc_percent * weight / 100 + Policy::realloc_fixed;
+   }
+   SDA_CONSTEXPR bool insert_at_back(size_type pos, size_type n) const noexcept
+   {
+      size_type back = insert_cost(pos, n, true);
+      size_type front = insert_cost(pos, n, false);
+      return back != front ? back < front : is_back_smaller(pos);
    }
 
    //-----------------------
    //    ELEMENT ACCESS
    //-----------------------
-   reference operator[] (size_type n)
+   SDA_CONSTEXPR reference operator[] (size_type n)
    {
       return impl_.begin_[n];
    }
-   const_reference operator[] (size_type n) const
+   SDA_CONSTEXPR const_reference operator[] (size_type n) const
    {
       return impl_.begin_[n];
    }
-   reference at(size_type n)
+   SDA_CONSTEXPR reference at(size_type n)
    {
       if(n < size()) return impl_.begin_[n];
       throw_out_of_range();
    }
-   const_reference at(size_type n) const
+   SDA_CONSTEXPR const_reference at(size_type n) const
    {
       if(n < size()) return impl_.begin_[n];
       throw_out_of_range();
    }
-   reference front()
+   SDA_CONSTEXPR reference front()
    {
       return impl_.begin_[0];
    }
-   const_reference front() const
+   SDA_CONSTEXPR const_reference front() const
    {
       return impl_.begin_[0];
    }
-   reference back()
+   SDA_CONSTEXPR reference back()
    {
-      return impl_.end_[0];
+      return impl_.end_[-1];
    }
-   const_reference back() const
+   SDA_CONSTEXPR const_reference back() const
    {
-      return impl_.end_[0];
+      return impl_.end_[-1];
    }
    constexpr pointer data() noexcept
    {
@@ -812,50 +1328,95 @@ class sda
    }
 
 
+   //-------------------------------------------------------------
+   //    UNINITIALIZED APPEND, PREPEND
+   //    (trivially copyable types only)
+   //
+   //    append_uninitialized(n)  : span [end(), end() + n)
+   //    prepend_uninitialized(n) : span [begin() - n, begin())
+   //    grow if needed, then the caller writes into the span
+   //    (e.g. read() from a file descriptor)
+   //
+   //    commit_back(k)  : [end(), end() + k) joins the array
+   //    commit_front(k) : [begin() - k, begin()) joins the array
+   //    k must not exceed the span size
+   //-------------------------------------------------------------
+   SDA_CONSTEXPR span append_uninitialized(size_type n)
+   {
+      static_assert(trivial_copy, "append_uninitialized requires a trivially copyable type");
+      //    geometric growth like push_back, repeated appends stay linear
+      if(n > empty_back_capacity())
+         reserve_back(std::max<size_type>(size() + n, impl_.new_capacity_back_growing() - empty_front_capacity()));
+      return span{impl_.end_, n};
+   }
+   SDA_CONSTEXPR span prepend_uninitialized(size_type n)
+   {
+      static_assert(trivial_copy, "prepend_uninitialized requires a trivially copyable type");
+      if(n > empty_front_capacity())
+         reserve_front(std::max<size_type>(size() + n, impl_.new_capacity_front_growing() - empty_back_capacity()));
+      return span{impl_.begin_ - n, n};
+   }
+   SDA_CONSTEXPR void commit_back(size_type k) noexcept
+   {
+      impl_.end_ += k;
+   }
+   SDA_CONSTEXPR void commit_front(size_type k) noexcept
+   {
+      impl_.begin_ -= k;
+   }
 
 
    //----------------
    //    INSERT
    //----------------
-   void clear() noexcept
+   SDA_CONSTEXPR void clear() noexcept
    {
       impl_.destroy(impl_.begin_, impl_.end_);
       impl_.end_ = impl_.begin_;
    }
-   iterator insert(const_iterator pos, const value_type& val)
+   SDA_CONSTEXPR iterator insert(const_iterator pos, const value_type& val)
    {
       return emplace(pos, val);
    }
-   iterator insert(const_iterator pos, value_type&& val )
+   SDA_CONSTEXPR iterator insert(const_iterator pos, value_type&& val )
    {
       return emplace(pos, std::move(val));
    }
-   iterator insert(const_iterator pos, size_type n, const value_type& val)
+   SDA_CONSTEXPR iterator insert(const_iterator pos, size_type n, const value_type& val)
    {
-      bool near_end = is_back_smaller(pos);
-      bool enough_space = near_end ? (empty_back_capacity() >= n) : (empty_front_capacity() >= n);
       size_type pos_i = pos - impl_.begin_;
+      bool back = insert_at_back(pos_i, n);
+      bool enough_space = back ? (empty_back_capacity() >= n) : (empty_front_capacity() >= n);
       if(enough_space)
-         insert_multiple_construct(pos_i, n, val);
+         insert_multiple_construct(pos_i, back, n, val);
       else
-         insert_multiple_realloc(pos_i, n, val);
+         insert_multiple_realloc(pos_i, back, n, val);
       return impl_.begin_ + pos_i;
    }
 
    template<class InputIterator, typename = RequireInputIterator<InputIterator>>
-   iterator insert(const_iterator pos, InputIterator first, InputIterator last)
+   SDA_CONSTEXPR iterator insert(const_iterator pos, InputIterator first, InputIterator last)
    {
-      bool near_end = is_back_smaller(pos);
-      size_type n = std::distance(first, last);
-      bool enough_space = near_end ? (empty_back_capacity() >= n) : (empty_front_capacity() >= n);
-      size_type pos_i = pos - impl_.begin_;
-      if(enough_space)
-         insert_range_construct(pos_i, first, last);
+      if constexpr (!is_multi_pass<InputIterator>)
+      {
+         size_type pos_i = pos - impl_.begin_;
+         insert_stream(pos_i, first, last);
+         return impl_.begin_ + pos_i;
+      }
       else
-         insert_range_realloc(pos_i, first, last);
-      return impl_.begin_ + pos_i;
+      {
+         size_type n = std::distance(first, last);
+         size_type pos_i = pos - impl_.begin_;
+         bool back = insert_at_back(pos_i, n);
+         bool enough_space = back ? (empty_back_capacity() >= n) : (empty_front_capacity() >= n);
+         if(enough_space)
+            insert_range_construct(pos_i, back, first, last);
+         else
+            insert_range_realloc(pos_i, back, first, last);
+         return impl_.begin_ + pos_i;
+      }
    }
-   iterator insert(const_iterator pos, std::initializer_list<value_type> il)
+   SDA_CONSTEXPR iterator insert(const_iterator pos, std::initializer_list<value_type> il)
    {
       return insert(pos, il.begin(), il.end());
    }
@@ -865,15 +1426,15 @@ class sda
    //    current array must have
    //    enough memory (no reallocation)
    //------------------------------------------
-   iterator join(const_iterator pos, const value_type& val)
+   SDA_CONSTEXPR iterator join(const_iterator pos, const value_type& val)
    {
       return emjoin(pos, val);
    }
-   iterator join(const_iterator pos, const value_type&& val)
+   SDA_CONSTEXPR iterator join(const_iterator pos, const value_type&& val)
    {
       return emjoin(pos, std::move(val));
    }
-   iterator join(const_iterator pos, size_type n, const value_type& val)
+   SDA_CONSTEXPR iterator join(const_iterator pos, size_type n, const value_type& val)
    {
       bool near_end = is_back_smaller(pos);
       size_type pos_i = pos - impl_.begin_;
@@ -903,38 +1464,42 @@ class sda
       return impl_.begin_ + pos_i;
    }
    template<class InputIterator, typename = RequireInputIterator<InputIterator>>
-   iterator join(const_iterator pos, InputIterator first, InputIterator last)
+   SDA_CONSTEXPR iterator join(const_iterator pos, InputIterator first, InputIterator last)
    {
-      bool near_end = is_back_smaller(pos);
-      size_type pos_i = pos - impl_.begin_;
-      size_type n = std::distance(first, last);
-      if((near_end && (empty_back_capacity() >= n)) || 
-         ((!near_end) && (empty_front_capacity() >= n)))
-            return insert(pos, first, last);
-      if(empty_back_capacity() >= n)
-      {
-         move_backward_generic(impl_, impl_.begin_ + pos_i, impl_.end_, impl_.end_ + n);
-         impl_.end_ += n;
-      }
-      else if(empty_front_capacity() >= n)
-      {
-         move_generic(impl_, impl_.begin_, impl_.begin_ + pos_i, impl_.begin_ - n);
-         impl_.begin_ -= n;
-      }
+      if constexpr (!is_multi_pass<InputIterator>)
+         return insert(pos, first, last);
       else
       {
-         size_type empty_front = empty_front_capacity();
-         move_generic(impl_, impl_.begin_, impl_.begin_ + pos_i, impl_.head_);
-         impl_.begin_ = impl_.head_;
-         size_type back_move_step = n - empty_front;
-         move_backward_generic(impl_, impl_.begin_ + pos_i, impl_.end_, impl_.end_ + back_move_step);
-         impl_.end_ += back_move_step;
+         bool near_end = is_back_smaller(pos);
+         size_type pos_i = pos - impl_.begin_;
+         size_type n = std::distance(first, last);
+         if((near_end && (empty_back_capacity() >= n)) || 
+            ((!near_end) && (empty_front_capacity() >= n)))
+               return insert(pos, first, last);
+         if(empty_back_capacity() >= n)
+         {
+            move_backward_generic(impl_, impl_.begin_ + pos_i, impl_.end_, impl_.end_ + n);
+            impl_.end_ += n;
+         }
+         else if(empty_front_capacity() >= n)
+         {
+            move_generic(impl_, impl_.begin_, impl_.begin_ + pos_i, impl_.begin_ - n);
+            impl_.begin_ -= n;
+         }
+         else
+         {
+            size_type empty_front = empty_front_capacity();
+            move_generic(impl_, impl_.begin_, impl_.begin_ + pos_i, impl_.head_);
+            impl_.begin_ = impl_.head_;
+            size_type back_move_step = n - empty_front;
+            move_backward_generic(impl_, impl_.begin_ + pos_i, impl_.end_, impl_.end_ + back_move_step);
+            impl_.end_ += back_move_step;
+         }
+         uninitialized_copy(first, last, impl_.begin_ + pos_i);
+         return impl_.begin_ + pos_i;
       }
-      copy(first, last, impl_.begin_ + pos_i);
-      return impl_.begin_ + pos_i;
-      
    }
-   iterator join(const_iterator pos, std::initializer_list<value_type> il)
+   SDA_CONSTEXPR iterator join(const_iterator pos, std::initializer_list<value_type> il)
    {
       return join(pos, il.begin(), il.end());
    }
@@ -945,11 +1510,13 @@ class sda
    //--------------
 
 
-   iterator erase(const_iterator pos)
+   SDA_CONSTEXPR iterator erase(const_iterator pos)
    {
       bool near_end = is_back_smaller(pos);
       size_type pos_i = pos - impl_.begin_;
-      alloc_trait::destroy(impl_, impl_.begin_ + pos_i);
+      size_type old_front = empty_front_capacity();
+      size_type old_back = empty_back_capacity();
+      alloc_trait::destroy(impl_, to_address(impl_.begin_ + pos_i));
       if(near_end)
       {
          move_generic(impl_, impl_.begin_ + pos_i + 1, impl_.end_, impl_.begin_ + pos_i);
@@ -960,14 +1527,17 @@ class sda
          move_backward_generic(impl_, impl_.begin_, impl_.begin_ + pos_i, impl_.begin_ + pos_i + 1);
          impl_.begin_++;   
       }
+      auto_shrink(old_front, old_back);
       return impl_.begin_ + pos_i;   
    }
-   iterator erase(const_iterator first, const_iterator last)
+   SDA_CONSTEXPR iterator erase(const_iterator first, const_iterator last)
    {
       bool near_end = is_back_smaller(first, last);
       size_type first_i = first - impl_.begin_;
       size_type last_i = last - impl_.begin_;
       size_type n = last - first;
+      size_type old_front = empty_front_capacity();
+      size_type old_back = empty_back_capacity();
       impl_.destroy(impl_.begin_ + first_i, impl_.begin_ + last_i);
       if(near_end)
       {
@@ -979,13 +1549,14 @@ class sda
          move_backward_generic(impl_, impl_.begin_, impl_.begin_ + first_i, impl_.begin_ + last_i);
          impl_.begin_ += n;
       }
+      auto_shrink(old_front, old_back);
       return impl_.begin_ + first_i;
    }
 
    //--------------
    //    PUSH
    //--------------
-   void push_back(const value_type& val)
+   SDA_CONSTEXPR void push_back(const value_type& val)
    {
       if(impl_.end_ != impl_.tail_)
       {
@@ -994,7 +1565,7 @@ class sda
       }
       emplace_back_realloc(val);
    }
-   void push_back(value_type&& val)
+   SDA_CONSTEXPR void push_back(value_type&& val)
    {
       if(impl_.end_ != impl_.tail_)
       {
@@ -1003,7 +1574,7 @@ class sda
       }
       emplace_back_realloc(std::move(val));
    }
-   void push_front(const value_type& val)
+   SDA_CONSTEXPR void push_front(const value_type& val)
    {
       if(impl_.begin_ != impl_.head_)
       {
@@ -1012,7 +1583,7 @@ class sda
       }
       emplace_front_realloc(val);
    }
-   void push_front(value_type&& val)
+   SDA_CONSTEXPR void push_front(value_type&& val)
    {
       if(impl_.begin_ != impl_.head_)
       {
@@ -1026,7 +1597,7 @@ class sda
    //    EMPLACE
    //-----------------
    template<class... Args>
-   iterator emplace_back(Args&&... args)
+   SDA_CONSTEXPR iterator emplace_back(Args&&... args)
    {
       if(impl_.end_ != impl_.tail_)
       {
@@ -1037,7 +1608,7 @@ class sda
       return impl_.end_ - 1;
    }
    template<class... Args>
-   iterator emplace_front(Args&&... args)
+   SDA_CONSTEXPR iterator emplace_front(Args&&... args)
    {
       if(impl_.begin_ != impl_.head_)
       {
@@ -1050,21 +1621,21 @@ class sda
 
 
    template<class... Args>
-   iterator emplace(const_iterator pos, Args&&... args)
+   SDA_CONSTEXPR iterator emplace(const_iterator pos, Args&&... args)
    {
-      bool near_end = is_back_smaller(pos);
-      bool enough_space = near_end ? (empty_back_capacity() > 0) : (empty_front_capacity() > 0);
       size_type pos_i = pos - impl_.begin_;
+      bool back = insert_at_back(pos_i, 1);
+      bool enough_space = back ? (empty_back_capacity() > 0) : (empty_front_capacity() > 0);
       if(enough_space)
-         emplace_construct(pos_i, std::forward<Args>(args)...);
+         emplace_construct(pos_i, back, std::forward<Args>(args)...);
       else
-         emplace_realloc(pos_i, std::forward<Args>(args)...);
+         emplace_realloc(pos_i, back, std::forward<Args>(args)...);
       return impl_.begin_ + pos_i;
    }
    //    join version of emplace
    //    never reallocate, current array must have enough memory
    template<class... Args>
-   iterator emjoin(const_iterator pos, Args&&... args)
+   SDA_CONSTEXPR iterator emjoin(const_iterator pos, Args&&... args)
    {
       bool near_end = is_back_smaller(pos);
       size_type pos_i = pos - impl_.begin_;
@@ -1074,13 +1645,13 @@ class sda
       {
          move_backward_generic(impl_, impl_.begin_ + pos_i, impl_.end_, impl_.end_ + 1);
          impl_.end_ ++;
-         alloc_trait::construct(impl_, impl_.begin_ + pos_i, std::forward<Args>(args)...);
+         alloc_trait::construct(impl_, to_address(impl_.begin_ + pos_i), std::forward<Args>(args)...);
       }
       else
       {
          move_generic(impl_, impl_.begin_, impl_.begin_ + pos_i, impl_.begin_ - 1);
          impl_.begin_ --;
-         alloc_trait::construct(impl_, impl_.begin_ + pos_i, std::forward<Args>(args)...);
+         alloc_trait::construct(impl_, to_address(impl_.begin_ + pos_i), std::forward<Args>(args)...);
       }
       return impl_.begin_ + pos_i;
    }
@@ -1088,15 +1659,17 @@ class sda
    //--------------
    //    POP
    //--------------
-   void pop_back()
+   SDA_CONSTEXPR void pop_back()
    {
       impl_.end_--;
-      alloc_trait::destroy(impl_, impl_.end_);
+      alloc_trait::destroy(impl_, to_address(impl_.end_));
+      auto_shrink(empty_front_capacity(), empty_back_capacity() - 1);
    }
-   void pop_front()
+   SDA_CONSTEXPR void pop_front()
    {
-      alloc_trait::destroy(impl_, impl_.begin_);
+      alloc_trait::destroy(impl_, to_address(impl_.begin_));
       impl_.begin_++;
+      auto_shrink(empty_front_capacity() - 1, empty_back_capacity());
    }
 
    //------------------------------------------------
@@ -1104,57 +1677,238 @@ class sda
    //    resize_back: change size, back capacity
    //    resize_front: change size, front capacity
    //------------------------------------------------
-   void resize_back(size_type n)
+   SDA_CONSTEXPR void resize_back(size_type n)
    {
       if(n <= size())
-         impl_.destroy(impl_.begin_ + n, impl_.end_);
-      else
       {
-         reserve_back(n);
-         for(pointer p = impl_.end_; p != impl_.begin_ + n; p++)
-            alloc_trait::construct(impl_, p);
+         size_type old_back = empty_back_capacity();
+         impl_.destroy(impl_.begin_ + n, impl_.end_);
+         impl_.end_ = impl_.begin_ + n;
+         auto_shrink(empty_front_capacity(), old_back);
+         return;
       }
+      reserve_back(n);
+      uninitialized_value_construct(impl_, impl_.end_, impl_.begin_ + n);
       impl_.end_ = impl_.begin_ + n;
    }
-   void resize_back(size_type n, const value_type& val)
+   SDA_CONSTEXPR void resize_back(size_type n, const value_type& val)
    {
       if(n <= size())
-         impl_.destroy(impl_.begin_ + n, impl_.end_);
-      else
       {
-         reserve_back(n);
-         for(pointer p = impl_.end_; p != impl_.begin_ + n; p++)
-            alloc_trait::construct(impl_, p, val);
+         size_type old_back = empty_back_capacity();
+         impl_.destroy(impl_.begin_ + n, impl_.end_);
+         impl_.end_ = impl_.begin_ + n;
+         auto_shrink(empty_front_capacity(), old_back);
+         return;
       }
+      reserve_back(n);
+      uninitialized_fill(impl_, impl_.end_, impl_.begin_ + n, val);
       impl_.end_ = impl_.begin_ + n;
    }
-   void resize_front(size_type n)
+   SDA_CONSTEXPR void resize_front(size_type n)
    {
       if(n <= size())
-         impl_.destroy(impl_.begin_, impl_.end_ - n);
-      else
       {
-         reserve_front(n);
-         for(pointer p = impl_.end_ - n; p != impl_.begin_; p++)
-            alloc_trait::construct(impl_, p);
+         size_type old_front = empty_front_capacity();
+         impl_.destroy(impl_.begin_, impl_.end_ - n);
+         impl_.begin_ = impl_.end_ - n;
+         auto_shrink(old_front, empty_back_capacity());
+         return;
       }
+      reserve_front(n);
+      uninitialized_value_construct(impl_, impl_.end_ - n, impl_.begin_);
       impl_.begin_ = impl_.end_ - n;
    }
-   void resize_front(size_type n, const value_type& val)
+   SDA_CONSTEXPR void resize_front(size_type n, const value_type& val)
    {
       if(n <= size())
       {
+         size_type old_front = empty_front_capacity();
          impl_.destroy(impl_.begin_, impl_.end_ - n);
+         impl_.begin_ = impl_.end_ - n;
+         auto_shrink(old_front, empty_back_capacity());
+         return;
+      }
+      reserve_front(n);
+      uninitialized_fill(impl_, impl_.end_ - n, impl_.begin_, val);
+      impl_.begin_ = impl_.end_ - n;
+   }
+
+   //------------------------------------------------------------
+   //    SPLIT, APPEND, PREPEND, SPLICE
+   //    split_off(pos) : [pos, end()) becomes a new array, only
+   //                     the shorter part is moved, the longer
+   //                     part keeps the memory block
+   //    append, prepend, splice : move elements of other in, or
+   //                     move this array into the empty capacity
+   //                     of other and take over its block when
+   //                     that moves fewer elements
+   //    other is left empty
+   //------------------------------------------------------------
+   SDA_CONSTEXPR sda split_off(size_type pos)
+   {
+      sda other(get_allocator());
+      if(is_back_smaller(pos))
+      {
+         move_out(other.impl_, impl_, impl_.begin_ + pos, impl_.end_);
+         impl_.end_ = impl_.begin_ + pos;
       }
       else
       {
-         reserve_front(n);
-         for(pointer p = impl_.end_ - n; p != impl_.begin_; p++)
-            alloc_trait::construct(impl_, p, val);
+         swap(impl_, other.impl_);
+         move_out(impl_, other.impl_, other.impl_.begin_, other.impl_.begin_ + pos);
+         other.impl_.begin_ += pos;
       }
-      impl_.begin_ = impl_.end_ - n;
+      return other;
    }
-   void swap(sda& other) noexcept
+   SDA_CONSTEXPR void append(sda&& other)
+   {
+      size_type n = size();
+      size_type m = other.size();
+      bool fits_here = m <= empty_back_capacity();
+      bool fits_there = n <= other.empty_front_capacity() && same_allocator(other);
+      if(fits_there && (!fits_here || n < m))
+      {
+         uninitialized_move(impl_.begin_, impl_.end_, other.impl_.begin_ - n);
+         other.impl_.begin_ -= n;
+         clear();
+         swap(impl_, other.impl_);
+         return;
+      }
+      if(!fits_here)
+         impl_.grow_back(std::max<size_type>(n + m,
+            impl_.new_capacity_back_growing() - empty_front_capacity()));
+      uninitialized_move(other.impl_.begin_, other.impl_.end_, impl_.end_);
+      impl_.end_ += m;
+      other.clear();
+   }
+   SDA_CONSTEXPR void prepend(sda&& other)
+   {
+      size_type n = size();
+      size_type m = other.size();
+      bool fits_here = m <= empty_front_capacity();
+      bool fits_there = n <= other.empty_back_capacity() && same_allocator(other);
+      if(fits_there && (!fits_here || n < m))
+      {
+         uninitialized_move(impl_.begin_, impl_.end_, other.impl_.end_);
+         other.impl_.end_ += n;
+         clear();
+         swap(impl_, other.impl_);
+         return;
+      }
+      if(!fits_here)
+         impl_.grow_front(std::max<size_type>(n + m,
+            impl_.new_capacity_front_growing() - empty_back_capacity()));
+      uninitialized_move(other.impl_.begin_, other.impl_.end_, impl_.begin_ - m);
+      impl_.begin_ -= m;
+      other.clear();
+   }
+   SDA_CONSTEXPR iterator splice(const_iterator pos, sda&& other)
+   {
+      size_type pos_i = pos - impl_.begin_;
+      size_type n = size();
+      size_type m = other.size();
+      if(pos_i == n) append(std::move(other));
+      else if(pos_i == 0) prepend(std::move(other));
+      else if(pos_i <= other.empty_front_capacity() && n - pos_i <= other.empty_back_capacity()
+         && n < m + std::min(pos_i, n - pos_i) && same_allocator(other))
+      {
+         uninitialized_move(impl_.begin_, impl_.begin_ + pos_i, other.impl_.begin_ - pos_i);
+         uninitialized_move(impl_.begin_ + pos_i, impl_.end_, other.impl_.end_);
+         other.impl_.begin_ -= pos_i;
+         other.impl_.end_ += n - pos_i;
+         clear();
+         swap(impl_, other.impl_);
+      }
+      else
+      {
+         insert(pos, std::make_move_iterator(other.begin()), std::make_move_iterator(other.end()));
+         other.clear();
+      }
+      return impl_.begin_ + pos_i;
+   }
+
+   //------------------------------------------------------------
+   //    MERGE
+   //    merge_sorted(first, last) : merge a sorted range into
+   //                     this sorted array
+   //    inplace_merge(mid) : merge sorted [begin(), mid) and
+   //                     [mid, end())
+   //    empty capacity is the merge buffer, memory is allocated
+   //    only when it is too small, both are stable
+   //------------------------------------------------------------
+   template<class ForwardIterator, class Compare = std::less<value_type>,
+      typename = RequireForwardIterator<ForwardIterator>>
+   SDA_CONSTEXPR void merge_sorted(ForwardIterator first, ForwardIterator last, Compare comp = Compare())
+   {
+      constexpr bool bidirectional = std::is_base_of<std::bidirectional_iterator_tag, typename
+         std::iterator_traits<ForwardIterator>::iterator_category>::value;
+      size_type m = std::distance(first, last);
+      if(m == 0) return;
+
+      //    elements of this array moved by merging into each side
+      ForwardIterator batch_back = std::next(first, m - 1);
+      size_type front_moves = std::upper_bound(impl_.begin_, impl_.end_, *batch_back, comp) - impl_.begin_;
+      size_type back_moves = impl_.end_ - std::upper_bound(impl_.begin_, impl_.end_, *first, comp);
+      bool to_back = bidirectional && back_moves < front_moves;
+      if(m > (to_back ? empty_back_capacity() : empty_front_capacity()))
+      {
+         if(bidirectional && m <= (to_back ? empty_front_capacity() : empty_back_capacity()))
+            to_back = !to_back;
+         else if(to_back)
+            reserve_back(std::max<size_type>(size() + m, impl_.new_capacity_back_growing() - empty_front_capacity()));
+         else
+            reserve_front(std::max<size_type>(size() + m, impl_.new_capacity_front_growing() - empty_back_capacity()));
+      }
+      if constexpr (bidirectional)
+         if(to_back)
+         {
+            merge_back(last, m, comp);
+            return;
+         }
+      merge_front(first, m, comp);
+   }
+   template<class Compare = std::less<value_type>>
+   SDA_CONSTEXPR void inplace_merge(const_iterator mid, Compare comp = Compare())
+   {
+      //    skip what is already in place on both ends
+      size_type mid_i = mid - impl_.begin_;
+      if(mid_i == 0 || mid_i == size()) return;
+      size_type first_i = std::upper_bound(impl_.begin_, impl_.begin_ + mid_i, impl_.begin_[mid_i], comp) - impl_.begin_;
+      size_type last_i = std::lower_bound(impl_.begin_ + mid_i, impl_.end_, impl_.begin_[mid_i - 1], comp) - impl_.begin_;
+      if(first_i == mid_i || mid_i == last_i) return;
+
+      //    the shorter run goes to the larger empty capacity
+      size_type k = std::min(mid_i - first_i, last_i - mid_i);
+      if(k > empty_front_capacity() && k > empty_back_capacity())
+         reserve_back(std::max<size_type>(size() + k, impl_.new_capacity_back_growing() - empty_front_capacity()));
+      pointer buffer = empty_back_capacity() >= k ? impl_.end_ : impl_.head_;
+      pointer first = impl_.begin_ + first_i;
+      pointer middle = impl_.begin_ + mid_i;
+      pointer last = impl_.begin_ + last_i;
+      pointer d;
+      if(mid_i - first_i == k)
+      {
+         uninitialized_move(first, middle, buffer);
+         pointer a = buffer;
+         pointer b = middle;
+         for(d = first; a != buffer + k && b != last; ++d)
+            *d = comp(*b, *a) ? std::move(*b++) : std::move(*a++);
+         std::move(a, buffer + k, d);
+      }
+      else
+      {
+         uninitialized_move(middle, last, buffer);
+         pointer a = middle;
+         pointer b = buffer + k;
+         for(d = last; a != first && b != buffer; )
+            *--d = comp(*(b - 1), *(a - 1)) ? std::move(*--a) : std::move(*--b);
+         std::move_backward(buffer, b, d);
+      }
+      impl_.destroy(buffer, buffer + k);
+   }
+
+   SDA_CONSTEXPR void swap(sda& other) noexcept
    {
       swap(impl_, other.impl_);
    }
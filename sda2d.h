@@ -0,0 +1,362 @@
+/*
+MIT License
+
+Copyright 2020 Than Minh Duy (macodeth)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+OR OTHER DEALINGS IN THE SOFTWARE.
+
+*/
+
+
+
+#ifndef SYMMETRIC_DYNAMIC_ARRAY_2D
+#define SYMMETRIC_DYNAMIC_ARRAY_2D
+
+
+
+#include<algorithm>
+#include<cstddef>
+#include<memory>
+#include<stdexcept>
+#include<type_traits>
+#include<utility>
+
+#include "sda.h"
+
+
+
+//
+//    grid of rows in one sda, column slack on both edges
+//
+//       cells_ : row slots of stride_ cells each
+//       slot 0  # # a b c # # #     row r, column c at
+//       slot 1  # # # # # # # #        rows_[r] * stride_
+//       slot 2  # # d e f # # #          + col_begin_ + c
+//       rows_  : [0, 2]     free_ : [1]
+//
+//    the directory rows_ holds the slot of every row, so
+//    insert_rows / erase_rows move row handles (the nearer half,
+//    like any sda insert) and never cells; erased rows give their
+//    slot back to free_, new rows take slots from it
+//
+//    insert_cols / erase_cols move the columns on the side with
+//    fewer of them, one contiguous range per row, the same side
+//    for every row; the side is picked with sda's cost model:
+//    cells shifted, plus a reallocation when that side has no
+//    slack left, the grid is then laid out again with sda's growth
+//    formula and the new slack split between both edges
+//
+//    every cell of the sda is constructed, slack cells and free
+//    slots hold value_type() or moved-from values
+//
+
+
+template<class T, class Allocator = std::allocator<T>>
+class sda2d
+{
+   public:
+   typedef sda<T, Allocator> array_type;
+   typedef typename array_type::allocator_type allocator_type;
+   typedef typename array_type::value_type value_type;
+   typedef typename array_type::size_type size_type;
+   typedef typename array_type::reference reference;
+   typedef typename array_type::const_reference const_reference;
+
+
+   private:
+   typedef sda<size_type, typename std::allocator_traits<Allocator>::template rebind_alloc<size_type>> index_type;
+
+   array_type cells_;
+   index_type rows_;
+   index_type free_;
+   size_type stride_ = 0;
+   size_type slots_ = 0;
+   size_type col_begin_ = 0;
+   size_type cols_ = 0;
+
+
+   //    null when there is no cell (no column capacity)
+   value_type* base() noexcept
+   {
+      return cells_.empty() ? nullptr : std::addressof(cells_[0]);
+   }
+   const value_type* base() const noexcept
+   {
+      return cells_.empty() ? nullptr : std::addressof(cells_[0]);
+   }
+   value_type* cell(size_type r, size_type c) noexcept
+   {
+      return base() + (rows_[r] * stride_ + col_begin_ + c);
+   }
+   const value_type* cell(size_type r, size_type c) const noexcept
+   {
+      return base() + (rows_[r] * stride_ + col_begin_ + c);
+   }
+   static size_type grow(size_type capacity, size_type need) noexcept
+   {
+      return std::max(need, capacity + (capacity >> 2) + 2);
+   }
+   //    moved-from cells keep no resources
+   void release(size_type r, size_type n, size_type c, size_type m)
+   {
+      if constexpr (!std::is_trivially_destructible<value_type>::value)
+         for(size_type i = r; i < r + n; i++)
+            std::fill(cell(i, c), cell(i, c) + m, value_type());
+      else
+      {
+         (void)r;
+         (void)n;
+         (void)c;
+         (void)m;
+      }
+   }
+   //    lay the grid out again in slots rows in order, col_begin
+   //    is the new slack in front of the columns
+   void relocate(size_type slots, size_type stride, size_type col_begin)
+   {
+      array_type cells(slots * stride, cells_.get_allocator());
+      for(size_type r = 0; r < rows_.size() && cols_; r++)
+         std::move(cell(r, 0), cell(r, 0) + cols_, std::addressof(cells[r * stride + col_begin]));
+      cells_.swap(cells);
+      for(size_type r = 0; r < rows_.size(); r++) rows_[r] = r;
+      free_.clear();
+      for(size_type k = slots; k > rows_.size(); k--) free_.push_back(k - 1);
+      slots_ = slots;
+      stride_ = stride;
+      col_begin_ = col_begin;
+   }
+   //    sda's cost model: shifting costs one per cell, a side
+   //    without room adds a reallocation of the grid
+   size_type realloc_cost() const noexcept
+   {
+      constexpr size_type weight = std::is_trivially_move_constructible<value_type>::value
+         && std::is_trivially_destructible<value_type>::value ? 1 : 2;
+      size_type cells = rows_.size() * cols_;
+      return cells / 100 * sda_policy::realloc_percent * weight + sda_policy::realloc_fixed;
+   }
+   //    side for n new columns at pos: true for the front,
+   //    relocate if it has no room
+   bool make_col_room(size_type pos, size_type n)
+   {
+      size_type front = col_begin_;
+      size_type back = stride_ - col_begin_ - cols_;
+      size_type front_cost = pos * rows_.size() + (front >= n ? 0 : realloc_cost());
+      size_type back_cost = (cols_ - pos) * rows_.size() + (back >= n ? 0 : realloc_cost());
+      bool to_front = front_cost != back_cost ? front_cost < back_cost : pos < cols_ - pos;
+      if((to_front ? front : back) < n)
+      {
+         size_type stride = grow(stride_, cols_ + n);
+         size_type spare = (stride - cols_ - n) / 2;
+         relocate(slots_, stride, to_front ? spare + n : spare);
+      }
+      return to_front;
+   }
+
+
+   public:
+   sda2d() = default;
+
+   sda2d(size_type rows, size_type cols, const value_type& val = value_type(),
+      const allocator_type& alloc = allocator_type())
+   : cells_(rows * cols, val, alloc), stride_(cols), slots_(rows), cols_(cols)
+   {
+      rows_.reserve(rows);
+      for(size_type r = 0; r < rows; r++) rows_.push_back(r);
+   }
+
+   //------------------
+   //    CAPACITY
+   //------------------
+   size_type rows() const noexcept
+   {
+      return rows_.size();
+   }
+   size_type cols() const noexcept
+   {
+      return cols_;
+   }
+   bool empty() const noexcept
+   {
+      return rows_.empty() || cols_ == 0;
+   }
+   //    row slots, used and free
+   size_type row_capacity() const noexcept
+   {
+      return slots_;
+   }
+   size_type col_capacity() const noexcept
+   {
+      return stride_;
+   }
+   //    room for rows x cols, column slack split between the edges
+   void reserve(size_type rows, size_type cols)
+   {
+      if(rows <= slots_ && cols <= stride_) return;
+      rows = std::max(rows, slots_);
+      cols = std::max(cols, stride_);
+      relocate(rows, cols, (cols - cols_) / 2);
+   }
+   void shrink_to_fit()
+   {
+      if(rows_.size() < slots_ || cols_ < stride_)
+         relocate(rows_.size(), cols_, 0);
+      rows_.shrink_to_fit();
+      free_.shrink_to_fit();
+   }
+   void clear() noexcept
+   {
+      cells_.clear();
+      rows_.clear();
+      free_.clear();
+      stride_ = slots_ = col_begin_ = cols_ = 0;
+   }
+
+   //------------------
+   //    ACCESS
+   //------------------
+   reference operator() (size_type r, size_type c)
+   {
+      return *cell(r, c);
+   }
+   const_reference operator() (size_type r, size_type c) const
+   {
+      return *cell(r, c);
+   }
+   reference at(size_type r, size_type c)
+   {
+      if(r >= rows_.size() || c >= cols_) throw std::out_of_range("std::out_of_range");
+      return *cell(r, c);
+   }
+   const_reference at(size_type r, size_type c) const
+   {
+      if(r >= rows_.size() || c >= cols_) throw std::out_of_range("std::out_of_range");
+      return *cell(r, c);
+   }
+   //    cols() contiguous elements
+   value_type* row(size_type r) noexcept
+   {
+      return cell(r, 0);
+   }
+   const value_type* row(size_type r) const noexcept
+   {
+      return cell(r, 0);
+   }
+
+   //-------------------------------------------
+   //    ROWS
+   //    only the directory moves
+   //-------------------------------------------
+   void insert_rows(size_type pos, size_type n, const value_type& val = value_type())
+   {
+      if(n == 0) return;
+      if(free_.size() < n) relocate(grow(slots_, rows_.size() + n), stride_, col_begin_);
+      rows_.insert(rows_.begin() + pos, free_.end() - n, free_.end());
+      free_.resize_back(free_.size() - n);
+      for(size_type r = pos; r < pos + n; r++) std::fill(cell(r, 0), cell(r, 0) + cols_, val);
+   }
+   void erase_rows(size_type first, size_type last)
+   {
+      if(first == last) return;
+      release(first, last - first, 0, cols_);
+      free_.insert(free_.end(), rows_.begin() + first, rows_.begin() + last);
+      rows_.erase(rows_.begin() + first, rows_.begin() + last);
+   }
+   void push_back_row(const value_type& val = value_type())
+   {
+      insert_rows(rows_.size(), 1, val);
+   }
+   void push_front_row(const value_type& val = value_type())
+   {
+      insert_rows(0, 1, val);
+   }
+
+   //-------------------------------------------
+   //    COLUMNS
+   //-------------------------------------------
+   void insert_cols(size_type pos, size_type n, const value_type& val = value_type())
+   {
+      if(n == 0) return;
+      if(make_col_room(pos, n))
+      {
+         for(size_type r = 0; r < rows_.size(); r++)
+         {
+            value_type* p = cell(r, 0);
+            std::move(p, p + pos, p - n);
+         }
+         col_begin_ -= n;
+      }
+      else
+      {
+         for(size_type r = 0; r < rows_.size(); r++)
+         {
+            value_type* p = cell(r, 0);
+            std::move_backward(p + pos, p + cols_, p + cols_ + n);
+         }
+      }
+      cols_ += n;
+      for(size_type r = 0; r < rows_.size(); r++) std::fill(cell(r, pos), cell(r, pos) + n, val);
+   }
+   void erase_cols(size_type first, size_type last)
+   {
+      size_type n = last - first;
+      if(n == 0) return;
+      if(first < cols_ - last)
+      {
+         for(size_type r = 0; r < rows_.size(); r++)
+         {
+            value_type* p = cell(r, 0);
+            std::move_backward(p, p + first, p + last);
+         }
+         release(0, rows_.size(), 0, n);
+         col_begin_ += n;
+      }
+      else
+      {
+         for(size_type r = 0; r < rows_.size(); r++)
+         {
+            value_type* p = cell(r, 0);
+            std::move(p + last, p + cols_, p + first);
+         }
+         release(0, rows_.size(), cols_ - n, n);
+      }
+      cols_ -= n;
+   }
+   void push_back_col(const value_type& val = value_type())
+   {
+      insert_cols(cols_, 1, val);
+   }
+   void push_front_col(const value_type& val = value_type())
+   {
+      insert_cols(0, 1, val);
+   }
+
+   void swap(sda2d& other) noexcept
+   {
+      cells_.swap(other.cells_);
+      rows_.swap(other.rows_);
+      free_.swap(other.free_);
+      std::swap(stride_, other.stride_);
+      std::swap(slots_, other.slots_);
+      std::swap(col_begin_, other.col_begin_);
+      std::swap(cols_, other.cols_);
+   }
+};
+
+
+#endif
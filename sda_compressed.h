@@ -0,0 +1,893 @@
+/*
+MIT License
+
+Copyright 2020 Than Minh Duy (macodeth)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+OR OTHER DEALINGS IN THE SOFTWARE.
+
+*/
+
+
+#ifndef SYMMETRIC_DYNAMIC_ARRAY_COMPRESSED
+#define SYMMETRIC_DYNAMIC_ARRAY_COMPRESSED
+
+
+
+#include<cstdint>
+#include<cstddef>
+#include<memory>
+#include<iterator>
+#include<initializer_list>
+#include<stdexcept>
+#include<type_traits>
+
+#include "sda.h"
+
+
+
+//
+//    values are split into blocks of at most BlockSize integers,
+//    each block is bit-packed as frame of reference (offset from
+//    the block minimum) or as delta (step from previous value),
+//    whichever needs fewer bits
+//
+//    every block remembers the virtual position of its first value,
+//    value i lives at virtual position origin_ + i
+//
+//           origin_
+//              v
+//              [ block 0 ][ block 1 ][ block 2 ] ... [ block k ]
+//               start_0    start_1    start_2         start_k
+//
+//    an insert/erase renumbers only the blocks on the nearer side,
+//    like sda moves only the nearer half of its elements
+//
+
+
+template<class Int, std::size_t BlockSize = 128>
+class sda_compressed
+{
+   static_assert(std::is_integral<Int>::value && sizeof(Int) <= 8,
+      "sda_compressed requires an integral type of at most 64 bits");
+   static_assert(BlockSize >= 4 && BlockSize <= 4096,
+      "BlockSize must be in [4, 4096]");
+
+   public:
+   typedef Int value_type;
+   typedef std::size_t size_type;
+   typedef std::ptrdiff_t difference_type;
+   class const_iterator;
+   typedef const_iterator iterator;
+   class const_reverse_iterator;
+   typedef const_reverse_iterator reverse_iterator;
+
+
+   private:
+   typedef typename std::make_unsigned<Int>::type unsigned_type;
+   static constexpr unsigned value_bits = sizeof(Int) * 8;
+
+   struct block
+   {
+      difference_type start = 0;
+      std::unique_ptr<std::uint64_t[]> words;
+      unsigned_type base = 0;
+      unsigned_type last = 0;        // last value, delta pushes step from it
+      std::uint16_t front = 0;       // slot of the first value
+      std::uint16_t count = 0;
+      std::uint16_t word_count = 0;
+      unsigned char width = 0;
+      unsigned char delta = 0;
+
+      block() = default;
+      block(block&&) = default;
+      block& operator= (block&&) = default;
+      block(const block& other) : start(other.start), words(new std::uint64_t[other.word_count]),
+         base(other.base), last(other.last), front(other.front), count(other.count), word_count(other.word_count),
+         width(other.width), delta(other.delta)
+      {
+         std::copy(other.words.get(), other.words.get() + word_count, words.get());
+      }
+
+      //    slots the packed words hold, front room included
+      size_type slots() const noexcept
+      {
+         return width ? (word_count - 1) * 64 / width : 2 * BlockSize;
+      }
+      //    room for a push at either end without re-encoding
+      bool room_back() const noexcept
+      {
+         return count < BlockSize && front + count < slots();
+      }
+      bool room_front() const noexcept
+      {
+         return count < BlockSize && front > 0;
+      }
+   };
+
+   sda<block> blocks_;
+   difference_type origin_ = 0;
+   size_type size_ = 0;
+
+
+   //----------------------------------------------
+   //    BIT PACKING
+   //    words always have one spare word at the
+   //    end, so unpacking never needs a branch
+   //----------------------------------------------
+   static std::uint64_t mask(unsigned width) noexcept
+   {
+      return width >= 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << width) - 1;
+   }
+   static unsigned bit_width(unsigned_type x) noexcept
+   {
+      unsigned w = 0;
+      for(; x; x >>= 1) w++;
+      return w;
+   }
+   static void put(std::uint64_t* words, size_type i, unsigned width, unsigned_type v) noexcept
+   {
+      if(!width) return;
+      size_type bit = i * width;
+      size_type w = bit >> 6;
+      unsigned off = bit & 63;
+      std::uint64_t m = mask(width);
+      std::uint64_t x = std::uint64_t(v) & m;
+      words[w] = (words[w] & ~(m << off)) | (x << off);
+      if(off + width > 64)
+         words[w + 1] = (words[w + 1] & ~(m >> (64 - off))) | (x >> (64 - off));
+   }
+   static unsigned_type get(const std::uint64_t* words, size_type i, unsigned width) noexcept
+   {
+      if(!width) return 0;
+      size_type bit = i * width;
+      size_type w = bit >> 6;
+      unsigned off = bit & 63;
+      std::uint64_t x = (words[w] >> off) | ((words[w + 1] << 1) << (63 - off));
+      return unsigned_type(x & mask(width));
+   }
+
+   //    pack n values after front empty slots, words are
+   //    allocated for front + room (>= n) values
+   static void encode(block& b, const Int* first, size_type n, size_type room, size_type front = 0)
+   {
+      Int lo = first[0], hi = first[0];
+      bool sorted = true;
+      unsigned_type max_step = 0;
+      for(size_type i = 1; i < n; i++)
+      {
+         lo = std::min(lo, first[i]);
+         hi = std::max(hi, first[i]);
+         if(first[i] < first[i - 1]) sorted = false;
+         else max_step = std::max<unsigned_type>(max_step, unsigned_type(first[i]) - unsigned_type(first[i - 1]));
+      }
+      unsigned for_width = bit_width(unsigned_type(hi) - unsigned_type(lo));
+      unsigned delta_width = sorted ? bit_width(max_step) : value_bits + 1;
+
+      b.delta = delta_width < for_width;
+      b.width = b.delta ? delta_width : for_width;
+      b.base = b.delta ? unsigned_type(first[0]) : unsigned_type(lo);
+      b.last = unsigned_type(first[n - 1]);
+      b.front = front;
+      b.count = n;
+      b.word_count = ((front + std::max(n, room)) * b.width + 63) / 64 + 1;
+      b.words.reset(new std::uint64_t[b.word_count]());
+
+      std::uint64_t* words = b.words.get();
+      if(b.delta)
+         for(size_type i = 1; i < n; i++)
+            put(words, front + i, b.width, unsigned_type(first[i]) - unsigned_type(first[i - 1]));
+      else
+         for(size_type i = 0; i < n; i++)
+            put(words, front + i, b.width, unsigned_type(first[i]) - b.base);
+   }
+
+   //    branchless unpack, simple enough for the compiler to vectorize
+   static void decode(const block& b, Int* out) noexcept
+   {
+      const std::uint64_t* words = b.words.get();
+      const unsigned width = b.width;
+      const std::uint64_t m = mask(width);
+      if(!width)
+      {
+         std::fill(out, out + b.count, Int(b.base));
+         return;
+      }
+      for(size_type i = 0; i < b.count; i++)
+      {
+         size_type bit = (b.front + i) * width;
+         unsigned off = bit & 63;
+         std::uint64_t x = (words[bit >> 6] >> off) | ((words[(bit >> 6) + 1] << 1) << (63 - off));
+         out[i] = Int(unsigned_type(x & m));
+      }
+      if(b.delta)
+      {
+         unsigned_type acc = b.base;
+         out[0] = Int(acc);
+         for(size_type i = 1; i < b.count; i++)
+         {
+            acc += unsigned_type(out[i]);
+            out[i] = Int(acc);
+         }
+      }
+      else
+         for(size_type i = 0; i < b.count; i++)
+            out[i] = Int(unsigned_type(out[i]) + b.base);
+   }
+
+   static Int value_at(const block& b, size_type j) noexcept
+   {
+      const std::uint64_t* words = b.words.get();
+      if(!b.delta) return Int(unsigned_type(b.base + get(words, b.front + j, b.width)));
+      unsigned_type acc = b.base;
+      for(size_type i = 1; i <= j; i++) acc += get(words, b.front + i, b.width);
+      return Int(acc);
+   }
+
+
+   //----------------------------------------------
+   //    BLOCK DIRECTORY
+   //----------------------------------------------
+
+   //    index of the block holding value pos
+   size_type find_block(size_type pos) const
+   {
+      difference_type v = origin_ + difference_type(pos);
+      auto it = std::upper_bound(blocks_.begin(), blocks_.end(), v,
+         [](difference_type x, const block& b) { return x < b.start; });
+      return (it - blocks_.begin()) - 1;
+   }
+   size_type local_index(size_type b, size_type pos) const noexcept
+   {
+      return origin_ + difference_type(pos) - blocks_[b].start;
+   }
+
+   //    n values appeared (n > 0) or vanished (n < 0) inside block b
+   //    renumber the nearer side only
+   void shift_starts(size_type b, difference_type n)
+   {
+      if(b < blocks_.size() - b)
+      {
+         for(size_type k = 0; k <= b; k++) blocks_[k].start -= n;
+         origin_ -= n;
+      }
+      else
+         for(size_type k = b + 1; k < blocks_.size(); k++) blocks_[k].start += n;
+   }
+
+   //    edge blocks keep room for BlockSize values, so pushes
+   //    that fit the current width don't re-encode anything:
+   //    the last block behind its values, the first in front
+   size_type room_for(size_type b) const noexcept
+   {
+      return b + 1 == blocks_.size() ? BlockSize : 0;
+   }
+   size_type front_room_for(size_type b, size_type n) const noexcept
+   {
+      return b == 0 ? BlockSize - n : 0;
+   }
+   //    re-encode block b with the room of its place
+   void pack(size_type b, const Int* buf, size_type n)
+   {
+      encode(blocks_[b], buf, n, room_for(b), front_room_for(b, n));
+   }
+
+   //    glue a small block to one of its neighbours
+   void merge_small(size_type b)
+   {
+      if(blocks_[b].count >= BlockSize / 4) return;
+      size_type first;
+      if(b + 1 < blocks_.size() && blocks_[b].count + blocks_[b + 1].count <= BlockSize / 2)
+         first = b;
+      else if(b > 0 && blocks_[b - 1].count + blocks_[b].count <= BlockSize / 2)
+         first = b - 1;
+      else return;
+
+      Int buf[BlockSize];
+      size_type n = blocks_[first].count;
+      decode(blocks_[first], buf);
+      decode(blocks_[first + 1], buf + n);
+      n += blocks_[first + 1].count;
+      blocks_.erase(blocks_.begin() + first + 1);
+      pack(first, buf, n);
+   }
+
+   void throw_out_of_range() const
+   {
+      throw std::out_of_range("std::out_of_range");
+   }
+
+
+   /*
+   ================================================================
+   ================================================================
+
+
+                        PUBLIC FUNCTION
+
+
+   ================================================================
+   ================================================================
+   */
+
+
+   public:
+   //--------------------
+   //    CONSTRUCTOR
+   //--------------------
+   sda_compressed() = default;
+
+   template<class InputIterator, typename = typename sda<Int>::template RequireInputIterator<InputIterator>>
+   sda_compressed(InputIterator first, InputIterator last)
+   {
+      assign(first, last);
+   }
+
+   sda_compressed(std::initializer_list<Int> il) : sda_compressed(il.begin(), il.end()) {}
+
+   sda_compressed(const sda_compressed& other) = default;
+
+   sda_compressed(sda_compressed&& other) noexcept
+   : blocks_(std::move(other.blocks_)), origin_(other.origin_), size_(other.size_)
+   {
+      other.origin_ = 0;
+      other.size_ = 0;
+   }
+
+   sda_compressed& operator= (sda_compressed other) noexcept
+   {
+      swap(other);
+      return *this;
+   }
+
+   //----------------
+   //    ASSIGN
+   //----------------
+   template<class InputIterator, typename = typename sda<Int>::template RequireInputIterator<InputIterator>>
+   void assign(InputIterator first, InputIterator last)
+   {
+      clear();
+      Int buf[BlockSize];
+      size_type n = 0;
+      for(; first != last; ++first)
+      {
+         buf[n++] = *first;
+         if(n == BlockSize)
+         {
+            block b;
+            b.start = size_;
+            encode(b, buf, n, 0, blocks_.empty() ? BlockSize - n : 0);
+            blocks_.push_back(std::move(b));
+            size_ += n;
+            n = 0;
+         }
+      }
+      if(n)
+      {
+         block b;
+         b.start = size_;
+         encode(b, buf, n, BlockSize, blocks_.empty() ? BlockSize - n : 0);
+         blocks_.push_back(std::move(b));
+         size_ += n;
+      }
+   }
+
+   //------------------
+   //    ITERATORS
+   //------------------
+   const_iterator begin() const noexcept
+   {
+      return const_iterator(this, 0, 0);
+   }
+   const_iterator end() const noexcept
+   {
+      return const_iterator(this, blocks_.size(), 0);
+   }
+   const_iterator cbegin() const noexcept
+   {
+      return begin();
+   }
+   const_iterator cend() const noexcept
+   {
+      return end();
+   }
+   const_reverse_iterator rbegin() const noexcept
+   {
+      return const_reverse_iterator(end());
+   }
+   const_reverse_iterator rend() const noexcept
+   {
+      return const_reverse_iterator(begin());
+   }
+
+   //------------------------
+   //    CAPACITY
+   //------------------------
+   size_type size() const noexcept
+   {
+      return size_;
+   }
+   bool empty() const noexcept
+   {
+      return size_ == 0;
+   }
+   size_type block_count() const noexcept
+   {
+      return blocks_.size();
+   }
+   //    bytes owned by this container, directory included
+   size_type memory_usage() const noexcept
+   {
+      size_type bytes = sizeof(*this) + blocks_.capacity() * sizeof(block);
+      for(const block& b : blocks_) bytes += b.word_count * sizeof(std::uint64_t);
+      return bytes;
+   }
+   void shrink_to_fit()
+   {
+      for(size_type k = 0; k < blocks_.size(); k++)
+      {
+         block& b = blocks_[k];
+         if(!b.front && b.word_count == (b.count * b.width + 63) / 64 + 1) continue;
+         Int buf[BlockSize];
+         decode(b, buf);
+         encode(b, buf, b.count, 0);
+      }
+      blocks_.shrink_to_fit();
+   }
+
+   //-----------------------
+   //    ELEMENT ACCESS
+   //-----------------------
+   Int operator[] (size_type pos) const
+   {
+      size_type b = find_block(pos);
+      return value_at(blocks_[b], local_index(b, pos));
+   }
+   Int at(size_type pos) const
+   {
+      if(pos >= size_) throw_out_of_range();
+      return (*this)[pos];
+   }
+   Int front() const
+   {
+      return value_at(blocks_[0], 0);
+   }
+   Int back() const
+   {
+      const block& b = blocks_.back();
+      return value_at(b, b.count - 1);
+   }
+   void set(size_type pos, Int val)
+   {
+      size_type b = find_block(pos);
+      Int buf[BlockSize];
+      decode(blocks_[b], buf);
+      buf[local_index(b, pos)] = val;
+      pack(b, buf, blocks_[b].count);
+   }
+
+   //----------------
+   //    INSERT
+   //----------------
+   void clear() noexcept
+   {
+      blocks_.clear();
+      origin_ = 0;
+      size_ = 0;
+   }
+   void insert(size_type pos, Int val)
+   {
+      if(pos == size_) { push_back(val); return; }
+      if(pos == 0) { push_front(val); return; }
+
+      size_type b = find_block(pos);
+      size_type j = local_index(b, pos);
+      Int buf[BlockSize + 1];
+      decode(blocks_[b], buf);
+      size_type n = blocks_[b].count;
+      std::copy_backward(buf + j, buf + n, buf + n + 1);
+      buf[j] = val;
+      n++;
+      shift_starts(b, 1);
+      if(n <= BlockSize)
+         pack(b, buf, n);
+      else
+      {
+         //    the new block takes the back room if b was last,
+         //    the left half keeps the front room of block 0
+         size_type half = n >> 1;
+         block next;
+         next.start = blocks_[b].start + difference_type(half);
+         encode(next, buf + half, n - half, room_for(b));
+         encode(blocks_[b], buf, half, 0, front_room_for(b, half));
+         blocks_.insert(blocks_.begin() + b + 1, std::move(next));
+      }
+      size_++;
+   }
+
+   //--------------
+   //    PUSH
+   //--------------
+   void push_back(Int val)
+   {
+      if(blocks_.empty() || blocks_.back().count == BlockSize)
+      {
+         block b;
+         b.start = origin_ + difference_type(size_);
+         encode(b, &val, 1, BlockSize, blocks_.empty() ? BlockSize - 1 : 0);
+         blocks_.push_back(std::move(b));
+         size_++;
+         return;
+      }
+      block& b = blocks_.back();
+      //    in place when the offset (or the step, for delta
+      //    blocks) fits the width of the block
+      bool fits = false;
+      unsigned_type offset = 0;
+      if(b.room_back())
+      {
+         Int from = Int(b.delta ? b.last : b.base);
+         offset = unsigned_type(val) - unsigned_type(from);
+         fits = val >= from && offset <= mask(b.width);
+      }
+      if(fits)
+      {
+         put(b.words.get(), b.front + b.count++, b.width, offset);
+         b.last = unsigned_type(val);
+      }
+      else
+      {
+         Int buf[BlockSize];
+         decode(b, buf);
+         buf[b.count] = val;
+         pack(blocks_.size() - 1, buf, b.count + 1);
+      }
+      size_++;
+   }
+   void push_front(Int val)
+   {
+      origin_--;
+      if(blocks_.empty() || blocks_[0].count == BlockSize)
+      {
+         block b;
+         b.start = origin_;
+         encode(b, &val, 1, blocks_.empty() ? BlockSize : 0, BlockSize - 1);
+         blocks_.push_front(std::move(b));
+         size_++;
+         return;
+      }
+      block& b = blocks_[0];
+      //    in place when the offset fits the width, for delta
+      //    blocks the step to the old first value must fit
+      bool fits = false;
+      unsigned_type offset = 0;
+      if(b.room_front())
+      {
+         offset = b.delta ? b.base - unsigned_type(val) : unsigned_type(val) - b.base;
+         fits = (b.delta ? val <= Int(b.base) : val >= Int(b.base)) && offset <= mask(b.width);
+      }
+      if(fits)
+      {
+         if(b.delta)
+         {
+            put(b.words.get(), b.front, b.width, offset);
+            b.base = unsigned_type(val);
+         }
+         else put(b.words.get(), b.front - 1, b.width, offset);
+         b.front--;
+         b.count++;
+      }
+      else
+      {
+         Int buf[BlockSize];
+         buf[0] = val;
+         decode(b, buf + 1);
+         pack(0, buf, b.count + 1);
+      }
+      b.start--;
+      size_++;
+   }
+
+   //--------------
+   //    ERASE
+   //--------------
+   void erase(size_type pos)
+   {
+      size_type b = find_block(pos);
+      size_type j = local_index(b, pos);
+      shift_starts(b, -1);
+      size_--;
+      if(blocks_[b].count == 1)
+      {
+         blocks_.erase(blocks_.begin() + b);
+         return;
+      }
+      if(b + 1 == blocks_.size() && j + 1 == blocks_[b].count)
+      {
+         blocks_[b].count--;
+         blocks_[b].last = unsigned_type(value_at(blocks_[b], blocks_[b].count - 1));
+      }
+      else if(b == 0 && j == 0)
+      {
+         //    the second value becomes the first, its slot
+         //    already holds its offset (or step)
+         block& first = blocks_[0];
+         if(first.delta) first.base = unsigned_type(value_at(first, 1));
+         first.front++;
+         first.count--;
+      }
+      else
+      {
+         Int buf[BlockSize];
+         decode(blocks_[b], buf);
+         std::copy(buf + j + 1, buf + blocks_[b].count, buf + j);
+         pack(b, buf, blocks_[b].count - 1);
+      }
+      merge_small(b);
+   }
+   //    blocks inside the range are dropped, only the two
+   //    edge blocks are decoded
+   void erase(size_type first, size_type last)
+   {
+      if(first == last) return;
+      size_type removed = last - first;
+      size_type bf = find_block(first);
+      size_type bl = find_block(last - 1);
+      size_type jf = local_index(bf, first);
+      size_type jl = local_index(bl, last - 1) + 1;
+      Int buf[BlockSize];
+      size_ -= removed;
+      if(bf == bl)
+      {
+         shift_starts(bf, -difference_type(removed));
+         if(blocks_[bf].count == removed)
+         {
+            blocks_.erase(blocks_.begin() + bf);
+            return;
+         }
+         decode(blocks_[bf], buf);
+         std::copy(buf + jl, buf + blocks_[bf].count, buf + jf);
+         pack(bf, buf, blocks_[bf].count - removed);
+         merge_small(bf);
+         return;
+      }
+      blocks_.erase(blocks_.begin() + bf + 1, blocks_.begin() + bl);
+      bl = bf + 1;
+      //    the values kept in bl stay where they are, the gap
+      //    between bf and bl closes like an erase inside bf
+      block& tail = blocks_[bl];
+      size_type keep = tail.count - jl;
+      if(keep)
+      {
+         decode(tail, buf);
+         pack(bl, buf + jl, keep);
+      }
+      tail.start += difference_type(jl);
+      if(jf)
+      {
+         decode(blocks_[bf], buf);
+         pack(bf, buf, jf);
+      }
+      shift_starts(bf, -difference_type(removed));
+      if(!keep) blocks_.erase(blocks_.begin() + bl);
+      if(!jf) blocks_.erase(blocks_.begin() + bf);
+      if(size_ == 0) return;
+      merge_small(find_block(std::min(first, size_ - 1)));
+      if(first > 0 && first < size_) merge_small(find_block(first - 1));
+   }
+
+   //--------------
+   //    POP
+   //--------------
+   void pop_back()
+   {
+      erase(size_ - 1);
+   }
+   void pop_front()
+   {
+      erase(0);
+   }
+
+   void swap(sda_compressed& other) noexcept
+   {
+      blocks_.swap(other.blocks_);
+      std::swap(origin_, other.origin_);
+      std::swap(size_, other.size_);
+   }
+
+
+   //-----------------------------------------------------
+   //    CONST ITERATOR
+   //    decodes a whole block when it enters the block,
+   //    values are returned by value; copies share the
+   //    buffer (a copy made to step or dereference finds
+   //    the block decoded), so copies of one iterator
+   //    stay in one thread
+   //-----------------------------------------------------
+   class const_iterator
+   {
+      public:
+      typedef std::bidirectional_iterator_tag iterator_category;
+      typedef Int value_type;
+      typedef std::ptrdiff_t difference_type;
+      typedef const Int* pointer;
+      typedef Int reference;
+
+      const_iterator() = default;
+
+      reference operator* () const
+      {
+         return *operator->();
+      }
+      //    valid until a copy enters another block
+      pointer operator-> () const
+      {
+         return load(block_, index_);
+      }
+      const_iterator& operator++ () noexcept
+      {
+         if(++index_ == owner_->blocks_[block_].count)
+         {
+            block_++;
+            index_ = 0;
+         }
+         return *this;
+      }
+      const_iterator operator++ (int)
+      {
+         share();
+         const_iterator it(*this);
+         ++*this;
+         return it;
+      }
+      const_iterator& operator-- () noexcept
+      {
+         if(index_ == 0)
+         {
+            block_--;
+            index_ = owner_->blocks_[block_].count;
+         }
+         index_--;
+         return *this;
+      }
+      const_iterator operator-- (int)
+      {
+         share();
+         const_iterator it(*this);
+         --*this;
+         return it;
+      }
+      bool operator== (const const_iterator& other) const noexcept
+      {
+         return block_ == other.block_ && index_ == other.index_;
+      }
+      bool operator!= (const const_iterator& other) const noexcept
+      {
+         return !(*this == other);
+      }
+
+      private:
+      friend class sda_compressed;
+
+      struct cache
+      {
+         size_type block = ~size_type(0);
+         Int values[BlockSize];
+      };
+
+      const_iterator(const sda_compressed* owner, size_type b, size_type i) noexcept
+      : owner_(owner), block_(b), index_(i) {}
+
+      //    the buffer exists before a copy is taken
+      void share() const
+      {
+         if(!cache_) cache_ = std::make_shared<cache>();
+      }
+      pointer load(size_type b, size_type i) const
+      {
+         share();
+         if(cache_->block != b)
+         {
+            decode(owner_->blocks_[b], cache_->values);
+            cache_->block = b;
+         }
+         return cache_->values + i;
+      }
+      //    the value before this one, for the reverse iterator
+      pointer before() const
+      {
+         if(index_) return load(block_, index_ - 1);
+         return load(block_ - 1, owner_->blocks_[block_ - 1].count - 1);
+      }
+
+      const sda_compressed* owner_ = nullptr;
+      size_type block_ = 0;
+      size_type index_ = 0;
+      mutable std::shared_ptr<cache> cache_;
+   };
+
+   //-----------------------------------------------------
+   //    CONST REVERSE ITERATOR
+   //    std::reverse_iterator copies its base on every
+   //    dereference, this one reads the previous value
+   //    through the buffer of its base
+   //-----------------------------------------------------
+   class const_reverse_iterator
+   {
+      public:
+      typedef std::bidirectional_iterator_tag iterator_category;
+      typedef Int value_type;
+      typedef std::ptrdiff_t difference_type;
+      typedef const Int* pointer;
+      typedef Int reference;
+
+      const_reverse_iterator() = default;
+      explicit const_reverse_iterator(const const_iterator& it) : current_(it) {}
+
+      const_iterator base() const
+      {
+         return current_;
+      }
+      reference operator* () const
+      {
+         return *current_.before();
+      }
+      pointer operator-> () const
+      {
+         return current_.before();
+      }
+      const_reverse_iterator& operator++ () noexcept
+      {
+         --current_;
+         return *this;
+      }
+      const_reverse_iterator operator++ (int)
+      {
+         current_.share();
+         const_reverse_iterator it(*this);
+         --current_;
+         return it;
+      }
+      const_reverse_iterator& operator-- () noexcept
+      {
+         ++current_;
+         return *this;
+      }
+      const_reverse_iterator operator-- (int)
+      {
+         current_.share();
+         const_reverse_iterator it(*this);
+         ++current_;
+         return it;
+      }
+      bool operator== (const const_reverse_iterator& other) const noexcept
+      {
+         return current_ == other.current_;
+      }
+      bool operator!= (const const_reverse_iterator& other) const noexcept
+      {
+         return !(*this == other);
+      }
+
+      private:
+      const_iterator current_;
+   };
+};
+
+
+#endif
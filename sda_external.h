@@ -0,0 +1,1152 @@
+/*
+MIT License
+
+Copyright 2020 Than Minh Duy (macodeth)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+OR OTHER DEALINGS IN THE SOFTWARE.
+
+*/
+
+
+
+#ifndef SYMMETRIC_DYNAMIC_ARRAY_EXTERNAL
+#define SYMMETRIC_DYNAMIC_ARRAY_EXTERNAL
+
+
+
+#include<algorithm>
+#include<atomic>
+#include<condition_variable>
+#include<cstddef>
+#include<cstdlib>
+#include<cstring>
+#include<iterator>
+#include<memory>
+#include<mutex>
+#include<new>
+#include<stdexcept>
+#include<string>
+#include<system_error>
+#include<thread>
+#include<type_traits>
+
+#include<cerrno>
+#include<fcntl.h>
+#include<unistd.h>
+
+#include "sda.h"
+
+
+
+//
+//    array larger than memory: elements live in fixed-size blocks
+//    of a scratch file, an LRU cache of bounded size holds the
+//    blocks in use
+//
+//       blocks_ : [slot 3, begin 0, size 9] [slot 0, begin 2, size 5] ...
+//       file    : | slot 0 | slot 1 | slot 2 | slot 3 | ...
+//
+//    a block keeps slack on both sides like an sda: push / pop at
+//    either end touch only the edge block, insert and erase shift
+//    the shorter side of one block, a full block first hands
+//    elements to a neighbour with room, otherwise splits in two;
+//    a block under a quarter full merges into a neighbour
+//
+//    the directory (blocks_) holds the start of every block, only
+//    the starts on the shorter side of an edit are updated
+//
+//    a background thread writes dirty blocks back before they leave
+//    the cache and reads ahead when blocks are visited in order,
+//    forward or backward; without it (background_io = false, or no
+//    thread could be started) both happen synchronously, read-ahead
+//    becomes posix_fadvise
+//
+//    when a cache block cannot be allocated the cache stops growing
+//    and recycles the blocks it has; set_cache_bytes() resizes it
+//
+//    the file is scratch space, unlinked as soon as it is created
+//
+
+
+template<class T, class Allocator = std::allocator<T>>
+class sda_external
+{
+   static_assert(std::is_trivially_copyable<T>::value, "sda_external stores trivially copyable types");
+
+   public:
+   typedef T value_type;
+   typedef Allocator allocator_type;
+   typedef std::size_t size_type;
+   typedef std::ptrdiff_t difference_type;
+   class const_iterator;
+   typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+   struct statistics
+   {
+      std::size_t hits = 0;          // block found in the cache
+      std::size_t misses = 0;        // block read on demand
+      std::size_t prefetches = 0;    // blocks read ahead
+      std::size_t reads = 0;         // blocks read from the file
+      std::size_t writes = 0;        // blocks written to the file
+      std::size_t frames = 0;        // blocks held in memory
+      bool capped = false;           // cache limit lowered after an allocation failure
+   };
+
+
+   private:
+   typedef std::allocator_traits<Allocator> alloc_trait;
+   static constexpr size_type none = size_type(-1);
+   //    two pinned blocks and one for read-ahead
+   static constexpr size_type min_frames = 4;
+
+   //    frame states; the I/O thread only moves queued -> writing
+   //    -> clean / dirty and loading -> clean / failed, under mutex_
+   enum : unsigned char { clean, dirty, queued, writing, loading, failed };
+   enum class access { read, write, fresh };
+
+   struct block
+   {
+      difference_type start;         // position + blocks_[0].start
+      size_type slot;
+      size_type begin;
+      size_type size;
+   };
+   //    one cached block
+   struct frame
+   {
+      value_type* data = nullptr;
+      size_type slot = none;
+      std::atomic<unsigned char> state{clean};
+      unsigned pins = 0;
+      size_type prev = none;
+      size_type next = none;
+   };
+
+   allocator_type alloc_;
+   size_type block_;                 // elements per block
+   size_type block_bytes_;
+   int fd_ = -1;
+
+   sda<block> blocks_;
+   size_type size_ = 0;
+   size_type memo_ = 0;              // block of the last locate()
+
+   sda<size_type> where_;            // slot -> frame
+   sda<size_type> free_slots_;
+
+   std::unique_ptr<frame[]> frames_;
+   size_type frame_limit_;
+   size_type frame_count_ = 0;
+   sda<size_type> spare_;            // frames without a block
+   size_type head_ = none;           // most recently used
+   size_type tail_ = none;
+
+   //    sequential access detection
+   size_type last_block_ = none;
+   int direction_ = 0;
+   size_type streak_ = 0;
+   size_type prefetch_depth_;
+
+   statistics stats_;
+   std::atomic<std::size_t> reads_{0};
+   std::atomic<std::size_t> writes_{0};
+
+   //    background write-back and read-ahead
+   std::thread io_;
+   std::mutex mutex_;
+   std::condition_variable work_;
+   std::condition_variable done_;
+   sda<size_type> queue_;
+   size_type in_flight_ = 0;
+   size_type completed_ = 0;
+   bool stop_ = false;
+   int io_error_ = 0;
+
+
+   //---------------------------
+   //    FILE
+   //---------------------------
+   [[noreturn]] static void throw_errno(int error, const char* what)
+   {
+      throw std::system_error(error, std::generic_category(), what);
+   }
+   static int open_scratch(const char* directory)
+   {
+      if(!directory) directory = std::getenv("TMPDIR");
+      std::string path = directory && *directory ? directory : "/tmp";
+      path += "/sda_external.XXXXXX";
+      int fd = mkstemp(&path[0]);
+      if(fd < 0) throw_errno(errno, "sda_external: mkstemp");
+      unlink(path.c_str());
+      return fd;
+   }
+   //    whole block, false with errno set on failure
+   bool transfer(bool write, size_type slot, value_type* data)
+   {
+      char* p = reinterpret_cast<char*>(data);
+      off_t offset = off_t(slot) * off_t(block_bytes_);
+      size_type done = 0;
+      while(done < block_bytes_)
+      {
+         ssize_t r = write ? pwrite(fd_, p + done, block_bytes_ - done, offset + done)
+                           : pread(fd_, p + done, block_bytes_ - done, offset + done);
+         if(r < 0 && errno == EINTR) continue;
+         if(r < 0) return false;
+         if(r == 0)
+         {
+            if(write)
+            {
+               errno = EIO;
+               return false;
+            }
+            //    never written to the end
+            memset(p + done, 0, block_bytes_ - done);
+            break;
+         }
+         done += r;
+      }
+      (write ? writes_ : reads_).fetch_add(1, std::memory_order_relaxed);
+      return true;
+   }
+   void io_loop()
+   {
+      std::unique_lock<std::mutex> lock(mutex_);
+      for(;;)
+      {
+         work_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+         if(stop_) return;
+         size_type f = queue_.front();
+         queue_.pop_front();
+         frame& x = frames_[f];
+         unsigned char state = x.state.load(std::memory_order_relaxed);
+         if(state == queued || state == loading)
+         {
+            bool write = state == queued;
+            if(write) x.state.store(writing, std::memory_order_relaxed);
+            in_flight_++;
+            lock.unlock();
+            bool ok = transfer(write, x.slot, x.data);
+            int error = errno;
+            lock.lock();
+            in_flight_--;
+            if(write)
+            {
+               x.state.store(ok ? clean : dirty, std::memory_order_release);
+               if(!ok) io_error_ = error;
+            }
+            else x.state.store(ok ? clean : failed, std::memory_order_release);
+         }
+         completed_++;
+         done_.notify_all();
+      }
+   }
+   void enqueue(size_type f, unsigned char state)
+   {
+      {
+         std::lock_guard<std::mutex> lock(mutex_);
+         frames_[f].state.store(state, std::memory_order_relaxed);
+         queue_.push_back(f);
+      }
+      work_.notify_one();
+   }
+   //    mutex_ held
+   void check_io()
+   {
+      if(!io_error_) return;
+      int error = io_error_;
+      io_error_ = 0;
+      throw_errno(error, "sda_external: write");
+   }
+   //    wait until the I/O thread has nothing left
+   void drain()
+   {
+      if(!io_.joinable()) return;
+      std::unique_lock<std::mutex> lock(mutex_);
+      done_.wait(lock, [this] { return queue_.empty() && !in_flight_; });
+   }
+
+
+   //---------------------------
+   //    CACHE
+   //---------------------------
+   void unlink_frame(size_type f)
+   {
+      frame& x = frames_[f];
+      (x.prev == none ? head_ : frames_[x.prev].next) = x.next;
+      (x.next == none ? tail_ : frames_[x.next].prev) = x.prev;
+      x.prev = x.next = none;
+   }
+   void link_front(size_type f)
+   {
+      frame& x = frames_[f];
+      x.prev = none;
+      x.next = head_;
+      (head_ == none ? tail_ : frames_[head_].prev) = f;
+      head_ = f;
+   }
+   //    frame f no longer holds a block
+   void release(size_type f)
+   {
+      frame& x = frames_[f];
+      where_[x.slot] = none;
+      x.slot = none;
+      x.state.store(clean, std::memory_order_relaxed);
+      unlink_frame(f);
+   }
+   size_type write_ahead() const noexcept
+   {
+      return std::max<size_type>(2, frame_limit_ / 8);
+   }
+   //    a frame to reuse: a spare one, a new one while the cache may
+   //    grow, else the least recently used clean one; dirty ones on
+   //    the way are queued for write-back. none if !wait and every
+   //    frame is busy
+   size_type take_frame(bool wait)
+   {
+      if(!spare_.empty())
+      {
+         size_type f = spare_.back();
+         spare_.pop_back();
+         return f;
+      }
+      if(frame_count_ < frame_limit_)
+      {
+         value_type* data = nullptr;
+         try
+         {
+            data = alloc_trait::allocate(alloc_, block_);
+         }
+         catch(const std::bad_alloc&)
+         {
+            //    memory pressure: make do with the frames there are
+            if(frame_count_ < min_frames) throw;
+            frame_limit_ = frame_count_;
+            stats_.capped = true;
+         }
+         if(data)
+         {
+            frames_[frame_count_].data = data;
+            return frame_count_++;
+         }
+      }
+      for(;;)
+      {
+         size_type seen = 0;
+         if(io_.joinable())
+         {
+            std::lock_guard<std::mutex> lock(mutex_);
+            check_io();
+            seen = completed_;
+         }
+         size_type queued_now = 0;
+         for(size_type f = tail_; f != none && queued_now < write_ahead(); f = frames_[f].prev)
+         {
+            frame& x = frames_[f];
+            if(x.pins) continue;
+            unsigned char state = x.state.load(std::memory_order_acquire);
+            if(state == clean || state == failed)
+            {
+               release(f);
+               return f;
+            }
+            if(state != dirty) continue;
+            if(!io_.joinable())
+            {
+               if(!transfer(true, x.slot, x.data)) throw_errno(errno, "sda_external: write");
+               release(f);
+               return f;
+            }
+            enqueue(f, queued);
+            queued_now++;
+         }
+         if(!wait) return none;
+         std::unique_lock<std::mutex> lock(mutex_);
+         done_.wait(lock, [this, seen] { return completed_ != seen || io_error_; });
+      }
+   }
+   void wait_loaded(size_type f)
+   {
+      frame& x = frames_[f];
+      std::unique_lock<std::mutex> lock(mutex_);
+      done_.wait(lock, [&x] { return x.state.load(std::memory_order_relaxed) != loading; });
+   }
+   //    the I/O thread must not read a block while it changes
+   void make_writable(size_type f)
+   {
+      frame& x = frames_[f];
+      unsigned char state = x.state.load(std::memory_order_acquire);
+      if(state == clean) x.state.store(dirty, std::memory_order_relaxed);
+      if(state == clean || state == dirty) return;
+      std::unique_lock<std::mutex> lock(mutex_);
+      done_.wait(lock, [&x] { return x.state.load(std::memory_order_relaxed) != writing; });
+      x.state.store(dirty, std::memory_order_relaxed);
+   }
+   //    frame of a slot that is freed
+   void forget(size_type f)
+   {
+      frame& x = frames_[f];
+      unsigned char state = x.state.load(std::memory_order_acquire);
+      if(state == queued || state == writing || state == loading)
+      {
+         std::unique_lock<std::mutex> lock(mutex_);
+         done_.wait(lock, [&x]
+         {
+            unsigned char s = x.state.load(std::memory_order_relaxed);
+            return s != writing && s != loading;
+         });
+         x.state.store(clean, std::memory_order_relaxed);
+      }
+      release(f);
+      spare_.push_back(f);
+   }
+   size_type frame_of(size_type slot, access mode)
+   {
+      size_type f = where_[slot];
+      if(f != none)
+      {
+         if(frames_[f].state.load(std::memory_order_acquire) == loading) wait_loaded(f);
+         if(frames_[f].state.load(std::memory_order_acquire) == failed)
+         {
+            //    read-ahead failed, read again below
+            release(f);
+            spare_.push_back(f);
+            f = none;
+         }
+      }
+      if(f != none)
+      {
+         stats_.hits++;
+         if(head_ != f)
+         {
+            unlink_frame(f);
+            link_front(f);
+         }
+         if(mode != access::read) make_writable(f);
+         return f;
+      }
+      f = take_frame(true);
+      frame& x = frames_[f];
+      x.slot = slot;
+      where_[slot] = f;
+      link_front(f);
+      if(mode == access::fresh)
+      {
+         x.state.store(dirty, std::memory_order_relaxed);
+         return f;
+      }
+      stats_.misses++;
+      if(!transfer(false, slot, x.data))
+      {
+         int error = errno;
+         release(f);
+         spare_.push_back(f);
+         throw_errno(error, "sda_external: read");
+      }
+      if(mode == access::write) x.state.store(dirty, std::memory_order_relaxed);
+      return f;
+   }
+   void prefetch(size_type k, int direction, bool first)
+   {
+      for(size_type i = 1; i <= prefetch_depth_; i++)
+      {
+         if(direction < 0 && i > k) return;
+         size_type j = direction > 0 ? k + i : k - i;
+         if(j >= blocks_.size()) return;
+         size_type slot = blocks_[j].slot;
+         if(where_[slot] != none) continue;
+         if(!io_.joinable())
+         {
+            //    the blocks before were advised by earlier steps
+            if(first || i == prefetch_depth_)
+               posix_fadvise(fd_, off_t(slot) * off_t(block_bytes_), block_bytes_, POSIX_FADV_WILLNEED);
+            continue;
+         }
+         size_type f = take_frame(false);
+         if(f == none) return;
+         frames_[f].slot = slot;
+         where_[slot] = f;
+         link_front(f);
+         stats_.prefetches++;
+         enqueue(f, loading);
+      }
+   }
+   //    frame of block k, reads ahead when blocks are visited in order
+   size_type block_frame(size_type k, access mode)
+   {
+      size_type f = frame_of(blocks_[k].slot, mode);
+      if(k != last_block_)
+      {
+         int direction = k == last_block_ + 1 ? 1 : last_block_ != none && k + 1 == last_block_ ? -1 : 0;
+         streak_ = direction && direction == direction_ ? streak_ + 1 : 1;
+         direction_ = direction;
+         last_block_ = k;
+         if(direction && streak_ >= 2)
+         {
+            frames_[f].pins++;
+            prefetch(k, direction, streak_ == 2);
+            frames_[f].pins--;
+         }
+      }
+      return f;
+   }
+   //    blocks pinned by one operation stay in the cache until it ends
+   class pin_scope
+   {
+      sda_external& a_;
+      size_type pinned_[2];
+      size_type count_ = 0;
+
+      public:
+      explicit pin_scope(sda_external& a) noexcept : a_(a) {}
+      pin_scope(const pin_scope&) = delete;
+      pin_scope& operator= (const pin_scope&) = delete;
+      ~pin_scope()
+      {
+         while(count_) a_.frames_[pinned_[--count_]].pins--;
+      }
+      value_type* operator()(size_type k, access mode)
+      {
+         size_type f = a_.block_frame(k, mode);
+         a_.frames_[f].pins++;
+         pinned_[count_++] = f;
+         return a_.frames_[f].data;
+      }
+   };
+
+
+   //---------------------------
+   //    BLOCKS
+   //---------------------------
+   size_type new_slot()
+   {
+      if(free_slots_.empty())
+      {
+         where_.push_back(none);
+         return where_.size() - 1;
+      }
+      size_type slot = free_slots_.back();
+      free_slots_.pop_back();
+      return slot;
+   }
+   //    empty block before block k
+   void add_block(size_type k, size_type begin)
+   {
+      difference_type start = 0;
+      if(k < blocks_.size()) start = blocks_[k].start;
+      else if(!blocks_.empty()) start = blocks_.back().start + difference_type(blocks_.back().size);
+      blocks_.insert(blocks_.begin() + k, block{start, new_slot(), begin, 0});
+   }
+   //    empty block k
+   void remove_block(size_type k)
+   {
+      size_type slot = blocks_[k].slot;
+      if(where_[slot] != none) forget(where_[slot]);
+      free_slots_.push_back(slot);
+      blocks_.erase(blocks_.begin() + k);
+   }
+   size_type position(size_type k) const noexcept
+   {
+      return size_type(blocks_[k].start - blocks_.front().start);
+   }
+   //    block holding pos < size()
+   size_type locate(size_type pos)
+   {
+      difference_type key = difference_type(pos) + blocks_.front().start;
+      auto holds = [this, key](size_type k)
+      {
+         return k < blocks_.size() && blocks_[k].start <= key
+            && key < blocks_[k].start + difference_type(blocks_[k].size);
+      };
+      if(holds(memo_)) return memo_;
+      if(holds(memo_ + 1)) return ++memo_;
+      if(memo_ > 0 && holds(memo_ - 1)) return --memo_;
+      memo_ = std::upper_bound(blocks_.begin(), blocks_.end(), key,
+         [](difference_type v, const block& b) { return v < b.start; }) - blocks_.begin() - 1;
+      return memo_;
+   }
+   //    blocks after k move by delta: either their starts change or
+   //    the starts up to k, whichever side is shorter
+   void shift_starts(size_type k, difference_type delta) noexcept
+   {
+      if(blocks_.size() - k - 1 <= k + 1)
+         for(size_type j = k + 1; j < blocks_.size(); j++) blocks_[j].start += delta;
+      else
+         for(size_type j = 0; j <= k; j++) blocks_[j].start -= delta;
+   }
+   static void copy(value_type* d, const value_type* s, size_type n) noexcept
+   {
+      if(n) memmove(d, s, n * sizeof(value_type));
+   }
+   static void slide(value_type* p, size_type from, size_type to, size_type n) noexcept
+   {
+      if(from != to) copy(p + to, p + from, n);
+   }
+   //    n free cells at i, b.size + n <= block_; the shorter side
+   //    moves, both sides are centred when neither has room
+   void open_gap(block& b, value_type* p, size_type i, size_type n) noexcept
+   {
+      size_type back = block_ - b.begin - b.size;
+      if(b.begin >= n && (i < b.size - i || back < n))
+      {
+         slide(p, b.begin, b.begin - n, i);
+         b.begin -= n;
+      }
+      else if(back >= n)
+         slide(p, b.begin + i, b.begin + i + n, b.size - i);
+      else
+      {
+         size_type begin = (block_ - b.size - n) / 2;
+         if(begin < b.begin)
+         {
+            slide(p, b.begin, begin, i);
+            slide(p, b.begin + i, begin + i + n, b.size - i);
+         }
+         else
+         {
+            slide(p, b.begin + i, begin + i + n, b.size - i);
+            slide(p, b.begin, begin, i);
+         }
+         b.begin = begin;
+      }
+   }
+   //    last m elements of block k to the front of block k + 1
+   void move_to_next(size_type k, size_type m)
+   {
+      pin_scope pin(*this);
+      value_type* from = pin(k, access::read);
+      value_type* to = pin(k + 1, access::write);
+      block& a = blocks_[k];
+      block& b = blocks_[k + 1];
+      if(b.begin < m)
+      {
+         slide(to, b.begin, block_ - b.size, b.size);
+         b.begin = block_ - b.size;
+      }
+      b.begin -= m;
+      copy(to + b.begin, from + a.begin + a.size - m, m);
+      a.size -= m;
+      b.size += m;
+      b.start -= difference_type(m);
+   }
+   //    first m elements of block k to the back of block k - 1
+   void move_to_prev(size_type k, size_type m)
+   {
+      pin_scope pin(*this);
+      value_type* to = pin(k - 1, access::write);
+      value_type* from = pin(k, access::read);
+      block& a = blocks_[k - 1];
+      block& b = blocks_[k];
+      if(a.begin + a.size + m > block_)
+      {
+         slide(to, a.begin, 0, a.size);
+         a.begin = 0;
+      }
+      copy(to + a.begin + a.size, from + b.begin, m);
+      a.size += m;
+      b.begin += m;
+      b.size -= m;
+      b.start += difference_type(m);
+   }
+   //    elements [i, size) of block k to a new block after it
+   void split(size_type k, size_type i)
+   {
+      size_type count = blocks_[k].size - i;
+      add_block(k + 1, (block_ - count) / 2);
+      pin_scope pin(*this);
+      value_type* from = pin(k, access::read);
+      value_type* to = pin(k + 1, access::fresh);
+      copy(to + blocks_[k + 1].begin, from + blocks_[k].begin + i, count);
+      blocks_[k].size = i;
+      blocks_[k + 1].size = count;
+      blocks_[k + 1].start = blocks_[k].start + difference_type(i);
+   }
+   //    room for n <= block_ / 2 elements at i of full block k: a
+   //    neighbour with room takes the far side, else k splits
+   void make_room(size_type k, size_type i, size_type n)
+   {
+      size_type size = blocks_[k].size;
+      size_type need = size + n - block_;
+      if(k + 1 < blocks_.size())
+      {
+         size_type room = block_ - blocks_[k + 1].size;
+         size_type m = std::min(need + (room > need ? (room - need) / 2 : 0), size - i);
+         if(room >= need && m >= need)
+         {
+            move_to_next(k, m);
+            return;
+         }
+      }
+      if(k > 0)
+      {
+         size_type room = block_ - blocks_[k - 1].size;
+         size_type m = std::min(need + (room > need ? (room - need) / 2 : 0), i);
+         if(room >= need && m >= need)
+         {
+            move_to_prev(k, m);
+            return;
+         }
+      }
+      split(k, size / 2);
+   }
+   //    a block under a quarter full goes into a neighbour
+   //    that stays under three quarters
+   void merge(size_type k)
+   {
+      size_type size = blocks_[k].size;
+      if(size >= block_ / 4) return;
+      if(k + 1 < blocks_.size() && size + blocks_[k + 1].size <= block_ / 4 * 3)
+         move_to_next(k, size);
+      else if(k > 0 && size + blocks_[k - 1].size <= block_ / 4 * 3)
+         move_to_prev(k, size);
+      else return;
+      remove_block(k);
+   }
+   //    n <= block_ elements from src at pos
+   void insert_block(size_type pos, const value_type* src, size_type n)
+   {
+      size_type k = 0;
+      size_type i = 0;
+      if(blocks_.empty()) add_block(0, (block_ - n) / 2);
+      else if(pos == size_)
+      {
+         k = blocks_.size() - 1;
+         i = blocks_[k].size;
+      }
+      else
+      {
+         k = locate(pos);
+         i = pos - position(k);
+      }
+      //    on a boundary the block before takes it if it can
+      if(i == 0 && k > 0 && blocks_[k - 1].size + n <= block_)
+      {
+         k--;
+         i = blocks_[k].size;
+      }
+      if(blocks_[k].size + n > block_)
+      {
+         if(n <= block_ / 2)
+         {
+            make_room(k, i, n);
+            insert_block(pos, src, n);
+            return;
+         }
+         //    a new block of its own, between the halves of k
+         if(i > 0 && i < blocks_[k].size) split(k, i);
+         if(i > 0) k++;
+         add_block(k, (block_ - n) / 2);
+         i = 0;
+      }
+      pin_scope pin(*this);
+      block& b = blocks_[k];
+      value_type* p = pin(k, b.size ? access::write : access::fresh);
+      open_gap(b, p, i, n);
+      copy(p + b.begin + i, src, n);
+      b.size += n;
+      size_ += n;
+      shift_starts(k, difference_type(n));
+   }
+
+
+   public:
+   //    cache_bytes of memory for blocks of block_bytes each, the
+   //    scratch file goes to directory ($TMPDIR or /tmp by default)
+   explicit sda_external(size_type cache_bytes = size_type(64) << 20, size_type block_bytes = size_type(64) << 10,
+      const char* directory = nullptr, bool background_io = true, const Allocator& alloc = Allocator())
+   : alloc_(alloc)
+   {
+      block_ = std::max<size_type>(1, block_bytes / sizeof(value_type));
+      block_bytes_ = block_ * sizeof(value_type);
+      frame_limit_ = std::max(min_frames, cache_bytes / block_bytes_);
+      prefetch_depth_ = std::max<size_type>(1, std::min<size_type>(8, frame_limit_ / 8));
+      frames_.reset(new frame[frame_limit_]);
+      fd_ = open_scratch(directory);
+      if(background_io)
+      {
+         //    no thread: synchronous I/O
+         try
+         {
+            io_ = std::thread([this] { io_loop(); });
+         }
+         catch(const std::system_error&) {}
+      }
+   }
+   sda_external(const sda_external&) = delete;
+   sda_external& operator= (const sda_external&) = delete;
+   ~sda_external()
+   {
+      if(io_.joinable())
+      {
+         {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+         }
+         work_.notify_all();
+         io_.join();
+      }
+      for(size_type f = 0; f < frame_count_; f++) alloc_trait::deallocate(alloc_, frames_[f].data, block_);
+      close(fd_);
+   }
+
+   //------------------
+   //    CAPACITY
+   //------------------
+   size_type size() const noexcept
+   {
+      return size_;
+   }
+   bool empty() const noexcept
+   {
+      return size_ == 0;
+   }
+   //    elements per block
+   size_type block_size() const noexcept
+   {
+      return block_;
+   }
+   size_type block_count() const noexcept
+   {
+      return blocks_.size();
+   }
+   size_type cache_bytes() const noexcept
+   {
+      return frame_limit_ * block_bytes_;
+   }
+   //    new cache limit, at least four blocks; dirty blocks
+   //    are written first
+   void set_cache_bytes(size_type bytes)
+   {
+      size_type limit = std::max(min_frames, bytes / block_bytes_);
+      flush();
+      while(frame_count_ > limit)
+      {
+         size_type f = --frame_count_;
+         if(frames_[f].slot != none) release(f);
+         else spare_.erase(std::find(spare_.begin(), spare_.end(), f));
+         alloc_trait::deallocate(alloc_, frames_[f].data, block_);
+      }
+      std::unique_ptr<frame[]> frames(new frame[limit]);
+      for(size_type f = 0; f < frame_count_; f++)
+      {
+         frames[f].data = frames_[f].data;
+         frames[f].slot = frames_[f].slot;
+         frames[f].state.store(frames_[f].state.load(std::memory_order_relaxed), std::memory_order_relaxed);
+         frames[f].prev = frames_[f].prev;
+         frames[f].next = frames_[f].next;
+      }
+      {
+         std::lock_guard<std::mutex> lock(mutex_);
+         frames_.swap(frames);
+      }
+      frame_limit_ = limit;
+      prefetch_depth_ = std::max<size_type>(1, std::min<size_type>(8, frame_limit_ / 8));
+      stats_.capped = false;
+   }
+   statistics stats() const noexcept
+   {
+      statistics s = stats_;
+      s.reads = reads_.load(std::memory_order_relaxed);
+      s.writes = writes_.load(std::memory_order_relaxed);
+      s.frames = frame_count_;
+      return s;
+   }
+   //    write every dirty block, wait for the I/O thread
+   void flush()
+   {
+      for(size_type f = head_; f != none; f = frames_[f].next)
+      {
+         frame& x = frames_[f];
+         if(x.state.load(std::memory_order_acquire) != dirty) continue;
+         if(io_.joinable()) enqueue(f, queued);
+         else if(transfer(true, x.slot, x.data)) x.state.store(clean, std::memory_order_relaxed);
+         else throw_errno(errno, "sda_external: write");
+      }
+      if(!io_.joinable()) return;
+      std::unique_lock<std::mutex> lock(mutex_);
+      done_.wait(lock, [this] { return (queue_.empty() && !in_flight_) || io_error_; });
+      check_io();
+   }
+
+   //------------------
+   //    ELEMENT ACCESS
+   //------------------
+   //    copies: elements live in the cache only while it holds them
+   value_type operator[](size_type pos)
+   {
+      size_type k = locate(pos);
+      size_type f = block_frame(k, access::read);
+      return frames_[f].data[blocks_[k].begin + pos - position(k)];
+   }
+   value_type at(size_type pos)
+   {
+      if(pos >= size_) throw std::out_of_range("sda_external::at");
+      return (*this)[pos];
+   }
+   value_type front()
+   {
+      return (*this)[0];
+   }
+   value_type back()
+   {
+      return (*this)[size_ - 1];
+   }
+   void set(size_type pos, const value_type& val)
+   {
+      size_type k = locate(pos);
+      size_type f = block_frame(k, access::write);
+      frames_[f].data[blocks_[k].begin + pos - position(k)] = val;
+   }
+   //    f(const value_type&) over [first, last), one block at a time;
+   //    f must not change the array
+   template<class F>
+   void for_each(size_type first, size_type last, F f)
+   {
+      while(first < last)
+      {
+         size_type k = locate(first);
+         size_type i = first - position(k);
+         size_type count = std::min(last - first, blocks_[k].size - i);
+         pin_scope pin(*this);
+         const value_type* p = pin(k, access::read) + blocks_[k].begin + i;
+         for(size_type j = 0; j < count; j++) f(p[j]);
+         first += count;
+      }
+   }
+   template<class F>
+   void for_each(F f)
+   {
+      for_each(0, size_, f);
+   }
+   //    from last - 1 down to first
+   template<class F>
+   void for_each_reverse(size_type first, size_type last, F f)
+   {
+      while(last > first)
+      {
+         size_type k = locate(last - 1);
+         size_type start = position(k);
+         size_type low = std::max(first, start);
+         pin_scope pin(*this);
+         const value_type* p = pin(k, access::read) + blocks_[k].begin;
+         for(size_type j = last; j > low; j--) f(p[j - 1 - start]);
+         last = low;
+      }
+   }
+   template<class F>
+   void for_each_reverse(F f)
+   {
+      for_each_reverse(0, size_, f);
+   }
+
+   //------------------
+   //    ITERATORS
+   //------------------
+   //    reads through the cache, dereferencing gives a copy
+   class const_iterator
+   {
+      friend class sda_external;
+      sda_external* a_ = nullptr;
+      size_type pos_ = 0;
+      const_iterator(sda_external* a, size_type pos) noexcept : a_(a), pos_(pos) {}
+
+      public:
+      typedef std::random_access_iterator_tag iterator_category;
+      typedef T value_type;
+      typedef std::ptrdiff_t difference_type;
+      typedef const T* pointer;
+      typedef T reference;
+
+      const_iterator() = default;
+      size_type position() const noexcept { return pos_; }
+      T operator*() const { return (*a_)[pos_]; }
+      T operator[](difference_type n) const { return (*a_)[pos_ + n]; }
+      const_iterator& operator++ () noexcept { ++pos_; return *this; }
+      const_iterator& operator-- () noexcept { --pos_; return *this; }
+      const_iterator operator++ (int) noexcept { const_iterator it = *this; ++pos_; return it; }
+      const_iterator operator-- (int) noexcept { const_iterator it = *this; --pos_; return it; }
+      const_iterator& operator+= (difference_type n) noexcept { pos_ += n; return *this; }
+      const_iterator& operator-= (difference_type n) noexcept { pos_ -= n; return *this; }
+      const_iterator operator+ (difference_type n) const noexcept { return const_iterator(a_, pos_ + n); }
+      const_iterator operator- (difference_type n) const noexcept { return const_iterator(a_, pos_ - n); }
+      friend const_iterator operator+ (difference_type n, const const_iterator& it) noexcept { return it + n; }
+      difference_type operator- (const const_iterator& it) const noexcept { return difference_type(pos_ - it.pos_); }
+      bool operator== (const const_iterator& it) const noexcept { return pos_ == it.pos_; }
+      bool operator!= (const const_iterator& it) const noexcept { return pos_ != it.pos_; }
+      bool operator< (const const_iterator& it) const noexcept { return pos_ < it.pos_; }
+      bool operator> (const const_iterator& it) const noexcept { return pos_ > it.pos_; }
+      bool operator<= (const const_iterator& it) const noexcept { return pos_ <= it.pos_; }
+      bool operator>= (const const_iterator& it) const noexcept { return pos_ >= it.pos_; }
+   };
+   const_iterator begin() noexcept
+   {
+      return const_iterator(this, 0);
+   }
+   const_iterator end() noexcept
+   {
+      return const_iterator(this, size_);
+   }
+   const_reverse_iterator rbegin() noexcept
+   {
+      return const_reverse_iterator(end());
+   }
+   const_reverse_iterator rend() noexcept
+   {
+      return const_reverse_iterator(begin());
+   }
+
+   //------------------
+   //    MODIFIERS
+   //------------------
+   void push_back(const value_type& val)
+   {
+      value_type v = val;
+      if(blocks_.empty() || blocks_.back().size == block_) add_block(blocks_.size(), 0);
+      size_type k = blocks_.size() - 1;
+      pin_scope pin(*this);
+      block& b = blocks_[k];
+      value_type* p = pin(k, b.size ? access::write : access::fresh);
+      if(b.begin + b.size == block_)
+      {
+         slide(p, b.begin, 0, b.size);
+         b.begin = 0;
+      }
+      p[b.begin + b.size] = v;
+      b.size++;
+      size_++;
+   }
+   void push_front(const value_type& val)
+   {
+      value_type v = val;
+      if(blocks_.empty() || blocks_.front().size == block_) add_block(0, block_);
+      pin_scope pin(*this);
+      block& b = blocks_.front();
+      value_type* p = pin(0, b.size ? access::write : access::fresh);
+      if(b.begin == 0)
+      {
+         slide(p, 0, block_ - b.size, b.size);
+         b.begin = block_ - b.size;
+      }
+      p[--b.begin] = v;
+      b.size++;
+      b.start--;
+      size_++;
+   }
+   //    the edge block is not read
+   void pop_back()
+   {
+      size_--;
+      if(--blocks_.back().size == 0) remove_block(blocks_.size() - 1);
+   }
+   void pop_front()
+   {
+      size_--;
+      block& b = blocks_.front();
+      b.begin++;
+      b.start++;
+      if(--b.size == 0) remove_block(0);
+   }
+   void insert(size_type pos, const value_type& val)
+   {
+      value_type v = val;
+      insert_block(pos, &v, 1);
+   }
+   void insert(size_type pos, size_type n, const value_type& val)
+   {
+      sda<value_type> chunk(std::min(n, block_), val);
+      for(; n; )
+      {
+         size_type count = std::min(n, block_);
+         insert_block(pos, chunk.data(), count);
+         pos += count;
+         n -= count;
+      }
+   }
+   template<class InputIterator, class = typename std::enable_if<!std::is_integral<InputIterator>::value>::type>
+   void insert(size_type pos, InputIterator first, InputIterator last)
+   {
+      sda<value_type> chunk;
+      chunk.reserve(block_);
+      while(first != last)
+      {
+         chunk.clear();
+         for(; first != last && chunk.size() < block_; ++first) chunk.push_back(*first);
+         insert_block(pos, chunk.data(), chunk.size());
+         pos += chunk.size();
+      }
+   }
+   void erase(size_type pos, size_type n = 1)
+   {
+      while(n)
+      {
+         size_type k = locate(pos);
+         size_type i = pos - position(k);
+         block& b = blocks_[k];
+         size_type count = std::min(n, b.size - i);
+         if(count == b.size) b.size = 0;
+         else if(i == 0)
+         {
+            b.begin += count;
+            b.size -= count;
+         }
+         else if(i + count == b.size) b.size -= count;
+         else
+         {
+            pin_scope pin(*this);
+            value_type* p = pin(k, access::write);
+            //    the shorter side closes the gap
+            if(i < b.size - i - count)
+            {
+               slide(p, b.begin, b.begin + count, i);
+               b.begin += count;
+            }
+            else slide(p, b.begin + i + count, b.begin + i, b.size - i - count);
+            b.size -= count;
+         }
+         shift_starts(k, -difference_type(count));
+         if(!b.size) remove_block(k);
+         size_ -= count;
+         n -= count;
+      }
+      if(size_ == 0) return;
+      merge(locate(std::min(pos, size_ - 1)));
+      if(pos > 0 && pos <= size_) merge(locate(pos - 1));
+   }
+   //    drops every block, the file shrinks to nothing
+   void clear()
+   {
+      drain();
+      while(head_ != none)
+      {
+         size_type f = head_;
+         release(f);
+         spare_.push_back(f);
+      }
+      blocks_.clear();
+      where_.clear();
+      free_slots_.clear();
+      size_ = 0;
+      memo_ = 0;
+      last_block_ = none;
+      if(ftruncate(fd_, 0) != 0) throw_errno(errno, "sda_external: ftruncate");
+   }
+};
+
+
+
+#endif
@@ -0,0 +1,315 @@
+/*
+MIT License
+
+Copyright 2020 Than Minh Duy (macodeth)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+OR OTHER DEALINGS IN THE SOFTWARE.
+
+*/
+
+
+#ifndef SYMMETRIC_DYNAMIC_ARRAY_HANDLES
+#define SYMMETRIC_DYNAMIC_ARRAY_HANDLES
+
+
+
+#include<cstddef>
+#include<cstdint>
+#include<initializer_list>
+#include<memory>
+#include<stdexcept>
+#include<utility>
+
+#include "sda.h"
+
+
+
+//
+//    stable handles to elements of an sda
+//
+//    every element has a handle, the table keeps a key per handle:
+//
+//       position(h) = key_[h] - origin_
+//
+//    only the elements sda actually shifts get a new key:
+//
+//       insert n at p, front side moves [0, p) : key -= n, origin_ -= n
+//       insert n at p, back side moves [p, end) : key += n
+//       erase works the other way round
+//
+//    so keeping the table right costs as much as the shift itself,
+//    reallocation changes nothing, lookup is O(1)
+//
+//    slots of erased elements are reused, a handle carries the
+//    generation of its slot (high 32 bits) so a stale handle
+//    is told apart from the new element in the same slot:
+//
+//       handle = generation << 32 | slot
+//
+
+
+template<class T, class Allocator = std::allocator<T>>
+class sda_handles
+{
+   public:
+   typedef sda<T, Allocator> array_type;
+   typedef typename array_type::allocator_type allocator_type;
+   typedef typename array_type::value_type value_type;
+   typedef typename array_type::size_type size_type;
+   typedef typename array_type::reference reference;
+   typedef typename array_type::const_reference const_reference;
+   typedef typename array_type::iterator iterator;
+   typedef typename array_type::const_iterator const_iterator;
+   typedef std::uint64_t handle;
+
+   static constexpr handle npos = ~handle(0);
+
+
+   private:
+   typedef std::ptrdiff_t key_type;
+
+   array_type values_;
+   sda<handle> handles_;         // handle of each element, same order
+   sda<key_type> keys_;          // key of each slot
+   sda<std::uint32_t> gens_;     // generation of each slot
+   sda<std::uint32_t> free_;     // slots of erased elements
+   key_type origin_ = 0;
+
+
+   static std::uint32_t slot(handle h) noexcept
+   {
+      return std::uint32_t(h);
+   }
+   static std::uint32_t generation(handle h) noexcept
+   {
+      return std::uint32_t(h >> 32);
+   }
+   //    add [0, last) or [first, size()) to their keys
+   void shift_keys(size_type first, size_type last, key_type delta)
+   {
+      for(size_type i = first; i < last; i++) keys_[slot(handles_[i])] += delta;
+   }
+   handle new_handle(size_type pos)
+   {
+      std::uint32_t s;
+      if(free_.empty())
+      {
+         s = std::uint32_t(keys_.size());
+         keys_.push_back(0);
+         gens_.push_back(0);
+      }
+      else
+      {
+         s = free_.back();
+         free_.pop_back();
+      }
+      keys_[s] = key_type(pos) + origin_;
+      return handle(gens_[s]) << 32 | s;
+   }
+   //    make room for n keys at pos, on the side values_ shifts
+   void open(size_type pos, size_type n, bool back)
+   {
+      if(back) shift_keys(pos, handles_.size(), key_type(n));
+      else
+      {
+         shift_keys(0, pos, -key_type(n));
+         origin_ -= key_type(n);
+      }
+   }
+
+
+   public:
+   sda_handles() = default;
+
+   sda_handles(std::initializer_list<value_type> il)
+   {
+      for(const value_type& val : il) push_back(val);
+   }
+
+   //------------------
+   //    CAPACITY
+   //------------------
+   size_type size() const noexcept
+   {
+      return values_.size();
+   }
+   bool empty() const noexcept
+   {
+      return values_.empty();
+   }
+   void reserve(size_type n)
+   {
+      values_.reserve(n);
+      handles_.reserve(n);
+      keys_.reserve_back(n);
+      gens_.reserve_back(n);
+   }
+   //    slots are kept so handles from before stay stale
+   void clear()
+   {
+      values_.clear();
+      handles_.clear();
+      free_.clear();
+      for(size_type s = gens_.size(); s-- > 0; )
+      {
+         gens_[s]++;
+         free_.push_back(std::uint32_t(s));
+      }
+      origin_ = 0;
+   }
+
+   //------------------------------------
+   //    ACCESS
+   //    by position or by handle, O(1)
+   //    get, position : h must be live
+   //    at : throws on a stale handle
+   //------------------------------------
+   reference operator[] (size_type n)
+   {
+      return values_[n];
+   }
+   const_reference operator[] (size_type n) const
+   {
+      return values_[n];
+   }
+   reference get(handle h)
+   {
+      return values_[position(h)];
+   }
+   const_reference get(handle h) const
+   {
+      return values_[position(h)];
+   }
+   reference at(handle h)
+   {
+      if(!contains(h)) throw std::out_of_range("std::out_of_range");
+      return get(h);
+   }
+   const_reference at(handle h) const
+   {
+      if(!contains(h)) throw std::out_of_range("std::out_of_range");
+      return get(h);
+   }
+   size_type position(handle h) const noexcept
+   {
+      return size_type(keys_[slot(h)] - origin_);
+   }
+   //    h was returned by insert and its element is not erased
+   bool contains(handle h) const noexcept
+   {
+      return slot(h) < gens_.size() && gens_[slot(h)] == generation(h);
+   }
+   handle handle_at(size_type pos) const noexcept
+   {
+      return handles_[pos];
+   }
+   iterator begin() noexcept
+   {
+      return values_.begin();
+   }
+   iterator end() noexcept
+   {
+      return values_.end();
+   }
+   const_iterator begin() const noexcept
+   {
+      return values_.begin();
+   }
+   const_iterator end() const noexcept
+   {
+      return values_.end();
+   }
+   const array_type& array() const noexcept
+   {
+      return values_;
+   }
+
+   //---------------------------------------
+   //    INSERT, EMPLACE
+   //    the handle of the new element
+   //---------------------------------------
+   template<class... Args>
+   handle emplace(size_type pos, Args&&... args)
+   {
+      bool back = values_.insert_at_back(pos, 1);
+      values_.emplace(values_.begin() + pos, std::forward<Args>(args)...);
+      open(pos, 1, back);
+      handle h = new_handle(pos);
+      handles_.insert(handles_.begin() + pos, h);
+      return h;
+   }
+   handle insert(size_type pos, const value_type& val)
+   {
+      return emplace(pos, val);
+   }
+   handle insert(size_type pos, value_type&& val)
+   {
+      return emplace(pos, std::move(val));
+   }
+   handle push_back(const value_type& val)
+   {
+      return emplace(size(), val);
+   }
+   handle push_front(const value_type& val)
+   {
+      return emplace(0, val);
+   }
+
+   //---------------------------------------
+   //    ERASE
+   //---------------------------------------
+   void erase(size_type first, size_type last)
+   {
+      size_type n = last - first;
+      bool back = first > size() - last;
+      for(size_type i = first; i < last; i++)
+      {
+         gens_[slot(handles_[i])]++;
+         free_.push_back(slot(handles_[i]));
+      }
+      if(back) shift_keys(last, size(), -key_type(n));
+      else
+      {
+         shift_keys(0, first, key_type(n));
+         origin_ += key_type(n);
+      }
+      values_.erase(values_.begin() + first, values_.begin() + last);
+      handles_.erase(handles_.begin() + first, handles_.begin() + last);
+   }
+   void erase(size_type pos)
+   {
+      erase(pos, pos + 1);
+   }
+   void erase_handle(handle h)
+   {
+      size_type pos = position(h);
+      erase(pos, pos + 1);
+   }
+   void pop_back()
+   {
+      erase(size() - 1);
+   }
+   void pop_front()
+   {
+      erase(0);
+   }
+};
+
+
+#endif
@@ -0,0 +1,417 @@
+/*
+MIT License
+
+Copyright 2020 Than Minh Duy (macodeth)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+OR OTHER DEALINGS IN THE SOFTWARE.
+
+*/
+
+
+#ifndef SYMMETRIC_DYNAMIC_ARRAY_INCREMENTAL
+#define SYMMETRIC_DYNAMIC_ARRAY_INCREMENTAL
+
+
+
+#include<algorithm>
+#include<cstddef>
+#include<initializer_list>
+#include<iterator>
+#include<memory>
+#include<stdexcept>
+#include<type_traits>
+#include<utility>
+
+#include "sda.h"
+
+
+
+//
+//    growth without a stop: when a large array runs out of back
+//    (front) capacity, the new block is allocated with room for
+//    the old elements in front of (behind) the new end, the old
+//    block stays alive and every following operation moves
+//    step elements across
+//
+//       growing back :   old_ : 1 2 3 4 5 6 [7 8]   (7 8 already moved)
+//                        cur_ : # # # # # # 7 8 9 10 # # # # # #
+//
+//       growing front:   cur_ : # # # # # # -2 -1 1 2 # # # # # #
+//                        old_ : [1 2] 3 4 5 6 7 8
+//
+//    the sequence is old_ + cur_ (growing back) or cur_ + old_
+//    (growing front) until old_ is empty
+//
+//    insert and erase edit the block holding the position, a
+//    position on the boundary goes to cur_; a push at the old end
+//    goes to old_ and finishes the move first only when old_ has
+//    no room there: the element has to follow every element still
+//    in old_, and growing old_ would cost what the move costs
+//
+
+
+template<class T, class Allocator = std::allocator<T>>
+class sda_incremental
+{
+   public:
+   typedef sda<T, Allocator> array_type;
+   typedef typename array_type::allocator_type allocator_type;
+   typedef typename array_type::value_type value_type;
+   typedef typename array_type::size_type size_type;
+   typedef typename array_type::difference_type difference_type;
+   typedef typename array_type::reference reference;
+   typedef typename array_type::const_reference const_reference;
+
+   //    arrays below min_size grow the usual way
+   static constexpr size_type default_step = 64;
+   static constexpr size_type default_min_size = 4096;
+
+
+   private:
+   array_type cur_;
+   array_type old_;
+   bool old_front_ = true;      // old_ holds the front of the sequence
+   size_type step_ = default_step;
+   size_type min_size_ = default_min_size;
+
+
+   bool moving() const noexcept
+   {
+      return !old_.empty();
+   }
+   //    move up to n elements from old_ to cur_
+   void migrate(size_type n)
+   {
+      if(old_front_)
+         for(; n && !old_.empty(); n--)
+         {
+            cur_.push_front(std::move(old_.back()));
+            old_.pop_back();
+         }
+      else
+         for(; n && !old_.empty(); n--)
+         {
+            cur_.push_back(std::move(old_.front()));
+            old_.pop_front();
+         }
+      release();
+   }
+   //    drop the old block once it is empty
+   void release()
+   {
+      if(old_.empty() && old_.capacity()) array_type(old_.get_allocator()).swap(old_);
+   }
+   void step()
+   {
+      if(moving()) migrate(step_);
+      else release();
+   }
+   void finish()
+   {
+      if(moving()) migrate(old_.size());
+   }
+
+   //    cur_ is full at one end: either grow it the usual way,
+   //    or make it old_ and start moving into a new block
+   void grow(bool back)
+   {
+      finish();
+      size_type n = cur_.size();
+      if(n < min_size_) return;
+      array_type next(cur_.get_allocator());
+      size_type room = n + (n >> 1) + 2;
+      //    one block, then the empty begin() is slid past the room
+      //    the old elements come to
+      next.reserve(n + room);
+      if(back) next.slide_to_front(n);
+      else next.slide_to_back(n);
+      old_.swap(cur_);
+      cur_.swap(next);
+      old_front_ = back;
+   }
+
+   //    the block before and the block after the boundary
+   array_type& head() noexcept
+   {
+      return old_front_ ? old_ : cur_;
+   }
+   array_type& tail() noexcept
+   {
+      return old_front_ ? cur_ : old_;
+   }
+
+   //    position i of the sequence
+   template<class Self>
+   static auto& at_index(Self& self, size_type i)
+   {
+      size_type first = self.old_front_ ? self.old_.size() : self.cur_.size();
+      if(self.old_front_)
+         return i < first ? self.old_[i] : self.cur_[i - first];
+      return i < first ? self.cur_[i] : self.old_[i - first];
+   }
+
+
+   public:
+   //    random access by position, invalidated by any push or pop
+   template<bool Const>
+   class iterator_base
+   {
+      typedef typename std::conditional<Const, const sda_incremental, sda_incremental>::type owner;
+      owner* a_ = nullptr;
+      size_type i_ = 0;
+      friend class sda_incremental;
+      template<bool> friend class iterator_base;
+      iterator_base(owner* a, size_type i) noexcept : a_(a), i_(i) {}
+
+      public:
+      typedef std::random_access_iterator_tag iterator_category;
+      typedef typename sda_incremental::value_type value_type;
+      typedef typename sda_incremental::difference_type difference_type;
+      typedef typename std::conditional<Const, const value_type*, value_type*>::type pointer;
+      typedef typename std::conditional<Const, const value_type&, value_type&>::type reference;
+
+      iterator_base() = default;
+      operator iterator_base<true>() const noexcept { return iterator_base<true>(a_, i_); }
+
+      reference operator*() const { return (*a_)[i_]; }
+      pointer operator->() const { return &(*a_)[i_]; }
+      reference operator[](difference_type n) const { return (*a_)[i_ + n]; }
+      iterator_base& operator++() noexcept { i_++; return *this; }
+      iterator_base& operator--() noexcept { i_--; return *this; }
+      iterator_base operator++(int) noexcept { iterator_base t = *this; i_++; return t; }
+      iterator_base operator--(int) noexcept { iterator_base t = *this; i_--; return t; }
+      iterator_base& operator+=(difference_type n) noexcept { i_ += n; return *this; }
+      iterator_base& operator-=(difference_type n) noexcept { i_ -= n; return *this; }
+      iterator_base operator+(difference_type n) const noexcept { return iterator_base(a_, i_ + n); }
+      iterator_base operator-(difference_type n) const noexcept { return iterator_base(a_, i_ - n); }
+      friend iterator_base operator+(difference_type n, const iterator_base& it) noexcept { return it + n; }
+      difference_type operator-(const iterator_base& o) const noexcept { return difference_type(i_) - difference_type(o.i_); }
+      bool operator==(const iterator_base& o) const noexcept { return i_ == o.i_; }
+      bool operator!=(const iterator_base& o) const noexcept { return i_ != o.i_; }
+      bool operator<(const iterator_base& o) const noexcept { return i_ < o.i_; }
+      bool operator>(const iterator_base& o) const noexcept { return i_ > o.i_; }
+      bool operator<=(const iterator_base& o) const noexcept { return i_ <= o.i_; }
+      bool operator>=(const iterator_base& o) const noexcept { return i_ >= o.i_; }
+   };
+   typedef iterator_base<false> iterator;
+   typedef iterator_base<true> const_iterator;
+
+
+   sda_incremental() = default;
+
+   explicit sda_incremental(size_type step, size_type min_size = default_min_size)
+   : step_(step ? step : 1), min_size_(min_size) {}
+
+   sda_incremental(std::initializer_list<value_type> il) : cur_(il) {}
+
+   //------------------
+   //    CAPACITY
+   //------------------
+   size_type size() const noexcept
+   {
+      return cur_.size() + old_.size();
+   }
+   bool empty() const noexcept
+   {
+      return cur_.empty() && old_.empty();
+   }
+   //    elements still waiting in the old block
+   size_type pending() const noexcept
+   {
+      return old_.size();
+   }
+   //    while moving, cur_ keeps room for the pending elements at
+   //    their end, old_ is left alone
+   void reserve(size_type n)
+   {
+      if(n <= cur_.capacity()) return;
+      cur_.reserve(std::max(n, size()));
+      if(old_front_ && cur_.empty_front_capacity() < old_.size()) cur_.slide_to_front(old_.size());
+      if(!old_front_ && cur_.empty_back_capacity() < old_.size()) cur_.slide_to_back(old_.size());
+   }
+   void clear() noexcept
+   {
+      cur_.clear();
+      array_type(old_.get_allocator()).swap(old_);
+   }
+
+   //------------------
+   //    ACCESS
+   //------------------
+   reference operator[] (size_type n)
+   {
+      return at_index(*this, n);
+   }
+   const_reference operator[] (size_type n) const
+   {
+      return at_index(*this, n);
+   }
+   reference at(size_type n)
+   {
+      if(n >= size()) throw std::out_of_range("std::out_of_range");
+      return at_index(*this, n);
+   }
+   const_reference at(size_type n) const
+   {
+      if(n >= size()) throw std::out_of_range("std::out_of_range");
+      return at_index(*this, n);
+   }
+   reference front()
+   {
+      return at_index(*this, 0);
+   }
+   const_reference front() const
+   {
+      return at_index(*this, 0);
+   }
+   reference back()
+   {
+      return at_index(*this, size() - 1);
+   }
+   const_reference back() const
+   {
+      return at_index(*this, size() - 1);
+   }
+   iterator begin() noexcept
+   {
+      return iterator(this, 0);
+   }
+   iterator end() noexcept
+   {
+      return iterator(this, size());
+   }
+   const_iterator begin() const noexcept
+   {
+      return const_iterator(this, 0);
+   }
+   const_iterator end() const noexcept
+   {
+      return const_iterator(this, size());
+   }
+
+   //    finishes moving, then gives the single block
+   array_type& array()
+   {
+      finish();
+      return cur_;
+   }
+
+   //------------------
+   //    PUSH, POP
+   //------------------
+   template<class... Args>
+   void emplace_back(Args&&... args)
+   {
+      if(moving() && !old_front_)
+      {
+         if(old_.empty_back_capacity())
+         {
+            old_.emplace_back(std::forward<Args>(args)...);
+            step();
+            return;
+         }
+         finish();
+      }
+      if(cur_.empty_back_capacity() == 0) grow(true);
+      cur_.emplace_back(std::forward<Args>(args)...);
+      step();
+   }
+   template<class... Args>
+   void emplace_front(Args&&... args)
+   {
+      if(moving() && old_front_)
+      {
+         if(old_.empty_front_capacity())
+         {
+            old_.emplace_front(std::forward<Args>(args)...);
+            step();
+            return;
+         }
+         finish();
+      }
+      if(cur_.empty_front_capacity() == 0) grow(false);
+      cur_.emplace_front(std::forward<Args>(args)...);
+      step();
+   }
+   void push_back(const value_type& val)
+   {
+      emplace_back(val);
+   }
+   void push_back(value_type&& val)
+   {
+      emplace_back(std::move(val));
+   }
+   void push_front(const value_type& val)
+   {
+      emplace_front(val);
+   }
+   void push_front(value_type&& val)
+   {
+      emplace_front(std::move(val));
+   }
+   void pop_back()
+   {
+      if(moving() && (cur_.empty() || !old_front_)) old_.pop_back();
+      else cur_.pop_back();
+      step();
+   }
+   void pop_front()
+   {
+      if(moving() && (cur_.empty() || old_front_)) old_.pop_front();
+      else cur_.pop_front();
+      step();
+   }
+
+   //------------------------------------
+   //    INSERT, ERASE
+   //    in the block holding the position,
+   //    the move goes on one step
+   //------------------------------------
+   template<class... Args>
+   void emplace(size_type pos, Args&&... args)
+   {
+      size_type boundary = head().size();
+      if(old_front_ ? pos < boundary : pos <= boundary)
+         head().emplace(head().begin() + pos, std::forward<Args>(args)...);
+      else
+         tail().emplace(tail().begin() + (pos - boundary), std::forward<Args>(args)...);
+      step();
+   }
+   void insert(size_type pos, const value_type& val)
+   {
+      emplace(pos, val);
+   }
+   void erase(size_type pos)
+   {
+      erase(pos, pos + 1);
+   }
+   void erase(size_type first, size_type last)
+   {
+      //    the tail part first, it leaves the head positions alone
+      size_type boundary = head().size();
+      if(last > boundary)
+         tail().erase(tail().begin() + (std::max(first, boundary) - boundary), tail().begin() + (last - boundary));
+      if(first < boundary)
+         head().erase(head().begin() + first, head().begin() + std::min(last, boundary));
+      step();
+   }
+};
+
+
+#endif
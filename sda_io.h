@@ -0,0 +1,236 @@
+/*
+MIT License
+
+Copyright 2020 Than Minh Duy (macodeth)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+OR OTHER DEALINGS IN THE SOFTWARE.
+
+*/
+
+
+#ifndef SYMMETRIC_DYNAMIC_ARRAY_IO
+#define SYMMETRIC_DYNAMIC_ARRAY_IO
+
+
+
+#include<cerrno>
+#include<cstring>
+#include<type_traits>
+
+#include<sys/types.h>
+#include<sys/uio.h>
+#include<unistd.h>
+
+#include "sda.h"
+
+
+
+//
+//    POSIX file descriptor I/O straight from / into the empty
+//    capacity of a byte sda (sizeof(T) == 1), no temporary buffer
+//
+//    every function returns what the system call returned:
+//    bytes transferred, 0 at end of file, -1 with errno set;
+//    reads that are interrupted before any byte arrived are retried
+//
+
+
+namespace sda_io
+{
+   template<class T>
+   constexpr void require_bytes()
+   {
+      static_assert(sizeof(T) == 1 && std::is_trivially_copyable<T>::value,
+         "sda_io works on byte arrays (char, unsigned char, std::byte, ...)");
+   }
+
+
+   //    a read interrupted before any byte arrived has no effect
+   template<class F>
+   ssize_t retry(F f)
+   {
+      ssize_t r;
+      do r = f(); while(r < 0 && errno == EINTR);
+      return r;
+   }
+
+   //    one array twice would reserve twice: the second reservation
+   //    may reallocate under the span of the first
+   template<class Array, std::size_t N>
+   bool distinct(Array* const (&arrays)[N])
+   {
+      for(std::size_t i = 1; i < N; i++)
+         for(std::size_t j = 0; j < i; j++)
+            if(arrays[i] == arrays[j]) return false;
+      return true;
+   }
+
+   //    the front span has to end at begin(): a short read is moved
+   //    next to begin() before it is committed
+   template<class T, class Allocator, class Policy>
+   void commit_front(sda<T, Allocator, Policy>& a, T* span, std::size_t n, ssize_t r)
+   {
+      if(r <= 0) return;
+      std::size_t got = r;
+      if(got < n) std::memmove(span + (n - got), span, got);
+      a.commit_front(got);
+   }
+
+
+   //-------------------------------------------------
+   //    READ
+   //    read_back   : append up to n bytes
+   //    pread_back  : same, at offset, file position
+   //                  is not changed
+   //    read_front  : prepend up to n bytes
+   //    pread_front : same, at offset
+   //    readv_back  : scatter into the backs of several
+   //    readv_front : and into the fronts
+   //-------------------------------------------------
+   template<class T, class Allocator, class Policy>
+   ssize_t read_back(int fd, sda<T, Allocator, Policy>& a, std::size_t n)
+   {
+      require_bytes<T>();
+      auto spare = a.append_uninitialized(n);
+      ssize_t r = retry([&] { return ::read(fd, spare.data(), n); });
+      if(r > 0) a.commit_back(r);
+      return r;
+   }
+
+   template<class T, class Allocator, class Policy>
+   ssize_t pread_back(int fd, sda<T, Allocator, Policy>& a, std::size_t n, off_t offset)
+   {
+      require_bytes<T>();
+      auto spare = a.append_uninitialized(n);
+      ssize_t r = retry([&] { return ::pread(fd, spare.data(), n, offset); });
+      if(r > 0) a.commit_back(r);
+      return r;
+   }
+
+   //    one read like read_back, a short read costs a memmove of
+   //    the bytes that arrived
+   template<class T, class Allocator, class Policy>
+   ssize_t read_front(int fd, sda<T, Allocator, Policy>& a, std::size_t n)
+   {
+      require_bytes<T>();
+      auto spare = a.prepend_uninitialized(n);
+      ssize_t r = retry([&] { return ::read(fd, spare.data(), n); });
+      commit_front(a, spare.data(), n, r);
+      return r;
+   }
+
+   template<class T, class Allocator, class Policy>
+   ssize_t pread_front(int fd, sda<T, Allocator, Policy>& a, std::size_t n, off_t offset)
+   {
+      require_bytes<T>();
+      auto spare = a.prepend_uninitialized(n);
+      ssize_t r = retry([&] { return ::pread(fd, spare.data(), n, offset); });
+      commit_front(a, spare.data(), n, r);
+      return r;
+   }
+
+   //    scatter one readv into the back of several arrays,
+   //    e.g. readv_back(fd, {&header, &payload}, {16, 4096});
+   //    an array given twice fails with EINVAL
+   template<class Array, std::size_t N>
+   ssize_t readv_back(int fd, Array* const (&arrays)[N], const std::size_t (&sizes)[N])
+   {
+      require_bytes<typename Array::value_type>();
+      if(!distinct(arrays))
+      {
+         errno = EINVAL;
+         return -1;
+      }
+      iovec iov[N];
+      for(std::size_t i = 0; i < N; i++)
+      {
+         auto spare = arrays[i]->append_uninitialized(sizes[i]);
+         iov[i].iov_base = spare.data();
+         iov[i].iov_len = sizes[i];
+      }
+      ssize_t r = retry([&] { return ::readv(fd, iov, N); });
+      std::size_t left = r > 0 ? r : 0;
+      for(std::size_t i = 0; i < N && left; i++)
+      {
+         std::size_t k = left < sizes[i] ? left : sizes[i];
+         arrays[i]->commit_back(k);
+         left -= k;
+      }
+      return r;
+   }
+
+   //    the same into the front of each array, the first bytes go
+   //    to the first array
+   template<class Array, std::size_t N>
+   ssize_t readv_front(int fd, Array* const (&arrays)[N], const std::size_t (&sizes)[N])
+   {
+      require_bytes<typename Array::value_type>();
+      if(!distinct(arrays))
+      {
+         errno = EINVAL;
+         return -1;
+      }
+      iovec iov[N];
+      for(std::size_t i = 0; i < N; i++)
+      {
+         auto spare = arrays[i]->prepend_uninitialized(sizes[i]);
+         iov[i].iov_base = spare.data();
+         iov[i].iov_len = sizes[i];
+      }
+      ssize_t r = retry([&] { return ::readv(fd, iov, N); });
+      std::size_t left = r > 0 ? r : 0;
+      for(std::size_t i = 0; i < N && left; i++)
+      {
+         std::size_t k = left < sizes[i] ? left : sizes[i];
+         commit_front(*arrays[i], static_cast<typename Array::value_type*>(iov[i].iov_base), sizes[i], k);
+         left -= k;
+      }
+      return r;
+   }
+
+
+   //-------------------------------------------------
+   //    WRITE
+   //    write  : write data() once
+   //    writev : gather several arrays in one call
+   //-------------------------------------------------
+   template<class T, class Allocator, class Policy>
+   ssize_t write(int fd, const sda<T, Allocator, Policy>& a)
+   {
+      require_bytes<T>();
+      return ::write(fd, a.data(), a.size());
+   }
+
+   //    e.g. writev(fd, {&header, &payload})
+   template<class Array, std::size_t N>
+   ssize_t writev(int fd, const Array* const (&arrays)[N])
+   {
+      require_bytes<typename Array::value_type>();
+      iovec iov[N];
+      for(std::size_t i = 0; i < N; i++)
+      {
+         iov[i].iov_base = const_cast<typename Array::value_type*>(arrays[i]->data());
+         iov[i].iov_len = arrays[i]->size();
+      }
+      return ::writev(fd, iov, N);
+   }
+}
+
+
+#endif
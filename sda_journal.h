@@ -0,0 +1,612 @@
+/*
+MIT License
+
+Copyright 2020 Than Minh Duy (macodeth)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+OR OTHER DEALINGS IN THE SOFTWARE.
+
+*/
+
+
+#ifndef SYMMETRIC_DYNAMIC_ARRAY_JOURNAL
+#define SYMMETRIC_DYNAMIC_ARRAY_JOURNAL
+
+
+
+#include<cstddef>
+#include<cstdint>
+#include<cstring>
+#include<initializer_list>
+#include<memory>
+#include<stdexcept>
+#include<type_traits>
+#include<utility>
+
+#include "sda.h"
+
+
+
+//
+//    journal: every mutating call on an sda as a compact binary
+//    trace, to replay it offline (replay/sda_replay.cpp) or to
+//    bring a replica up to date
+//
+//       trace  : "SDAJ" version value_size record...
+//       record : op arguments values
+//
+//    arguments are LEB128 varints, values are value_size raw
+//    bytes each, written only for trivially copyable types
+//    (value_size 0 otherwise, replay uses value_type())
+//
+//    journaled_sda<T> is an sda that writes its own journal,
+//    element access is read only apart from set(pos, val) so
+//    that no change escapes the journal
+//
+
+
+enum class sda_op : unsigned char
+{
+   push_back = 1,       // value
+   push_front,          // value
+   pop_back,
+   pop_front,
+   insert,              // pos, n, n values
+   join,                // pos, n, n values
+   erase,               // first, n
+   reserve,             // n
+   reserve_front,       // n
+   reserve_back,        // n
+   slide_to_front,      // n
+   slide_to_back,       // n
+   resize_front,        // n, k, k values: the k new elements
+   resize_back,         // n, k, k values
+   shrink_to_fit,
+   clear,
+   set,                 // pos, value
+   last = set
+};
+
+
+
+//-----------------------
+//    WRITER
+//-----------------------
+class sda_journal
+{
+   sda<unsigned char> bytes_;
+   std::size_t value_size_ = 0;
+   std::size_t records_ = 0;
+
+   public:
+   static constexpr unsigned char version = 1;
+
+   explicit sda_journal(std::size_t value_size = 0)
+   {
+      reset(value_size);
+   }
+
+   //    drop every record, start a new trace
+   void reset(std::size_t value_size)
+   {
+      bytes_.clear();
+      bytes_.insert(bytes_.end(), {'S', 'D', 'A', 'J', version});
+      value_size_ = value_size;
+      records_ = 0;
+      put(value_size);
+   }
+   //    after shipping a batch: the next batch is a trace of its own
+   void clear()
+   {
+      reset(value_size_);
+   }
+   void op(sda_op code)
+   {
+      bytes_.push_back(static_cast<unsigned char>(code));
+      records_++;
+   }
+   void put(std::size_t n)
+   {
+      for(; n >= 0x80; n >>= 7) bytes_.push_back(static_cast<unsigned char>(n | 0x80));
+      bytes_.push_back(static_cast<unsigned char>(n));
+   }
+   //    count values of value_size bytes each
+   void values(const void* first, std::size_t count)
+   {
+      const unsigned char* p = static_cast<const unsigned char*>(first);
+      bytes_.insert(bytes_.end(), p, p + count * value_size_);
+   }
+
+   std::size_t value_size() const noexcept
+   {
+      return value_size_;
+   }
+   std::size_t records() const noexcept
+   {
+      return records_;
+   }
+   const unsigned char* data() const noexcept
+   {
+      return bytes_.data();
+   }
+   std::size_t size() const noexcept
+   {
+      return bytes_.size();
+   }
+};
+
+
+
+//-----------------------
+//    READER
+//-----------------------
+class sda_journal_reader
+{
+   const unsigned char* p_;
+   const unsigned char* end_;
+   std::size_t value_size_ = 0;
+
+   [[noreturn]] static void throw_bad_trace()
+   {
+      throw std::runtime_error("sda_journal: bad trace");
+   }
+   std::size_t get()
+   {
+      std::size_t n = 0;
+      for(unsigned shift = 0; ; shift += 7)
+      {
+         if(p_ == end_ || shift >= 64) throw_bad_trace();
+         unsigned char c = *p_++;
+         n |= std::size_t(c & 0x7F) << shift;
+         if(!(c & 0x80)) return n;
+      }
+   }
+   const unsigned char* take(std::size_t count)
+   {
+      if(value_size_ && count > std::size_t(end_ - p_) / value_size_) throw_bad_trace();
+      const unsigned char* v = p_;
+      p_ += count * value_size_;
+      return v;
+   }
+
+
+   public:
+   struct record
+   {
+      sda_op op;
+      std::size_t pos;                 // or n
+      std::size_t count;               // values in the record
+      const unsigned char* values;     // count * value_size bytes
+   };
+
+   sda_journal_reader(const void* data, std::size_t size)
+   : p_(static_cast<const unsigned char*>(data)), end_(p_ + size)
+   {
+      if(size < 5 || std::memcmp(p_, "SDAJ", 4) != 0 || p_[4] != sda_journal::version) throw_bad_trace();
+      p_ += 5;
+      value_size_ = get();
+   }
+   std::size_t value_size() const noexcept
+   {
+      return value_size_;
+   }
+
+   //    false at the end of the trace
+   bool next(record& r)
+   {
+      if(p_ == end_) return false;
+      unsigned char code = *p_++;
+      if(code == 0 || code > static_cast<unsigned char>(sda_op::last)) throw_bad_trace();
+      r.op = static_cast<sda_op>(code);
+      r.pos = r.count = 0;
+      switch(r.op)
+      {
+         case sda_op::push_back:
+         case sda_op::push_front:
+            r.count = 1;
+            break;
+         case sda_op::insert:
+         case sda_op::join:
+         case sda_op::erase:
+         case sda_op::resize_front:
+         case sda_op::resize_back:
+            r.pos = get();
+            r.count = get();
+            break;
+         case sda_op::reserve:
+         case sda_op::reserve_front:
+         case sda_op::reserve_back:
+         case sda_op::slide_to_front:
+         case sda_op::slide_to_back:
+            r.pos = get();
+            break;
+         case sda_op::set:
+            r.pos = get();
+            r.count = 1;
+            break;
+         default:
+            break;
+      }
+      r.values = r.op == sda_op::erase ? nullptr : take(r.count);
+      return true;
+   }
+
+   //    value i of a record
+   template<class T>
+   T value(const record& r, std::size_t i) const
+   {
+      if constexpr (std::is_trivially_copyable<T>::value)
+      {
+         if(value_size_ == sizeof(T))
+         {
+            T v;
+            std::memcpy(&v, r.values + i * sizeof(T), sizeof(T));
+            return v;
+         }
+      }
+      (void)r;
+      (void)i;
+      return T();
+   }
+
+   //    throws if r does not fit an array of size elements with room
+   //    empty slots: a corrupt trace must not write out of bounds
+   void check(const record& r, std::size_t size, std::size_t room = std::size_t(-1)) const
+   {
+      bool fits = true;
+      switch(r.op)
+      {
+         case sda_op::pop_back:
+         case sda_op::pop_front: fits = size > 0; break;
+         case sda_op::insert:
+         case sda_op::join: fits = r.pos <= size; break;
+         case sda_op::erase: fits = r.pos <= size && r.count <= size - r.pos; break;
+         case sda_op::set: fits = r.pos < size; break;
+         case sda_op::resize_front:
+         case sda_op::resize_back: fits = r.count <= r.pos; break;
+         case sda_op::slide_to_front:
+         case sda_op::slide_to_back: fits = r.pos <= room; break;
+         default: break;
+      }
+      if(!fits) throw_bad_trace();
+   }
+
+   //    apply the rest of the trace to an sda (a replica)
+   template<class T, class Allocator, class Policy>
+   void replay(sda<T, Allocator, Policy>& a)
+   {
+      record r;
+      while(next(r)) apply(a, r);
+   }
+   template<class T, class Allocator, class Policy>
+   void apply(sda<T, Allocator, Policy>& a, const record& r) const
+   {
+      check(r, a.size(), a.capacity() - a.size());
+      switch(r.op)
+      {
+         case sda_op::push_back: a.push_back(value<T>(r, 0)); break;
+         case sda_op::push_front: a.push_front(value<T>(r, 0)); break;
+         case sda_op::pop_back: a.pop_back(); break;
+         case sda_op::pop_front: a.pop_front(); break;
+         case sda_op::insert:
+         case sda_op::join:
+         {
+            sda<T> v;
+            v.reserve_back(r.count);
+            for(std::size_t i = 0; i < r.count; i++) v.push_back(value<T>(r, i));
+            //    a replica may have less room than the original
+            if(r.op == sda_op::insert || a.capacity() - a.size() < r.count)
+               a.insert(a.begin() + r.pos, v.begin(), v.end());
+            else a.join(a.begin() + r.pos, v.begin(), v.end());
+            break;
+         }
+         case sda_op::erase: a.erase(a.begin() + r.pos, a.begin() + r.pos + r.count); break;
+         case sda_op::reserve: a.reserve(r.pos); break;
+         case sda_op::reserve_front: a.reserve_front(r.pos); break;
+         case sda_op::reserve_back: a.reserve_back(r.pos); break;
+         case sda_op::slide_to_front: a.slide_to_front(r.pos); break;
+         case sda_op::slide_to_back: a.slide_to_back(r.pos); break;
+         case sda_op::resize_front:
+            a.resize_front(r.pos);
+            for(std::size_t i = 0; i < r.count; i++) a[i] = value<T>(r, i);
+            break;
+         case sda_op::resize_back:
+            a.resize_back(r.pos);
+            for(std::size_t i = 0; i < r.count; i++) a[r.pos - r.count + i] = value<T>(r, i);
+            break;
+         case sda_op::shrink_to_fit: a.shrink_to_fit(); break;
+         case sda_op::clear: a.clear(); break;
+         case sda_op::set: a[r.pos] = value<T>(r, 0); break;
+      }
+   }
+};
+
+
+
+//-----------------------
+//    JOURNALED SDA
+//-----------------------
+template<class T, class Allocator = std::allocator<T>>
+class journaled_sda
+{
+   public:
+   typedef sda<T, Allocator> array_type;
+   typedef typename array_type::allocator_type allocator_type;
+   typedef typename array_type::value_type value_type;
+   typedef typename array_type::size_type size_type;
+   typedef typename array_type::const_reference const_reference;
+   typedef typename array_type::const_iterator const_iterator;
+
+   static constexpr std::size_t value_size =
+      std::is_trivially_copyable<value_type>::value ? sizeof(value_type) : 0;
+
+
+   private:
+   array_type array_;
+   sda_journal journal_{value_size};
+
+
+   size_type index(const_iterator pos) const noexcept
+   {
+      return pos - array_.begin();
+   }
+   //    the n elements from pos, as they are now
+   void record(sda_op code, size_type pos, size_type n)
+   {
+      journal_.op(code);
+      journal_.put(pos);
+      journal_.put(n);
+      if(n) journal_.values(std::addressof(array_[pos]), n);
+   }
+   void record(sda_op code, size_type n)
+   {
+      journal_.op(code);
+      journal_.put(n);
+   }
+
+
+   public:
+   journaled_sda() = default;
+
+   //    journal starts from the current content of array
+   explicit journaled_sda(const array_type& array) : array_(array)
+   {
+      if(!array_.empty()) record(sda_op::insert, 0, array_.size());
+   }
+
+   sda_journal& journal() noexcept
+   {
+      return journal_;
+   }
+   const sda_journal& journal() const noexcept
+   {
+      return journal_;
+   }
+   const array_type& array() const noexcept
+   {
+      return array_;
+   }
+
+   //------------------
+   //    READ
+   //------------------
+   size_type size() const noexcept { return array_.size(); }
+   bool empty() const noexcept { return array_.empty(); }
+   size_type capacity() const noexcept { return array_.capacity(); }
+   const_reference operator[] (size_type n) const { return array_[n]; }
+   const_reference at(size_type n) const { return array_.at(n); }
+   const_reference front() const { return array_.front(); }
+   const_reference back() const { return array_.back(); }
+   const_iterator begin() const noexcept { return array_.begin(); }
+   const_iterator end() const noexcept { return array_.end(); }
+
+   void set(size_type pos, const value_type& val)
+   {
+      array_[pos] = val;
+      journal_.op(sda_op::set);
+      journal_.put(pos);
+      journal_.values(std::addressof(array_[pos]), 1);
+   }
+
+   //------------------
+   //    PUSH, POP
+   //------------------
+   template<class... Args>
+   void emplace_back(Args&&... args)
+   {
+      array_.emplace_back(std::forward<Args>(args)...);
+      journal_.op(sda_op::push_back);
+      journal_.values(std::addressof(array_.back()), 1);
+   }
+   template<class... Args>
+   void emplace_front(Args&&... args)
+   {
+      array_.emplace_front(std::forward<Args>(args)...);
+      journal_.op(sda_op::push_front);
+      journal_.values(std::addressof(array_.front()), 1);
+   }
+   void push_back(const value_type& val) { emplace_back(val); }
+   void push_back(value_type&& val) { emplace_back(std::move(val)); }
+   void push_front(const value_type& val) { emplace_front(val); }
+   void push_front(value_type&& val) { emplace_front(std::move(val)); }
+   void pop_back()
+   {
+      array_.pop_back();
+      journal_.op(sda_op::pop_back);
+   }
+   void pop_front()
+   {
+      array_.pop_front();
+      journal_.op(sda_op::pop_front);
+   }
+
+   //------------------
+   //    INSERT, JOIN
+   //------------------
+   template<class... Args>
+   const_iterator emplace(const_iterator pos, Args&&... args)
+   {
+      size_type i = index(pos);
+      array_.emplace(pos, std::forward<Args>(args)...);
+      record(sda_op::insert, i, 1);
+      return array_.begin() + i;
+   }
+   const_iterator insert(const_iterator pos, const value_type& val)
+   {
+      return emplace(pos, val);
+   }
+   const_iterator insert(const_iterator pos, size_type n, const value_type& val)
+   {
+      size_type i = index(pos);
+      array_.insert(pos, n, val);
+      record(sda_op::insert, i, n);
+      return array_.begin() + i;
+   }
+   template<class InputIterator, typename = typename array_type::template RequireInputIterator<InputIterator>>
+   const_iterator insert(const_iterator pos, InputIterator first, InputIterator last)
+   {
+      size_type i = index(pos);
+      size_type old_size = array_.size();
+      array_.insert(pos, first, last);
+      record(sda_op::insert, i, array_.size() - old_size);
+      return array_.begin() + i;
+   }
+   const_iterator insert(const_iterator pos, std::initializer_list<value_type> il)
+   {
+      return insert(pos, il.begin(), il.end());
+   }
+   const_iterator join(const_iterator pos, const value_type& val)
+   {
+      size_type i = index(pos);
+      array_.join(pos, val);
+      record(sda_op::join, i, 1);
+      return array_.begin() + i;
+   }
+   const_iterator join(const_iterator pos, size_type n, const value_type& val)
+   {
+      size_type i = index(pos);
+      array_.join(pos, n, val);
+      record(sda_op::join, i, n);
+      return array_.begin() + i;
+   }
+   template<class InputIterator, typename = typename array_type::template RequireInputIterator<InputIterator>>
+   const_iterator join(const_iterator pos, InputIterator first, InputIterator last)
+   {
+      size_type i = index(pos);
+      size_type old_size = array_.size();
+      array_.join(pos, first, last);
+      record(sda_op::join, i, array_.size() - old_size);
+      return array_.begin() + i;
+   }
+
+   //------------------
+   //    ERASE
+   //------------------
+   const_iterator erase(const_iterator pos)
+   {
+      return erase(pos, pos + 1);
+   }
+   const_iterator erase(const_iterator first, const_iterator last)
+   {
+      size_type i = index(first);
+      size_type n = last - first;
+      array_.erase(first, last);
+      journal_.op(sda_op::erase);
+      journal_.put(i);
+      journal_.put(n);
+      return array_.begin() + i;
+   }
+   void clear() noexcept
+   {
+      array_.clear();
+      journal_.op(sda_op::clear);
+   }
+
+   //------------------------------
+   //    CAPACITY, SLIDE, RESIZE
+   //------------------------------
+   void reserve(size_type n)
+   {
+      array_.reserve(n);
+      record(sda_op::reserve, n);
+   }
+   void reserve_front(size_type n)
+   {
+      array_.reserve_front(n);
+      record(sda_op::reserve_front, n);
+   }
+   void reserve_back(size_type n)
+   {
+      array_.reserve_back(n);
+      record(sda_op::reserve_back, n);
+   }
+   void shrink_to_fit()
+   {
+      array_.shrink_to_fit();
+      journal_.op(sda_op::shrink_to_fit);
+   }
+   void slide_to_front(size_type n = 0)
+   {
+      array_.slide_to_front(n);
+      record(sda_op::slide_to_front, n);
+   }
+   void slide_to_back(size_type n = 0)
+   {
+      array_.slide_to_back(n);
+      record(sda_op::slide_to_back, n);
+   }
+   void resize_front(size_type n)
+   {
+      size_type old_size = array_.size();
+      array_.resize_front(n);
+      record_resize(sda_op::resize_front, n, old_size);
+   }
+   void resize_front(size_type n, const value_type& val)
+   {
+      size_type old_size = array_.size();
+      array_.resize_front(n, val);
+      record_resize(sda_op::resize_front, n, old_size);
+   }
+   void resize_back(size_type n)
+   {
+      size_type old_size = array_.size();
+      array_.resize_back(n);
+      record_resize(sda_op::resize_back, n, old_size);
+   }
+   void resize_back(size_type n, const value_type& val)
+   {
+      size_type old_size = array_.size();
+      array_.resize_back(n, val);
+      record_resize(sda_op::resize_back, n, old_size);
+   }
+
+
+   private:
+   //    (n, k, the k new elements): [0, k) at the front, [n - k, n) at the back
+   void record_resize(sda_op code, size_type n, size_type old_size)
+   {
+      size_type k = n > old_size ? n - old_size : 0;
+      journal_.op(code);
+      journal_.put(n);
+      journal_.put(k);
+      if(k) journal_.values(std::addressof(array_[code == sda_op::resize_front ? 0 : n - k]), k);
+   }
+};
+
+
+#endif
@@ -0,0 +1,295 @@
+/*
+MIT License
+
+Copyright 2020 Than Minh Duy (macodeth)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+OR OTHER DEALINGS IN THE SOFTWARE.
+
+*/
+
+
+#ifndef SYMMETRIC_DYNAMIC_ARRAY_MINMAX_HEAP
+#define SYMMETRIC_DYNAMIC_ARRAY_MINMAX_HEAP
+
+
+
+#include<algorithm>
+#include<functional>
+#include<initializer_list>
+#include<iterator>
+#include<memory>
+#include<utility>
+
+#include "sda.h"
+
+
+
+//
+//    min-max heap: a complete binary tree in one array where
+//    even levels are min levels, odd levels are max levels
+//
+//       level 0 (min)            1
+//       level 1 (max)       9          7
+//       level 2 (min)     3   4      2   5
+//
+//    min() is the root, max() the larger child of the root
+//    push, pop_min, pop_max : O(log n), heapify : O(n)
+//
+
+
+template<class T, class Compare = std::less<T>, class Allocator = std::allocator<T>>
+class sda_minmax_heap
+{
+   public:
+   typedef sda<T, Allocator> array_type;
+   typedef typename array_type::allocator_type allocator_type;
+   typedef typename array_type::value_type value_type;
+   typedef typename array_type::size_type size_type;
+   typedef typename array_type::const_reference const_reference;
+   typedef typename array_type::const_iterator const_iterator;
+   typedef Compare value_compare;
+
+
+   private:
+   array_type heap_;
+   Compare comp_;
+
+
+   bool less(size_type a, size_type b) const
+   {
+      return comp_(heap_[a], heap_[b]);
+   }
+   void swap(size_type a, size_type b)
+   {
+      using std::swap;
+      swap(heap_[a], heap_[b]);
+   }
+   static bool is_min_level(size_type i) noexcept
+   {
+      size_type level = 0;
+      for(i++; i > 1; i >>= 1) level++;
+      return (level & 1) == 0;
+   }
+
+   //---------------------------------------
+   //    BUBBLE UP
+   //    compare with the parent once, then
+   //    climb grandparents of the same kind
+   //---------------------------------------
+   template<bool Max>
+   void bubble_up_level(size_type i)
+   {
+      while(i > 2)
+      {
+         size_type g = (i + 1) / 4 - 1;
+         if(!(Max ? less(g, i) : less(i, g))) break;
+         swap(i, g);
+         i = g;
+      }
+   }
+   void bubble_up(size_type i)
+   {
+      if(i == 0) return;
+      size_type p = (i - 1) / 2;
+      if(is_min_level(i))
+      {
+         if(less(p, i))
+         {
+            swap(i, p);
+            bubble_up_level<true>(p);
+         }
+         else bubble_up_level<false>(i);
+      }
+      else
+      {
+         if(less(i, p))
+         {
+            swap(i, p);
+            bubble_up_level<false>(p);
+         }
+         else bubble_up_level<true>(i);
+      }
+   }
+
+   //---------------------------------------
+   //    TRICKLE DOWN
+   //    move i to the best of its children
+   //    and grandchildren until it fits
+   //---------------------------------------
+   template<bool Max>
+   void trickle_down_level(size_type i)
+   {
+      size_type n = heap_.size();
+      while(2 * i + 1 < n)
+      {
+         //    best of up to 2 children and 4 grandchildren
+         size_type m = 2 * i + 1;
+         size_type last = std::min(4 * i + 7, n);
+         if(m + 1 < n && (Max ? less(m, m + 1) : less(m + 1, m))) m++;
+         for(size_type c = 4 * i + 3; c < last; c++)
+            if(Max ? less(m, c) : less(c, m)) m = c;
+
+         if(!(Max ? less(i, m) : less(m, i))) return;
+         swap(m, i);
+         if(m <= 2 * i + 2) return;
+
+         //    grandchild: keep the parent in between in order
+         size_type p = (m - 1) / 2;
+         if(Max ? less(m, p) : less(p, m)) swap(m, p);
+         i = m;
+      }
+   }
+   void trickle_down(size_type i)
+   {
+      if(is_min_level(i)) trickle_down_level<false>(i);
+      else trickle_down_level<true>(i);
+   }
+   void heapify()
+   {
+      for(size_type i = heap_.size() / 2; i-- > 0;) trickle_down(i);
+   }
+   size_type max_index() const
+   {
+      if(heap_.size() <= 2) return heap_.size() - 1;
+      return less(1, 2) ? 2 : 1;
+   }
+   void pop_at(size_type i)
+   {
+      swap(i, heap_.size() - 1);
+      heap_.pop_back();
+      if(i < heap_.size()) trickle_down(i);
+   }
+
+
+   public:
+   sda_minmax_heap() = default;
+
+   explicit sda_minmax_heap(const Compare& comp, const allocator_type& alloc = allocator_type())
+   : heap_(alloc), comp_(comp) {}
+
+   template<class InputIterator, typename = typename array_type::template RequireInputIterator<InputIterator>>
+   sda_minmax_heap(InputIterator first, InputIterator last, const Compare& comp = Compare(),
+      const allocator_type& alloc = allocator_type())
+   : heap_(first, last, alloc), comp_(comp)
+   {
+      heapify();
+   }
+
+   sda_minmax_heap(std::initializer_list<value_type> il, const Compare& comp = Compare())
+   : sda_minmax_heap(il.begin(), il.end(), comp) {}
+
+   //------------------
+   //    CAPACITY
+   //------------------
+   size_type size() const noexcept
+   {
+      return heap_.size();
+   }
+   bool empty() const noexcept
+   {
+      return heap_.empty();
+   }
+   size_type capacity() const noexcept
+   {
+      return heap_.capacity();
+   }
+   void reserve(size_type n)
+   {
+      heap_.reserve_back(n);
+   }
+   void shrink_to_fit()
+   {
+      heap_.shrink_to_fit();
+   }
+   void clear() noexcept
+   {
+      heap_.clear();
+   }
+
+   //-------------------------------------------
+   //    ACCESS
+   //    heap must not be empty
+   //    begin(), end() : heap order, unsorted
+   //-------------------------------------------
+   const_reference min() const
+   {
+      return heap_.front();
+   }
+   const_reference max() const
+   {
+      return heap_[max_index()];
+   }
+   const_iterator begin() const noexcept
+   {
+      return heap_.begin();
+   }
+   const_iterator end() const noexcept
+   {
+      return heap_.end();
+   }
+
+   //-------------------------------------------
+   //    PUSH, POP
+   //    push(first, last) rebuilds the heap in
+   //    O(n) when it at least doubles the size
+   //-------------------------------------------
+   void push(const value_type& val)
+   {
+      heap_.push_back(val);
+      bubble_up(heap_.size() - 1);
+   }
+   void push(value_type&& val)
+   {
+      heap_.push_back(std::move(val));
+      bubble_up(heap_.size() - 1);
+   }
+   template<class... Args>
+   void emplace(Args&&... args)
+   {
+      heap_.emplace_back(std::forward<Args>(args)...);
+      bubble_up(heap_.size() - 1);
+   }
+   template<class InputIterator, typename = typename array_type::template RequireInputIterator<InputIterator>>
+   void push(InputIterator first, InputIterator last)
+   {
+      size_type old_size = heap_.size();
+      heap_.insert(heap_.end(), first, last);
+      if(heap_.size() - old_size >= old_size) heapify();
+      else
+         for(size_type i = old_size; i < heap_.size(); i++) bubble_up(i);
+   }
+   void pop_min()
+   {
+      pop_at(0);
+   }
+   void pop_max()
+   {
+      pop_at(max_index());
+   }
+
+   void swap(sda_minmax_heap& other) noexcept
+   {
+      using std::swap;
+      heap_.swap(other.heap_);
+      swap(comp_, other.comp_);
+   }
+};
+
+
+#endif
@@ -0,0 +1,256 @@
+/*
+MIT License
+
+Copyright 2020 Than Minh Duy (macodeth)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+OR OTHER DEALINGS IN THE SOFTWARE.
+
+*/
+
+
+
+#ifndef SYMMETRIC_DYNAMIC_ARRAY_RADIX_SORT
+#define SYMMETRIC_DYNAMIC_ARRAY_RADIX_SORT
+
+
+
+#include<algorithm>
+#include<cstddef>
+#include<cstring>
+#include<memory>
+#include<thread>
+#include<type_traits>
+
+#include "sda.h"
+
+
+
+//
+//    LSD radix sort, 8 bits per pass, stable, for trivially
+//    copyable elements with an integral key
+//
+//    the n-element scratch buffer is the empty capacity:
+//
+//       [# # # # # a a a a # # # # # #]      back slack >= n
+//                  data    scratch
+//
+//    if neither side holds n elements but both together do, the
+//    array slides to one end first, otherwise one side grows
+//    (append_uninitialized / prepend_uninitialized), passes then
+//    ping-pong between the data and the scratch, and an odd
+//    number of passes ends with the result taken in place with
+//    commit_back + resize_front (or commit_front + resize_back)
+//
+//    passes where every key has the same digit are skipped,
+//    signed keys have their sign bit flipped
+//
+
+
+namespace sda_radix
+{
+   constexpr std::size_t buckets = 256;
+   //    below this, std::stable_sort
+   constexpr std::size_t small_size = 64;
+
+   template<class K>
+   constexpr auto bits(K k) noexcept
+   {
+      static_assert(std::is_integral<K>::value && !std::is_same<K, bool>::value,
+         "sda_radix_sort needs an integral key");
+      typedef typename std::make_unsigned<K>::type U;
+      U u = static_cast<U>(k);
+      if constexpr (std::is_signed<K>::value) u ^= U(1) << (sizeof(U) * 8 - 1);
+      return u;
+   }
+
+   struct identity
+   {
+      template<class T>
+      constexpr const T& operator()(const T& v) const noexcept
+      {
+         return v;
+      }
+   };
+
+   //    a scratch span of a.size() elements in the empty capacity
+   template<class T, class Allocator, class Policy>
+   bool scratch_at_back(sda<T, Allocator, Policy>& a)
+   {
+      std::size_t n = a.size();
+      std::size_t front = a.empty_front_capacity();
+      std::size_t back = a.empty_back_capacity();
+      if(front < n && back < n && front + back >= n)
+      {
+         if(back >= front) a.slide_to_front();
+         else a.slide_to_back();
+         front = a.empty_front_capacity();
+         back = a.empty_back_capacity();
+      }
+      return !(front >= n && front > back);
+   }
+
+   //    one pass: stable scatter of [from, from + n) by digit shift
+   //    using the running offsets
+   template<class T, class Key>
+   void scatter(const T* from, T* to, std::size_t n, Key& key, unsigned shift, std::size_t* offset)
+   {
+      for(std::size_t i = 0; i < n; i++)
+      {
+         std::size_t d = (bits(key(from[i])) >> shift) & (buckets - 1);
+         std::memcpy(static_cast<void*>(to + offset[d]++), from + i, sizeof(T));
+      }
+   }
+
+   //    sort [data, data + n) with [scratch, scratch + n),
+   //    true if the result ended in scratch
+   template<class T, class Key>
+   bool sort(T* data, T* scratch, std::size_t n, Key& key, unsigned threads)
+   {
+      typedef decltype(bits(key(*data))) U;
+      constexpr unsigned passes = sizeof(U);
+      if(threads > n / (buckets * 16)) threads = unsigned(n / (buckets * 16));
+      if(threads < 1) threads = 1;
+
+      //    every pass counted in one read
+      std::size_t count[passes][buckets] = {};
+      for(std::size_t i = 0; i < n; i++)
+      {
+         U u = bits(key(data[i]));
+         for(unsigned p = 0; p < passes; p++) count[p][(u >> (8 * p)) & (buckets - 1)]++;
+      }
+
+      T* from = data;
+      T* to = scratch;
+      for(unsigned p = 0; p < passes; p++)
+      {
+         if(std::find(count[p], count[p] + buckets, n) != count[p] + buckets) continue;
+         unsigned shift = 8 * p;
+         if(threads == 1)
+         {
+            std::size_t offset[buckets];
+            std::size_t sum = 0;
+            for(std::size_t d = 0; d < buckets; d++)
+            {
+               offset[d] = sum;
+               sum += count[p][d];
+            }
+            scatter(from, to, n, key, shift, offset);
+         }
+         else
+         {
+            //    each thread counts its chunk, then scatters it from
+            //    its own offsets: chunk t of digit d follows chunk t - 1
+            std::unique_ptr<std::size_t[]> offset(new std::size_t[threads * buckets]());
+            auto chunk = [&](unsigned t) { return n / threads * t + std::min<std::size_t>(t, n % threads); };
+            auto run = [&](auto&& f)
+            {
+               std::unique_ptr<std::thread[]> pool(new std::thread[threads - 1]);
+               for(unsigned t = 1; t < threads; t++) pool[t - 1] = std::thread(f, t);
+               f(0u);
+               for(unsigned t = 1; t < threads; t++) pool[t - 1].join();
+            };
+            run([&](unsigned t)
+            {
+               std::size_t* c = offset.get() + t * buckets;
+               for(std::size_t i = chunk(t); i < chunk(t + 1); i++)
+                  c[(bits(key(from[i])) >> shift) & (buckets - 1)]++;
+            });
+            std::size_t sum = 0;
+            for(std::size_t d = 0; d < buckets; d++)
+               for(unsigned t = 0; t < threads; t++)
+               {
+                  std::size_t c = offset[t * buckets + d];
+                  offset[t * buckets + d] = sum;
+                  sum += c;
+               }
+            run([&](unsigned t)
+            {
+               std::size_t first = chunk(t);
+               scatter(from + first, to, chunk(t + 1) - first, key, shift, offset.get() + t * buckets);
+            });
+         }
+         std::swap(from, to);
+      }
+      return from == scratch;
+   }
+
+   template<class T, class Allocator, class Policy, class Key>
+   void sort(sda<T, Allocator, Policy>& a, Key& key, unsigned threads)
+   {
+      static_assert(std::is_trivially_copyable<T>::value, "sda_radix_sort needs a trivially copyable type");
+      std::size_t n = a.size();
+      if(n < small_size)
+      {
+         std::stable_sort(a.begin(), a.end(), [&key](const T& x, const T& y) { return bits(key(x)) < bits(key(y)); });
+         return;
+      }
+      bool back = scratch_at_back(a);
+      auto spare = back ? a.append_uninitialized(n) : a.prepend_uninitialized(n);
+      T* scratch = std::addressof(*spare.data());
+      T* data = std::addressof(a[0]);
+      if(sort(data, scratch, n, key, threads))
+      {
+         if(back)
+         {
+            a.commit_back(n);
+            a.resize_front(n);
+         }
+         else
+         {
+            a.commit_front(n);
+            a.resize_back(n);
+         }
+      }
+   }
+}
+
+
+//-------------------------------------------
+//    RADIX SORT
+//    sda_radix_sort(a)        : integral elements
+//    sda_radix_sort(a, key)   : key(element) is integral
+//    *_parallel               : passes split over
+//                               threads (0: all cores)
+//-------------------------------------------
+template<class T, class Allocator, class Policy>
+void sda_radix_sort(sda<T, Allocator, Policy>& a)
+{
+   sda_radix::identity key;
+   sda_radix::sort(a, key, 1);
+}
+template<class T, class Allocator, class Policy, class Key>
+void sda_radix_sort(sda<T, Allocator, Policy>& a, Key key)
+{
+   sda_radix::sort(a, key, 1);
+}
+template<class T, class Allocator, class Policy>
+void sda_radix_sort_parallel(sda<T, Allocator, Policy>& a, unsigned threads = 0)
+{
+   sda_radix::identity key;
+   sda_radix::sort(a, key, threads ? threads : std::max(1u, std::thread::hardware_concurrency()));
+}
+template<class T, class Allocator, class Policy, class Key,
+   typename = std::enable_if_t<std::is_invocable<Key&, const T&>::value>>
+void sda_radix_sort_parallel(sda<T, Allocator, Policy>& a, Key key, unsigned threads = 0)
+{
+   sda_radix::sort(a, key, threads ? threads : std::max(1u, std::thread::hardware_concurrency()));
+}
+
+
+#endif
@@ -0,0 +1,328 @@
+/*
+MIT License
+
+Copyright 2020 Than Minh Duy (macodeth)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+OR OTHER DEALINGS IN THE SOFTWARE.
+
+*/
+
+
+#ifndef SYMMETRIC_DYNAMIC_ARRAY_RLE
+#define SYMMETRIC_DYNAMIC_ARRAY_RLE
+
+
+
+#include<algorithm>
+#include<cstddef>
+#include<initializer_list>
+#include<iterator>
+#include<memory>
+#include<stdexcept>
+
+#include "sda.h"
+
+
+
+//
+//    run-length encoded sequence: one (value, start) pair per run
+//    of equal values, kept in an sda
+//
+//       5 5 5 5 7 7 1 1 1    ->    (5, 0) (7, 4) (1, 6), end 9
+//
+//    starts are keys, position = key - origin_, so opening or
+//    closing a gap renumbers only the runs on the side that
+//    has fewer of them:
+//
+//       back side  : runs after the gap, key += n
+//       front side : runs before the gap, key -= n, origin_ -= n
+//
+//    position -> run is a binary search over the starts,
+//    insert(pos, n, val) and erase(first, last) cost
+//    O(log runs + runs shifted) whatever n is
+//
+
+
+template<class T, class Allocator = std::allocator<T>>
+class sda_rle
+{
+   public:
+   typedef T value_type;
+   typedef std::size_t size_type;
+   typedef std::ptrdiff_t difference_type;
+   typedef const value_type& const_reference;
+
+
+   private:
+   typedef std::ptrdiff_t key_type;
+
+   struct run
+   {
+      value_type value;
+      key_type start;
+   };
+   typedef sda<run, typename std::allocator_traits<Allocator>::template rebind_alloc<run>> run_array;
+
+   run_array runs_;
+   key_type origin_ = 0;
+   key_type end_ = 0;
+
+
+   key_type run_end(size_type i) const noexcept
+   {
+      return i + 1 < runs_.size() ? runs_[i + 1].start : end_;
+   }
+   //    first run starting at or after key k
+   size_type lower_run(key_type k) const noexcept
+   {
+      return std::lower_bound(runs_.begin(), runs_.end(), k,
+         [](const run& r, key_type key) { return r.start < key; }) - runs_.begin();
+   }
+   //    run holding key k
+   size_type find_run(key_type k) const noexcept
+   {
+      return std::upper_bound(runs_.begin(), runs_.end(), k,
+         [](key_type key, const run& r) { return key < r.start; }) - runs_.begin() - 1;
+   }
+   //    open (delta > 0) or close (delta < 0) a gap before run i,
+   //    renumbering the side with fewer runs, true if the back side
+   bool shift(size_type i, key_type delta)
+   {
+      if(runs_.size() - i <= i)
+      {
+         for(size_type j = i; j < runs_.size(); j++) runs_[j].start += delta;
+         end_ += delta;
+         return true;
+      }
+      for(size_type j = 0; j < i; j++) runs_[j].start -= delta;
+      origin_ -= delta;
+      return false;
+   }
+   //    merge runs i - 1 and i when they hold equal values
+   void merge(size_type i)
+   {
+      if(i > 0 && i < runs_.size() && runs_[i - 1].value == runs_[i].value)
+         runs_.erase(runs_.begin() + i);
+   }
+
+
+   public:
+   //    decoding iterator, one value per position
+   class const_iterator
+   {
+      const sda_rle* a_ = nullptr;
+      size_type run_ = 0;
+      key_type key_ = 0;
+      friend class sda_rle;
+      const_iterator(const sda_rle* a, size_type r, key_type k) noexcept : a_(a), run_(r), key_(k) {}
+
+      public:
+      typedef std::bidirectional_iterator_tag iterator_category;
+      typedef typename sda_rle::value_type value_type;
+      typedef typename sda_rle::difference_type difference_type;
+      typedef const value_type* pointer;
+      typedef const value_type& reference;
+
+      const_iterator() = default;
+
+      reference operator*() const { return a_->runs_[run_].value; }
+      pointer operator->() const { return &a_->runs_[run_].value; }
+      const_iterator& operator++() noexcept
+      {
+         if(++key_ == a_->run_end(run_)) run_++;
+         return *this;
+      }
+      const_iterator& operator--() noexcept
+      {
+         if(run_ == a_->runs_.size() || key_ == a_->runs_[run_].start) run_--;
+         key_--;
+         return *this;
+      }
+      const_iterator operator++(int) noexcept { const_iterator t = *this; ++*this; return t; }
+      const_iterator operator--(int) noexcept { const_iterator t = *this; --*this; return t; }
+      bool operator==(const const_iterator& o) const noexcept { return key_ == o.key_; }
+      bool operator!=(const const_iterator& o) const noexcept { return key_ != o.key_; }
+
+      //    length left in the current run, for run-wise loops
+      size_type run_left() const noexcept { return a_->run_end(run_) - key_; }
+   };
+   typedef const_iterator iterator;
+
+
+   sda_rle() = default;
+
+   sda_rle(size_type n, const value_type& val)
+   {
+      insert(0, n, val);
+   }
+   sda_rle(std::initializer_list<value_type> il)
+   {
+      for(const value_type& val : il) push_back(val);
+   }
+
+   //------------------
+   //    CAPACITY
+   //------------------
+   size_type size() const noexcept
+   {
+      return end_ - origin_;
+   }
+   bool empty() const noexcept
+   {
+      return end_ == origin_;
+   }
+   size_type run_count() const noexcept
+   {
+      return runs_.size();
+   }
+   //    bytes owned
+   size_type memory_usage() const noexcept
+   {
+      return sizeof(*this) + runs_.capacity() * sizeof(run);
+   }
+   void shrink_to_fit()
+   {
+      runs_.shrink_to_fit();
+   }
+   void clear() noexcept
+   {
+      runs_.clear();
+      origin_ = end_ = 0;
+   }
+
+   //------------------
+   //    ACCESS
+   //------------------
+   const_reference operator[] (size_type n) const
+   {
+      return runs_[find_run(origin_ + key_type(n))].value;
+   }
+   const_reference at(size_type n) const
+   {
+      if(n >= size()) throw std::out_of_range("std::out_of_range");
+      return (*this)[n];
+   }
+   const_reference front() const
+   {
+      return runs_.front().value;
+   }
+   const_reference back() const
+   {
+      return runs_.back().value;
+   }
+   const_iterator begin() const noexcept
+   {
+      return const_iterator(this, 0, origin_);
+   }
+   const_iterator end() const noexcept
+   {
+      return const_iterator(this, runs_.size(), end_);
+   }
+   //    n-th run: value, first position, length
+   const_reference run_value(size_type i) const
+   {
+      return runs_[i].value;
+   }
+   size_type run_position(size_type i) const noexcept
+   {
+      return runs_[i].start - origin_;
+   }
+   size_type run_length(size_type i) const noexcept
+   {
+      return run_end(i) - runs_[i].start;
+   }
+
+   //-------------------------------------------
+   //    INSERT
+   //    a run equal to val next to pos grows,
+   //    otherwise a run is split at most once
+   //-------------------------------------------
+   void insert(size_type pos, size_type n, const value_type& val)
+   {
+      if(n == 0) return;
+      key_type k = origin_ + key_type(pos);
+      size_type i = lower_run(k);
+      if(i > 0 && runs_[i - 1].value == val)
+      {
+         shift(i, key_type(n));
+         return;
+      }
+      //    the gap is [k, k + n) or [k - n, k) depending on the side
+      if(i < runs_.size() && runs_[i].start == k && runs_[i].value == val)
+      {
+         runs_[i].start = shift(i, key_type(n)) ? k : k - key_type(n);
+         return;
+      }
+      if(i > 0 && k < run_end(i - 1))
+         runs_.insert(runs_.begin() + i, run{runs_[i - 1].value, k});
+      key_type gap = shift(i, key_type(n)) ? k : k - key_type(n);
+      runs_.insert(runs_.begin() + i, run{val, gap});
+   }
+   void insert(size_type pos, const value_type& val)
+   {
+      insert(pos, 1, val);
+   }
+   void push_back(const value_type& val)
+   {
+      insert(size(), 1, val);
+   }
+   void push_front(const value_type& val)
+   {
+      insert(0, 1, val);
+   }
+   //    replace one value, splits its run
+   void set(size_type pos, const value_type& val)
+   {
+      erase(pos, pos + 1);
+      insert(pos, 1, val);
+   }
+
+   //-------------------------------------------
+   //    ERASE
+   //-------------------------------------------
+   void erase(size_type first, size_type last)
+   {
+      if(first == last) return;
+      key_type a = origin_ + key_type(first);
+      key_type b = origin_ + key_type(last);
+      size_type lo = lower_run(a);
+      size_type hi = lower_run(b);
+      //    a run starting inside [a, b) and ending after b keeps its tail
+      if(hi > lo && run_end(hi - 1) > b)
+         runs_[--hi].start = b;
+      runs_.erase(runs_.begin() + lo, runs_.begin() + hi);
+      shift(lo, -key_type(last - first));
+      merge(lo);
+   }
+   void erase(size_type pos)
+   {
+      erase(pos, pos + 1);
+   }
+   void pop_back()
+   {
+      erase(size() - 1, size());
+   }
+   void pop_front()
+   {
+      erase(0, 1);
+   }
+};
+
+
+#endif
@@ -0,0 +1,489 @@
+/*
+MIT License
+
+Copyright 2020 Than Minh Duy (macodeth)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+OR OTHER DEALINGS IN THE SOFTWARE.
+
+*/
+
+
+#ifndef SYMMETRIC_DYNAMIC_ARRAY_SHM
+#define SYMMETRIC_DYNAMIC_ARRAY_SHM
+
+
+
+#include<cstddef>
+#include<cstdint>
+#include<iterator>
+#include<new>
+#include<stdexcept>
+#include<type_traits>
+#include<utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include<cerrno>
+#include<fcntl.h>
+#include<sys/mman.h>
+#include<sys/stat.h>
+#include<system_error>
+#include<unistd.h>
+#define SDA_SHM_SEGMENT
+#endif
+
+#include "sda.h"
+
+
+
+//
+//    sda in shared memory
+//
+//    offset_ptr<T> : pointer stored as the distance from itself,
+//    stays valid wherever the memory holding it is mapped
+//
+//    sda_shm_arena : first-fit allocator living at the start of
+//    the shared block, free list sorted by address and merged
+//    on deallocate
+//
+//    shm_allocator<T> : allocator of the arena, its pointer is
+//    offset_ptr<T>, so an sda built with it (and placed in the
+//    block) can be read by every process mapping the block
+//
+//       sda_shm_segment w = sda_shm_segment::create("/quotes", 1 << 26);
+//       auto* a = w.construct<sda<int, shm_allocator<int>>>();
+//
+//       sda_shm_segment r = sda_shm_segment::open("/quotes");
+//       auto* b = r.find<sda<int, shm_allocator<int>>>();
+//
+//    readers see the writer's edits, ordering them (a lock,
+//    a sequence counter) is up to the user
+//
+
+
+//-----------------------
+//    OFFSET POINTER
+//-----------------------
+template<class T>
+class offset_ptr
+{
+   //    1 is never a distance to a valid object of this kind
+   static constexpr std::ptrdiff_t null_offset = 1;
+
+   std::ptrdiff_t offset_ = null_offset;
+
+   //    integer arithmetic, the two addresses are not
+   //    in the same object as far as the language knows
+   static std::uintptr_t address(const volatile void* p) noexcept
+   {
+      return reinterpret_cast<std::uintptr_t>(p);
+   }
+   void set(T* p) noexcept
+   {
+      offset_ = p ? std::ptrdiff_t(address(p) - address(this)) : null_offset;
+   }
+
+
+   public:
+   typedef T element_type;
+   typedef typename std::remove_cv<T>::type value_type;
+   typedef std::ptrdiff_t difference_type;
+   typedef typename std::add_lvalue_reference<T>::type reference;
+   typedef offset_ptr pointer;
+   typedef std::random_access_iterator_tag iterator_category;
+
+   template<class U>
+   using rebind = offset_ptr<U>;
+
+   offset_ptr() noexcept = default;
+   offset_ptr(std::nullptr_t) noexcept {}
+   offset_ptr(T* p) noexcept
+   {
+      set(p);
+   }
+   offset_ptr(const offset_ptr& other) noexcept
+   {
+      set(other.get());
+   }
+   template<class U, typename = typename std::enable_if<std::is_convertible<U*, T*>::value>::type>
+   offset_ptr(const offset_ptr<U>& other) noexcept
+   {
+      set(other.get());
+   }
+   //    void pointer back to a typed one, as allocators need
+   template<class U, typename = typename std::enable_if<std::is_void<U>::value && !std::is_void<T>::value>::type, typename = void>
+   explicit offset_ptr(const offset_ptr<U>& other) noexcept
+   {
+      set(static_cast<T*>(other.get()));
+   }
+   offset_ptr& operator= (const offset_ptr& other) noexcept
+   {
+      set(other.get());
+      return *this;
+   }
+   offset_ptr& operator= (T* p) noexcept
+   {
+      set(p);
+      return *this;
+   }
+
+   template<class U = T, typename = typename std::enable_if<!std::is_void<U>::value>::type>
+   static offset_ptr pointer_to(U& r) noexcept
+   {
+      return offset_ptr(std::addressof(r));
+   }
+
+   T* get() const noexcept
+   {
+      return offset_ == null_offset ? nullptr :
+         reinterpret_cast<T*>(address(this) + std::uintptr_t(offset_));
+   }
+   T* operator->() const noexcept { return get(); }
+   reference operator*() const noexcept { return *get(); }
+   reference operator[](difference_type n) const noexcept { return get()[n]; }
+   explicit operator bool() const noexcept { return offset_ != null_offset; }
+
+   offset_ptr& operator++() noexcept { set(get() + 1); return *this; }
+   offset_ptr& operator--() noexcept { set(get() - 1); return *this; }
+   offset_ptr operator++(int) noexcept { offset_ptr t = *this; ++*this; return t; }
+   offset_ptr operator--(int) noexcept { offset_ptr t = *this; --*this; return t; }
+   offset_ptr& operator+=(difference_type n) noexcept { set(get() + n); return *this; }
+   offset_ptr& operator-=(difference_type n) noexcept { set(get() - n); return *this; }
+   friend offset_ptr operator+(const offset_ptr& p, difference_type n) noexcept { return offset_ptr(p.get() + n); }
+   friend offset_ptr operator+(difference_type n, const offset_ptr& p) noexcept { return offset_ptr(p.get() + n); }
+   friend offset_ptr operator-(const offset_ptr& p, difference_type n) noexcept { return offset_ptr(p.get() - n); }
+   friend difference_type operator-(const offset_ptr& a, const offset_ptr& b) noexcept { return a.get() - b.get(); }
+
+   friend bool operator==(const offset_ptr& a, const offset_ptr& b) noexcept { return a.get() == b.get(); }
+   friend bool operator!=(const offset_ptr& a, const offset_ptr& b) noexcept { return a.get() != b.get(); }
+   friend bool operator<(const offset_ptr& a, const offset_ptr& b) noexcept { return a.get() < b.get(); }
+   friend bool operator>(const offset_ptr& a, const offset_ptr& b) noexcept { return a.get() > b.get(); }
+   friend bool operator<=(const offset_ptr& a, const offset_ptr& b) noexcept { return a.get() <= b.get(); }
+   friend bool operator>=(const offset_ptr& a, const offset_ptr& b) noexcept { return a.get() >= b.get(); }
+   friend bool operator==(const offset_ptr& a, std::nullptr_t) noexcept { return !a; }
+   friend bool operator!=(const offset_ptr& a, std::nullptr_t) noexcept { return bool(a); }
+};
+
+
+
+//-----------------------
+//    ARENA
+//-----------------------
+class sda_shm_arena
+{
+   struct free_block
+   {
+      std::size_t size;
+      offset_ptr<free_block> next;
+   };
+
+   static constexpr std::uint64_t magic_value = 0x5344415F53484D31ull;   // "SDA_SHM1"
+   static constexpr std::size_t grain = 16;
+
+   std::uint64_t magic_;
+   std::size_t size_;
+   offset_ptr<free_block> free_;
+   offset_ptr<void> root_;
+
+
+   static std::size_t round(std::size_t bytes) noexcept
+   {
+      return bytes < grain ? grain : (bytes + grain - 1) / grain * grain;
+   }
+   char* first_byte() noexcept
+   {
+      return reinterpret_cast<char*>(this) + round(sizeof(sda_shm_arena));
+   }
+
+
+   public:
+   //    arena over [this, this + size)
+   explicit sda_shm_arena(std::size_t size) noexcept : magic_(magic_value), size_(size)
+   {
+      std::size_t used = round(sizeof(sda_shm_arena));
+      if(size > used + grain)
+      {
+         free_block* b = ::new(static_cast<void*>(first_byte())) free_block;
+         b->size = (size - used) / grain * grain;
+         free_ = b;
+      }
+   }
+   bool valid() const noexcept
+   {
+      return magic_ == magic_value;
+   }
+   std::size_t size() const noexcept
+   {
+      return size_;
+   }
+
+   //    first fit, the tail of a larger block is cut off
+   void* allocate(std::size_t bytes)
+   {
+      std::size_t need = round(bytes);
+      offset_ptr<free_block>* link = &free_;
+      for(free_block* b = free_.get(); b; link = &b->next, b = b->next.get())
+      {
+         if(b->size < need) continue;
+         if(b->size - need >= grain)
+         {
+            b->size -= need;
+            return reinterpret_cast<char*>(b) + b->size;
+         }
+         *link = b->next.get();
+         return b;
+      }
+      throw std::bad_alloc();
+   }
+   void deallocate(void* p, std::size_t bytes) noexcept
+   {
+      if(!p) return;
+      char* c = static_cast<char*>(p);
+      free_block* prev = nullptr;
+      free_block* next = free_.get();
+      for(; next && reinterpret_cast<char*>(next) < c; next = next->next.get()) prev = next;
+
+      free_block* b = ::new(p) free_block;
+      b->size = round(bytes);
+      b->next = next;
+      if(next && c + b->size == reinterpret_cast<char*>(next))
+      {
+         b->size += next->size;
+         b->next = next->next.get();
+      }
+      if(prev && reinterpret_cast<char*>(prev) + prev->size == c)
+      {
+         prev->size += b->size;
+         prev->next = b->next.get();
+      }
+      else if(prev) prev->next = b;
+      else free_ = b;
+   }
+   //    bytes left, the largest request may be smaller
+   std::size_t available() const noexcept
+   {
+      std::size_t n = 0;
+      for(const free_block* b = free_.get(); b; b = b->next.get()) n += b->size;
+      return n;
+   }
+
+   void* root() const noexcept
+   {
+      return root_.get();
+   }
+   void set_root(void* p) noexcept
+   {
+      root_ = p;
+   }
+};
+
+
+
+//-----------------------
+//    ALLOCATOR
+//-----------------------
+template<class T>
+class shm_allocator
+{
+   template<class> friend class shm_allocator;
+
+   offset_ptr<sda_shm_arena> arena_;
+
+
+   public:
+   typedef T value_type;
+   typedef offset_ptr<T> pointer;
+   typedef offset_ptr<const T> const_pointer;
+   typedef offset_ptr<void> void_pointer;
+   typedef offset_ptr<const void> const_void_pointer;
+   typedef std::size_t size_type;
+   typedef std::ptrdiff_t difference_type;
+
+   template<class U>
+   struct rebind
+   {
+      typedef shm_allocator<U> other;
+   };
+
+   explicit shm_allocator(sda_shm_arena* arena) noexcept : arena_(arena) {}
+
+   shm_allocator(const shm_allocator& other) noexcept : arena_(other.arena_) {}
+
+   template<class U>
+   shm_allocator(const shm_allocator<U>& other) noexcept : arena_(other.arena_) {}
+
+   shm_allocator& operator= (const shm_allocator& other) noexcept
+   {
+      arena_ = other.arena_;
+      return *this;
+   }
+
+   pointer allocate(size_type n)
+   {
+      return pointer(static_cast<T*>(arena_->allocate(n * sizeof(T))));
+   }
+   void deallocate(pointer p, size_type n) noexcept
+   {
+      arena_->deallocate(p.get(), n * sizeof(T));
+   }
+   sda_shm_arena* arena() const noexcept
+   {
+      return arena_.get();
+   }
+
+   template<class U>
+   bool operator==(const shm_allocator<U>& other) const noexcept
+   {
+      return arena_ == other.arena_;
+   }
+   template<class U>
+   bool operator!=(const shm_allocator<U>& other) const noexcept
+   {
+      return arena_ != other.arena_;
+   }
+};
+
+
+
+#ifdef SDA_SHM_SEGMENT
+//-------------------------------------------------
+//    SEGMENT
+//    POSIX shared memory object mapped into this
+//    process, unmapped (not removed) on destruction
+//-------------------------------------------------
+class sda_shm_segment
+{
+   void* base_ = nullptr;
+   std::size_t size_ = 0;
+
+   sda_shm_segment(void* base, std::size_t size) noexcept : base_(base), size_(size) {}
+
+   [[noreturn]] static void throw_errno(const char* what)
+   {
+      throw std::system_error(errno, std::generic_category(), what);
+   }
+   static void* map(int fd, std::size_t size, bool read_only)
+   {
+      void* p = mmap(nullptr, size, read_only ? PROT_READ : PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+      int error = errno;
+      close(fd);
+      errno = error;
+      if(p == MAP_FAILED) throw_errno("mmap");
+      return p;
+   }
+
+
+   public:
+   //    new object of size bytes, an existing one is replaced
+   static sda_shm_segment create(const char* name, std::size_t size)
+   {
+      int fd = shm_open(name, O_CREAT | O_RDWR | O_TRUNC, 0600);
+      if(fd < 0) throw_errno("shm_open");
+      if(ftruncate(fd, off_t(size)) != 0)
+      {
+         int error = errno;
+         close(fd);
+         errno = error;
+         throw_errno("ftruncate");
+      }
+      void* base = map(fd, size, false);
+      ::new(base) sda_shm_arena(size);
+      return sda_shm_segment(base, size);
+   }
+   //    map an object made by create, readers usually map it read only
+   static sda_shm_segment open(const char* name, bool read_only = true)
+   {
+      int fd = shm_open(name, read_only ? O_RDONLY : O_RDWR, 0);
+      if(fd < 0) throw_errno("shm_open");
+      struct stat st;
+      if(fstat(fd, &st) != 0)
+      {
+         int error = errno;
+         close(fd);
+         errno = error;
+         throw_errno("fstat");
+      }
+      std::size_t size = std::size_t(st.st_size);
+      sda_shm_segment segment(map(fd, size, read_only), size);
+      if(!segment.arena()->valid()) throw std::runtime_error("sda_shm_segment: not an sda arena");
+      return segment;
+   }
+   static void remove(const char* name) noexcept
+   {
+      shm_unlink(name);
+   }
+
+   sda_shm_segment(sda_shm_segment&& other) noexcept : base_(other.base_), size_(other.size_)
+   {
+      other.base_ = nullptr;
+      other.size_ = 0;
+   }
+   sda_shm_segment& operator= (sda_shm_segment&& other) noexcept
+   {
+      std::swap(base_, other.base_);
+      std::swap(size_, other.size_);
+      return *this;
+   }
+   ~sda_shm_segment()
+   {
+      if(base_) munmap(base_, size_);
+   }
+
+   sda_shm_arena* arena() const noexcept
+   {
+      return static_cast<sda_shm_arena*>(base_);
+   }
+   template<class T>
+   shm_allocator<T> allocator() const noexcept
+   {
+      return shm_allocator<T>(arena());
+   }
+
+   //    build the shared object, args are followed by the allocator
+   //    when Container takes one: construct<sda<int, shm_allocator<int>>>()
+   template<class Container, class... Args>
+   Container* construct(Args&&... args)
+   {
+      void* p = arena()->allocate(sizeof(Container));
+      Container* c;
+      try
+      {
+         if constexpr (std::is_constructible<Container, Args..., typename Container::allocator_type>::value)
+            c = ::new(p) Container(std::forward<Args>(args)...,
+               typename Container::allocator_type(arena()));
+         else
+            c = ::new(p) Container(std::forward<Args>(args)...);
+      }
+      catch(...)
+      {
+         arena()->deallocate(p, sizeof(Container));
+         throw;
+      }
+      arena()->set_root(c);
+      return c;
+   }
+   template<class Container>
+   Container* find() const noexcept
+   {
+      return static_cast<Container*>(arena()->root());
+   }
+};
+#endif
+
+
+#endif
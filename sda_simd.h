@@ -0,0 +1,781 @@
+/*
+MIT License
+
+Copyright 2020 Than Minh Duy (macodeth)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+OR OTHER DEALINGS IN THE SOFTWARE.
+
+*/
+
+
+
+#ifndef SYMMETRIC_DYNAMIC_ARRAY_SIMD
+#define SYMMETRIC_DYNAMIC_ARRAY_SIMD
+
+
+
+#include<algorithm>
+#include<cstddef>
+#include<cstdint>
+#include<memory>
+#include<type_traits>
+
+#include "sda.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define SDA_SIMD_X86 1
+//    GCC 12 warns about the _mm512_undefined_* self-initializations
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#include<immintrin.h>
+#pragma GCC diagnostic pop
+#else
+#define SDA_SIMD_X86 0
+#endif
+
+
+
+//
+//    scans over [begin(), end()) with AVX2 / AVX-512 kernels,
+//    picked at run time from what the CPU supports
+//
+//       find, find_between, count  : first match / matches
+//       min, max, argmin, argmax   : no NaN in floating arrays
+//       sum                        : 32-bit integers add up in
+//                                    64 bits
+//       prefix_sum                 : inclusive, in place
+//
+//    int32_t, uint32_t, int64_t, uint64_t, float and double go
+//    through the kernels, other types through plain loops
+//
+//    find, find_between and count end with one full vector load
+//    reaching into the empty back capacity when it is there,
+//    the lanes past end() are masked out; min and max end with
+//    a vector overlapping the previous one
+//
+
+
+namespace sda_simd
+{
+   enum class isa
+   {
+      scalar,
+      avx2,
+      avx512
+   };
+
+   template<class T>
+   using sum_type = std::conditional_t<std::is_integral<T>::value && sizeof(T) < 8,
+      std::conditional_t<std::is_signed<T>::value, std::int64_t, std::uint64_t>, T>;
+
+   template<class T>
+   constexpr bool vectorized =
+      std::is_same<T, std::int32_t>::value || std::is_same<T, std::uint32_t>::value ||
+      std::is_same<T, std::int64_t>::value || std::is_same<T, std::uint64_t>::value ||
+      std::is_same<T, float>::value || std::is_same<T, double>::value;
+
+   //    highest level the kernels may use, e.g. to compare levels
+   inline isa& isa_limit() noexcept
+   {
+      static isa limit = isa::avx512;
+      return limit;
+   }
+   inline isa detect() noexcept
+   {
+#if SDA_SIMD_X86
+      static const isa level = []
+      {
+         __builtin_cpu_init();
+         if(__builtin_cpu_supports("avx512f")) return isa::avx512;
+         if(__builtin_cpu_supports("avx2")) return isa::avx2;
+         return isa::scalar;
+      }();
+      return std::min(level, isa_limit());
+#else
+      return isa::scalar;
+#endif
+   }
+
+
+   //-------------------------------------------
+   //    SCALAR
+   //-------------------------------------------
+   namespace scalar
+   {
+      template<class T>
+      std::size_t find(const T* p, std::size_t n, T value, std::size_t)
+      {
+         return std::find(p, p + n, value) - p;
+      }
+      template<class T>
+      std::size_t find_between(const T* p, std::size_t n, T lo, T hi, std::size_t)
+      {
+         return std::find_if(p, p + n, [lo, hi](const T& x) { return !(x < lo) && !(hi < x); }) - p;
+      }
+      template<class T>
+      std::size_t count(const T* p, std::size_t n, T value, std::size_t)
+      {
+         return std::count(p, p + n, value);
+      }
+      template<class T>
+      T min(const T* p, std::size_t n)
+      {
+         return *std::min_element(p, p + n);
+      }
+      template<class T>
+      T max(const T* p, std::size_t n)
+      {
+         return *std::max_element(p, p + n);
+      }
+      template<class T>
+      sum_type<T> sum(const T* p, std::size_t n)
+      {
+         sum_type<T> s = 0;
+         for(std::size_t i = 0; i < n; i++) s += p[i];
+         return s;
+      }
+      template<class T>
+      void prefix_sum(T* p, std::size_t n)
+      {
+         for(std::size_t i = 1; i < n; i++) p[i] += p[i - 1];
+      }
+   }
+
+
+#if SDA_SIMD_X86
+   //-------------------------------------------
+   //    KERNELS
+   //    one copy per instruction set, over the
+   //    vec<T> of its namespace
+   //-------------------------------------------
+#define SDA_SIMD_KERNELS(TARGET)                                                    \
+   template<class T>                                                                \
+   TARGET std::size_t find(const T* p, std::size_t n, T value, std::size_t slack)   \
+   {                                                                                \
+      typedef vec<T> V;                                                             \
+      typename V::reg v = V::set1(value);                                           \
+      std::size_t i = 0;                                                            \
+      for(; i + V::lanes <= n; i += V::lanes)                                       \
+         if(unsigned m = V::eq(V::load(p + i), v))                                  \
+            return i + __builtin_ctz(m);                                            \
+      if(i < n && i + V::lanes <= n + slack)                                        \
+      {                                                                             \
+         unsigned m = V::eq(V::load(p + i), v) & ((1u << (n - i)) - 1);             \
+         return m ? i + __builtin_ctz(m) : n;                                       \
+      }                                                                             \
+      return i + scalar::find(p + i, n - i, value, 0);                              \
+   }                                                                                \
+   template<class T>                                                                \
+   TARGET std::size_t find_between(const T* p, std::size_t n, T lo, T hi,           \
+      std::size_t slack)                                                            \
+   {                                                                                \
+      typedef vec<T> V;                                                             \
+      typename V::reg l = V::set1(lo);                                              \
+      typename V::reg h = V::set1(hi);                                              \
+      constexpr unsigned all = (1u << V::lanes) - 1;                                \
+      std::size_t i = 0;                                                            \
+      for(; i + V::lanes <= n; i += V::lanes)                                       \
+      {                                                                             \
+         typename V::reg x = V::load(p + i);                                        \
+         if(unsigned m = ~(V::gt(l, x) | V::gt(x, h)) & all)                        \
+            return i + __builtin_ctz(m);                                            \
+      }                                                                             \
+      if(i < n && i + V::lanes <= n + slack)                                        \
+      {                                                                             \
+         typename V::reg x = V::load(p + i);                                        \
+         unsigned m = ~(V::gt(l, x) | V::gt(x, h)) & ((1u << (n - i)) - 1);         \
+         return m ? i + __builtin_ctz(m) : n;                                       \
+      }                                                                             \
+      return i + scalar::find_between(p + i, n - i, lo, hi, 0);                     \
+   }                                                                                \
+   template<class T>                                                                \
+   TARGET std::size_t count(const T* p, std::size_t n, T value, std::size_t slack)  \
+   {                                                                                \
+      typedef vec<T> V;                                                             \
+      typename V::reg v = V::set1(value);                                           \
+      std::size_t c = 0;                                                            \
+      std::size_t i = 0;                                                            \
+      for(; i + V::lanes <= n; i += V::lanes)                                       \
+         c += __builtin_popcount(V::eq(V::load(p + i), v));                         \
+      if(i < n && i + V::lanes <= n + slack)                                        \
+         return c + __builtin_popcount(V::eq(V::load(p + i), v)                     \
+            & ((1u << (n - i)) - 1));                                               \
+      return c + scalar::count(p + i, n - i, value, 0);                             \
+   }                                                                                \
+   template<class T, bool Max>                                                      \
+   TARGET T extreme(const T* p, std::size_t n)                                      \
+   {                                                                                \
+      typedef vec<T> V;                                                             \
+      if(n < V::lanes)                                                              \
+         return Max ? scalar::max(p, n) : scalar::min(p, n);                        \
+      typename V::reg r = V::load(p);                                               \
+      std::size_t i = V::lanes;                                                     \
+      for(; i + V::lanes <= n; i += V::lanes)                                       \
+         r = Max ? V::max(r, V::load(p + i)) : V::min(r, V::load(p + i));           \
+      if(i < n)                                                                     \
+         r = Max ? V::max(r, V::load(p + n - V::lanes))                             \
+                 : V::min(r, V::load(p + n - V::lanes));                            \
+      T lanes[V::lanes];                                                            \
+      V::store(lanes, r);                                                           \
+      return Max ? scalar::max(lanes, V::lanes) : scalar::min(lanes, V::lanes);     \
+   }                                                                                \
+   template<class T>                                                                \
+   TARGET T min(const T* p, std::size_t n)                                          \
+   {                                                                                \
+      return extreme<T, false>(p, n);                                               \
+   }                                                                                \
+   template<class T>                                                                \
+   TARGET T max(const T* p, std::size_t n)                                          \
+   {                                                                                \
+      return extreme<T, true>(p, n);                                                \
+   }                                                                                \
+   template<class T>                                                                \
+   TARGET sum_type<T> sum(const T* p, std::size_t n)                                \
+   {                                                                                \
+      typedef vec<T> V;                                                             \
+      typename V::acc a = V::acc_zero();                                            \
+      std::size_t i = 0;                                                            \
+      for(; i + V::lanes <= n; i += V::lanes)                                       \
+         a = V::acc_add(a, V::load(p + i));                                         \
+      sum_type<T> lanes[V::lanes];                                                  \
+      V::acc_store(lanes, a);                                                       \
+      return scalar::sum(lanes, V::lanes) + scalar::sum(p + i, n - i);              \
+   }                                                                                \
+   template<class T>                                                                \
+   TARGET void prefix_sum(T* p, std::size_t n)                                      \
+   {                                                                                \
+      typedef vec<T> V;                                                             \
+      typename V::reg carry = V::set1(T(0));                                        \
+      std::size_t i = 0;                                                            \
+      for(; i + V::lanes <= n; i += V::lanes)                                       \
+      {                                                                             \
+         typename V::reg x = V::add(V::scan(V::load(p + i)), carry);                \
+         V::store(p + i, x);                                                        \
+         carry = V::last(x);                                                        \
+      }                                                                             \
+      for(; i < n; i++)                                                             \
+         p[i] += i ? p[i - 1] : T(0);                                               \
+   }
+
+
+   //-------------------------------------------
+   //    AVX2
+   //-------------------------------------------
+   namespace avx2
+   {
+#define SDA_AVX2 inline __attribute__((target("avx2")))
+
+      template<class T>
+      struct vec;
+
+      //    integers in 256-bit registers, what differs between the
+      //    element types is passed in by the specializations
+      template<class T, class Derived>
+      struct int_vec
+      {
+         typedef __m256i reg;
+         static constexpr std::size_t lanes = 32 / sizeof(T);
+
+         SDA_AVX2 static reg load(const T* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+         SDA_AVX2 static void store(T* p, reg x) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), x); }
+         SDA_AVX2 static unsigned bits(reg m)
+         {
+            if constexpr (sizeof(T) == 4) return _mm256_movemask_ps(_mm256_castsi256_ps(m));
+            else return _mm256_movemask_pd(_mm256_castsi256_pd(m));
+         }
+         SDA_AVX2 static unsigned eq(reg a, reg b)
+         {
+            if constexpr (sizeof(T) == 4) return bits(_mm256_cmpeq_epi32(a, b));
+            else return bits(_mm256_cmpeq_epi64(a, b));
+         }
+         SDA_AVX2 static unsigned gt(reg a, reg b) { return bits(Derived::gt_mask(a, b)); }
+         SDA_AVX2 static reg add(reg a, reg b)
+         {
+            if constexpr (sizeof(T) == 4) return _mm256_add_epi32(a, b);
+            else return _mm256_add_epi64(a, b);
+         }
+         //    inclusive scan inside the register
+         SDA_AVX2 static reg scan(reg x)
+         {
+            if constexpr (sizeof(T) == 4)
+            {
+               x = add(x, _mm256_slli_si256(x, 4));
+               x = add(x, _mm256_slli_si256(x, 8));
+               return add(x, _mm256_shuffle_epi32(_mm256_permute2x128_si256(x, x, 0x08), 0xFF));
+            }
+            else
+            {
+               x = add(x, _mm256_slli_si256(x, 8));
+               return add(x, _mm256_shuffle_epi32(_mm256_permute2x128_si256(x, x, 0x08), 0xEE));
+            }
+         }
+         //    last lane in every lane
+         SDA_AVX2 static reg last(reg x)
+         {
+            if constexpr (sizeof(T) == 4) return _mm256_permutevar8x32_epi32(x, _mm256_set1_epi32(7));
+            else return _mm256_permute4x64_epi64(x, 0xFF);
+         }
+      };
+
+      template<>
+      struct vec<std::int32_t> : int_vec<std::int32_t, vec<std::int32_t>>
+      {
+         struct acc { __m256i lo, hi; };
+         SDA_AVX2 static reg set1(std::int32_t v) { return _mm256_set1_epi32(v); }
+         SDA_AVX2 static reg gt_mask(reg a, reg b) { return _mm256_cmpgt_epi32(a, b); }
+         SDA_AVX2 static reg min(reg a, reg b) { return _mm256_min_epi32(a, b); }
+         SDA_AVX2 static reg max(reg a, reg b) { return _mm256_max_epi32(a, b); }
+         SDA_AVX2 static acc acc_zero() { return acc{_mm256_setzero_si256(), _mm256_setzero_si256()}; }
+         SDA_AVX2 static acc acc_add(acc a, reg x)
+         {
+            a.lo = _mm256_add_epi64(a.lo, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(x)));
+            a.hi = _mm256_add_epi64(a.hi, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(x, 1)));
+            return a;
+         }
+         SDA_AVX2 static void acc_store(std::int64_t* p, acc a)
+         {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), a.lo);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(p + 4), a.hi);
+         }
+      };
+      template<>
+      struct vec<std::uint32_t> : int_vec<std::uint32_t, vec<std::uint32_t>>
+      {
+         struct acc { __m256i lo, hi; };
+         SDA_AVX2 static reg set1(std::uint32_t v) { return _mm256_set1_epi32(static_cast<int>(v)); }
+         SDA_AVX2 static reg gt_mask(reg a, reg b)
+         {
+            reg bias = _mm256_set1_epi32(INT32_MIN);
+            return _mm256_cmpgt_epi32(_mm256_xor_si256(a, bias), _mm256_xor_si256(b, bias));
+         }
+         SDA_AVX2 static reg min(reg a, reg b) { return _mm256_min_epu32(a, b); }
+         SDA_AVX2 static reg max(reg a, reg b) { return _mm256_max_epu32(a, b); }
+         SDA_AVX2 static acc acc_zero() { return acc{_mm256_setzero_si256(), _mm256_setzero_si256()}; }
+         SDA_AVX2 static acc acc_add(acc a, reg x)
+         {
+            a.lo = _mm256_add_epi64(a.lo, _mm256_cvtepu32_epi64(_mm256_castsi256_si128(x)));
+            a.hi = _mm256_add_epi64(a.hi, _mm256_cvtepu32_epi64(_mm256_extracti128_si256(x, 1)));
+            return a;
+         }
+         SDA_AVX2 static void acc_store(std::uint64_t* p, acc a)
+         {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), a.lo);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(p + 4), a.hi);
+         }
+      };
+      //    no 64-bit min / max before AVX-512: compare and blend
+      template<class T>
+      struct int64_vec : int_vec<T, vec<T>>
+      {
+         typedef __m256i reg;
+         typedef __m256i acc;
+         SDA_AVX2 static reg set1(T v) { return _mm256_set1_epi64x(static_cast<long long>(v)); }
+         SDA_AVX2 static reg gt_mask(reg a, reg b)
+         {
+            if constexpr (std::is_signed<T>::value) return _mm256_cmpgt_epi64(a, b);
+            reg bias = _mm256_set1_epi64x(INT64_MIN);
+            return _mm256_cmpgt_epi64(_mm256_xor_si256(a, bias), _mm256_xor_si256(b, bias));
+         }
+         SDA_AVX2 static reg min(reg a, reg b) { return _mm256_blendv_epi8(a, b, gt_mask(a, b)); }
+         SDA_AVX2 static reg max(reg a, reg b) { return _mm256_blendv_epi8(b, a, gt_mask(a, b)); }
+         SDA_AVX2 static acc acc_zero() { return _mm256_setzero_si256(); }
+         SDA_AVX2 static acc acc_add(acc a, reg x) { return _mm256_add_epi64(a, x); }
+         SDA_AVX2 static void acc_store(T* p, acc a) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), a); }
+      };
+      template<>
+      struct vec<std::int64_t> : int64_vec<std::int64_t> {};
+      template<>
+      struct vec<std::uint64_t> : int64_vec<std::uint64_t> {};
+
+      template<>
+      struct vec<float>
+      {
+         typedef __m256 reg;
+         typedef __m256 acc;
+         static constexpr std::size_t lanes = 8;
+
+         SDA_AVX2 static reg load(const float* p) { return _mm256_loadu_ps(p); }
+         SDA_AVX2 static void store(float* p, reg x) { _mm256_storeu_ps(p, x); }
+         SDA_AVX2 static reg set1(float v) { return _mm256_set1_ps(v); }
+         SDA_AVX2 static unsigned eq(reg a, reg b) { return _mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_EQ_OQ)); }
+         SDA_AVX2 static unsigned gt(reg a, reg b) { return _mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_GT_OQ)); }
+         SDA_AVX2 static reg min(reg a, reg b) { return _mm256_min_ps(a, b); }
+         SDA_AVX2 static reg max(reg a, reg b) { return _mm256_max_ps(a, b); }
+         SDA_AVX2 static reg add(reg a, reg b) { return _mm256_add_ps(a, b); }
+         SDA_AVX2 static reg scan(reg x)
+         {
+            x = add(x, _mm256_castsi256_ps(_mm256_slli_si256(_mm256_castps_si256(x), 4)));
+            x = add(x, _mm256_castsi256_ps(_mm256_slli_si256(_mm256_castps_si256(x), 8)));
+            reg t = _mm256_permute2f128_ps(x, x, 0x08);
+            return add(x, _mm256_shuffle_ps(t, t, 0xFF));
+         }
+         SDA_AVX2 static reg last(reg x) { return _mm256_permutevar8x32_ps(x, _mm256_set1_epi32(7)); }
+         SDA_AVX2 static acc acc_zero() { return _mm256_setzero_ps(); }
+         SDA_AVX2 static acc acc_add(acc a, reg x) { return _mm256_add_ps(a, x); }
+         SDA_AVX2 static void acc_store(float* p, acc a) { _mm256_storeu_ps(p, a); }
+      };
+      template<>
+      struct vec<double>
+      {
+         typedef __m256d reg;
+         typedef __m256d acc;
+         static constexpr std::size_t lanes = 4;
+
+         SDA_AVX2 static reg load(const double* p) { return _mm256_loadu_pd(p); }
+         SDA_AVX2 static void store(double* p, reg x) { _mm256_storeu_pd(p, x); }
+         SDA_AVX2 static reg set1(double v) { return _mm256_set1_pd(v); }
+         SDA_AVX2 static unsigned eq(reg a, reg b) { return _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_EQ_OQ)); }
+         SDA_AVX2 static unsigned gt(reg a, reg b) { return _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_GT_OQ)); }
+         SDA_AVX2 static reg min(reg a, reg b) { return _mm256_min_pd(a, b); }
+         SDA_AVX2 static reg max(reg a, reg b) { return _mm256_max_pd(a, b); }
+         SDA_AVX2 static reg add(reg a, reg b) { return _mm256_add_pd(a, b); }
+         SDA_AVX2 static reg scan(reg x)
+         {
+            x = add(x, _mm256_castsi256_pd(_mm256_slli_si256(_mm256_castpd_si256(x), 8)));
+            reg t = _mm256_permute2f128_pd(x, x, 0x08);
+            return add(x, _mm256_shuffle_pd(t, t, 0xF));
+         }
+         SDA_AVX2 static reg last(reg x) { return _mm256_permute4x64_pd(x, 0xFF); }
+         SDA_AVX2 static acc acc_zero() { return _mm256_setzero_pd(); }
+         SDA_AVX2 static acc acc_add(acc a, reg x) { return _mm256_add_pd(a, x); }
+         SDA_AVX2 static void acc_store(double* p, acc a) { _mm256_storeu_pd(p, a); }
+      };
+
+      SDA_SIMD_KERNELS(SDA_AVX2)
+
+#undef SDA_AVX2
+   }
+
+
+   //-------------------------------------------
+   //    AVX-512
+   //-------------------------------------------
+   namespace avx512
+   {
+#define SDA_AVX512 inline __attribute__((target("avx512f")))
+
+      template<class T>
+      struct vec;
+
+      template<class T>
+      struct int_vec
+      {
+         typedef __m512i reg;
+         static constexpr std::size_t lanes = 64 / sizeof(T);
+
+         SDA_AVX512 static reg load(const T* p) { return _mm512_loadu_si512(p); }
+         SDA_AVX512 static void store(T* p, reg x) { _mm512_storeu_si512(p, x); }
+         SDA_AVX512 static reg add(reg a, reg b)
+         {
+            if constexpr (sizeof(T) == 4) return _mm512_add_epi32(a, b);
+            else return _mm512_add_epi64(a, b);
+         }
+         //    lanes shifted up by k, zeros below
+         SDA_AVX512 static reg scan(reg x)
+         {
+            reg z = _mm512_setzero_si512();
+            if constexpr (sizeof(T) == 4)
+            {
+               x = add(x, _mm512_alignr_epi32(x, z, 15));
+               x = add(x, _mm512_alignr_epi32(x, z, 14));
+               x = add(x, _mm512_alignr_epi32(x, z, 12));
+               return add(x, _mm512_alignr_epi32(x, z, 8));
+            }
+            else
+            {
+               x = add(x, _mm512_alignr_epi64(x, z, 7));
+               x = add(x, _mm512_alignr_epi64(x, z, 6));
+               return add(x, _mm512_alignr_epi64(x, z, 4));
+            }
+         }
+         SDA_AVX512 static reg last(reg x)
+         {
+            if constexpr (sizeof(T) == 4) return _mm512_permutexvar_epi32(_mm512_set1_epi32(15), x);
+            else return _mm512_permutexvar_epi64(_mm512_set1_epi64(7), x);
+         }
+      };
+
+      template<>
+      struct vec<std::int32_t> : int_vec<std::int32_t>
+      {
+         struct acc { __m512i lo, hi; };
+         SDA_AVX512 static reg set1(std::int32_t v) { return _mm512_set1_epi32(v); }
+         SDA_AVX512 static unsigned eq(reg a, reg b) { return _mm512_cmpeq_epi32_mask(a, b); }
+         SDA_AVX512 static unsigned gt(reg a, reg b) { return _mm512_cmpgt_epi32_mask(a, b); }
+         SDA_AVX512 static reg min(reg a, reg b) { return _mm512_min_epi32(a, b); }
+         SDA_AVX512 static reg max(reg a, reg b) { return _mm512_max_epi32(a, b); }
+         SDA_AVX512 static acc acc_zero() { return acc{_mm512_setzero_si512(), _mm512_setzero_si512()}; }
+         SDA_AVX512 static acc acc_add(acc a, reg x)
+         {
+            a.lo = _mm512_add_epi64(a.lo, _mm512_cvtepi32_epi64(_mm512_castsi512_si256(x)));
+            a.hi = _mm512_add_epi64(a.hi, _mm512_cvtepi32_epi64(_mm512_extracti64x4_epi64(x, 1)));
+            return a;
+         }
+         SDA_AVX512 static void acc_store(std::int64_t* p, acc a)
+         {
+            _mm512_storeu_si512(p, a.lo);
+            _mm512_storeu_si512(p + 8, a.hi);
+         }
+      };
+      template<>
+      struct vec<std::uint32_t> : int_vec<std::uint32_t>
+      {
+         struct acc { __m512i lo, hi; };
+         SDA_AVX512 static reg set1(std::uint32_t v) { return _mm512_set1_epi32(static_cast<int>(v)); }
+         SDA_AVX512 static unsigned eq(reg a, reg b) { return _mm512_cmpeq_epu32_mask(a, b); }
+         SDA_AVX512 static unsigned gt(reg a, reg b) { return _mm512_cmpgt_epu32_mask(a, b); }
+         SDA_AVX512 static reg min(reg a, reg b) { return _mm512_min_epu32(a, b); }
+         SDA_AVX512 static reg max(reg a, reg b) { return _mm512_max_epu32(a, b); }
+         SDA_AVX512 static acc acc_zero() { return acc{_mm512_setzero_si512(), _mm512_setzero_si512()}; }
+         SDA_AVX512 static acc acc_add(acc a, reg x)
+         {
+            a.lo = _mm512_add_epi64(a.lo, _mm512_cvtepu32_epi64(_mm512_castsi512_si256(x)));
+            a.hi = _mm512_add_epi64(a.hi, _mm512_cvtepu32_epi64(_mm512_extracti64x4_epi64(x, 1)));
+            return a;
+         }
+         SDA_AVX512 static void acc_store(std::uint64_t* p, acc a)
+         {
+            _mm512_storeu_si512(p, a.lo);
+            _mm512_storeu_si512(p + 8, a.hi);
+         }
+      };
+      template<>
+      struct vec<std::int64_t> : int_vec<std::int64_t>
+      {
+         typedef __m512i acc;
+         SDA_AVX512 static reg set1(std::int64_t v) { return _mm512_set1_epi64(v); }
+         SDA_AVX512 static unsigned eq(reg a, reg b) { return _mm512_cmpeq_epi64_mask(a, b); }
+         SDA_AVX512 static unsigned gt(reg a, reg b) { return _mm512_cmpgt_epi64_mask(a, b); }
+         SDA_AVX512 static reg min(reg a, reg b) { return _mm512_min_epi64(a, b); }
+         SDA_AVX512 static reg max(reg a, reg b) { return _mm512_max_epi64(a, b); }
+         SDA_AVX512 static acc acc_zero() { return _mm512_setzero_si512(); }
+         SDA_AVX512 static acc acc_add(acc a, reg x) { return _mm512_add_epi64(a, x); }
+         SDA_AVX512 static void acc_store(std::int64_t* p, acc a) { _mm512_storeu_si512(p, a); }
+      };
+      template<>
+      struct vec<std::uint64_t> : int_vec<std::uint64_t>
+      {
+         typedef __m512i acc;
+         SDA_AVX512 static reg set1(std::uint64_t v) { return _mm512_set1_epi64(static_cast<long long>(v)); }
+         SDA_AVX512 static unsigned eq(reg a, reg b) { return _mm512_cmpeq_epu64_mask(a, b); }
+         SDA_AVX512 static unsigned gt(reg a, reg b) { return _mm512_cmpgt_epu64_mask(a, b); }
+         SDA_AVX512 static reg min(reg a, reg b) { return _mm512_min_epu64(a, b); }
+         SDA_AVX512 static reg max(reg a, reg b) { return _mm512_max_epu64(a, b); }
+         SDA_AVX512 static acc acc_zero() { return _mm512_setzero_si512(); }
+         SDA_AVX512 static acc acc_add(acc a, reg x) { return _mm512_add_epi64(a, x); }
+         SDA_AVX512 static void acc_store(std::uint64_t* p, acc a) { _mm512_storeu_si512(p, a); }
+      };
+
+      template<>
+      struct vec<float>
+      {
+         typedef __m512 reg;
+         typedef __m512 acc;
+         static constexpr std::size_t lanes = 16;
+
+         SDA_AVX512 static reg load(const float* p) { return _mm512_loadu_ps(p); }
+         SDA_AVX512 static void store(float* p, reg x) { _mm512_storeu_ps(p, x); }
+         SDA_AVX512 static reg set1(float v) { return _mm512_set1_ps(v); }
+         SDA_AVX512 static unsigned eq(reg a, reg b) { return _mm512_cmp_ps_mask(a, b, _CMP_EQ_OQ); }
+         SDA_AVX512 static unsigned gt(reg a, reg b) { return _mm512_cmp_ps_mask(a, b, _CMP_GT_OQ); }
+         SDA_AVX512 static reg min(reg a, reg b) { return _mm512_min_ps(a, b); }
+         SDA_AVX512 static reg max(reg a, reg b) { return _mm512_max_ps(a, b); }
+         SDA_AVX512 static reg add(reg a, reg b) { return _mm512_add_ps(a, b); }
+         SDA_AVX512 static reg scan(reg x)
+         {
+            __m512i z = _mm512_setzero_si512();
+            x = add(x, _mm512_castsi512_ps(_mm512_alignr_epi32(_mm512_castps_si512(x), z, 15)));
+            x = add(x, _mm512_castsi512_ps(_mm512_alignr_epi32(_mm512_castps_si512(x), z, 14)));
+            x = add(x, _mm512_castsi512_ps(_mm512_alignr_epi32(_mm512_castps_si512(x), z, 12)));
+            return add(x, _mm512_castsi512_ps(_mm512_alignr_epi32(_mm512_castps_si512(x), z, 8)));
+         }
+         SDA_AVX512 static reg last(reg x) { return _mm512_permutexvar_ps(_mm512_set1_epi32(15), x); }
+         SDA_AVX512 static acc acc_zero() { return _mm512_setzero_ps(); }
+         SDA_AVX512 static acc acc_add(acc a, reg x) { return _mm512_add_ps(a, x); }
+         SDA_AVX512 static void acc_store(float* p, acc a) { _mm512_storeu_ps(p, a); }
+      };
+      template<>
+      struct vec<double>
+      {
+         typedef __m512d reg;
+         typedef __m512d acc;
+         static constexpr std::size_t lanes = 8;
+
+         SDA_AVX512 static reg load(const double* p) { return _mm512_loadu_pd(p); }
+         SDA_AVX512 static void store(double* p, reg x) { _mm512_storeu_pd(p, x); }
+         SDA_AVX512 static reg set1(double v) { return _mm512_set1_pd(v); }
+         SDA_AVX512 static unsigned eq(reg a, reg b) { return _mm512_cmp_pd_mask(a, b, _CMP_EQ_OQ); }
+         SDA_AVX512 static unsigned gt(reg a, reg b) { return _mm512_cmp_pd_mask(a, b, _CMP_GT_OQ); }
+         SDA_AVX512 static reg min(reg a, reg b) { return _mm512_min_pd(a, b); }
+         SDA_AVX512 static reg max(reg a, reg b) { return _mm512_max_pd(a, b); }
+         SDA_AVX512 static reg add(reg a, reg b) { return _mm512_add_pd(a, b); }
+         SDA_AVX512 static reg scan(reg x)
+         {
+            __m512i z = _mm512_setzero_si512();
+            x = add(x, _mm512_castsi512_pd(_mm512_alignr_epi64(_mm512_castpd_si512(x), z, 7)));
+            x = add(x, _mm512_castsi512_pd(_mm512_alignr_epi64(_mm512_castpd_si512(x), z, 6)));
+            return add(x, _mm512_castsi512_pd(_mm512_alignr_epi64(_mm512_castpd_si512(x), z, 4)));
+         }
+         SDA_AVX512 static reg last(reg x) { return _mm512_permutexvar_pd(_mm512_set1_epi64(7), x); }
+         SDA_AVX512 static acc acc_zero() { return _mm512_setzero_pd(); }
+         SDA_AVX512 static acc acc_add(acc a, reg x) { return _mm512_add_pd(a, x); }
+         SDA_AVX512 static void acc_store(double* p, acc a) { _mm512_storeu_pd(p, a); }
+      };
+
+      SDA_SIMD_KERNELS(SDA_AVX512)
+
+#undef SDA_AVX512
+   }
+
+#undef SDA_SIMD_KERNELS
+
+//    call the best kernel for T, plain loops otherwise
+#define SDA_SIMD_DISPATCH(T, CALL)                                \
+   if constexpr (vectorized<T>)                                   \
+      switch(detect())                                            \
+      {                                                           \
+         case isa::avx512: return avx512::CALL;                   \
+         case isa::avx2: return avx2::CALL;                       \
+         default: break;                                          \
+      }
+#else
+#define SDA_SIMD_DISPATCH(T, CALL)
+#endif
+
+
+   //-------------------------------------------
+   //    POINTER RANGES
+   //    slack : elements readable past p + n
+   //-------------------------------------------
+   template<class T>
+   std::size_t find(const T* p, std::size_t n, T value, std::size_t slack = 0)
+   {
+      SDA_SIMD_DISPATCH(T, find(p, n, value, slack))
+      return scalar::find(p, n, value, slack);
+   }
+   template<class T>
+   std::size_t find_between(const T* p, std::size_t n, T lo, T hi, std::size_t slack = 0)
+   {
+      SDA_SIMD_DISPATCH(T, find_between(p, n, lo, hi, slack))
+      return scalar::find_between(p, n, lo, hi, slack);
+   }
+   template<class T>
+   std::size_t count(const T* p, std::size_t n, T value, std::size_t slack = 0)
+   {
+      SDA_SIMD_DISPATCH(T, count(p, n, value, slack))
+      return scalar::count(p, n, value, slack);
+   }
+   //    n > 0
+   template<class T>
+   T min(const T* p, std::size_t n)
+   {
+      SDA_SIMD_DISPATCH(T, min(p, n))
+      return scalar::min(p, n);
+   }
+   template<class T>
+   T max(const T* p, std::size_t n)
+   {
+      SDA_SIMD_DISPATCH(T, max(p, n))
+      return scalar::max(p, n);
+   }
+   template<class T>
+   sum_type<T> sum(const T* p, std::size_t n)
+   {
+      SDA_SIMD_DISPATCH(T, sum(p, n))
+      return scalar::sum(p, n);
+   }
+   template<class T>
+   void prefix_sum(T* p, std::size_t n)
+   {
+      SDA_SIMD_DISPATCH(T, prefix_sum(p, n))
+      scalar::prefix_sum(p, n);
+   }
+
+#undef SDA_SIMD_DISPATCH
+
+
+   //-------------------------------------------
+   //    SDA
+   //    find* return end() when nothing matches,
+   //    min, max, argmin, argmax need a non-empty
+   //    array
+   //-------------------------------------------
+   template<class T, class Allocator, class Policy>
+   const T* first(const sda<T, Allocator, Policy>& a) noexcept
+   {
+      return a.empty() ? nullptr : std::addressof(*a.begin());
+   }
+   template<class T, class Allocator, class Policy>
+   typename sda<T, Allocator, Policy>::const_iterator find(const sda<T, Allocator, Policy>& a, const T& value)
+   {
+      return a.begin() + find(first(a), a.size(), value, a.empty_back_capacity());
+   }
+   //    first element in [lo, hi]
+   template<class T, class Allocator, class Policy>
+   typename sda<T, Allocator, Policy>::const_iterator find_between(const sda<T, Allocator, Policy>& a,
+      const T& lo, const T& hi)
+   {
+      return a.begin() + find_between(first(a), a.size(), lo, hi, a.empty_back_capacity());
+   }
+   //    any predicate: std::find_if
+   template<class T, class Allocator, class Policy, class Predicate>
+   typename sda<T, Allocator, Policy>::const_iterator find_if(const sda<T, Allocator, Policy>& a, Predicate pred)
+   {
+      return std::find_if(a.begin(), a.end(), pred);
+   }
+   template<class T, class Allocator, class Policy>
+   std::size_t count(const sda<T, Allocator, Policy>& a, const T& value)
+   {
+      return count(first(a), a.size(), value, a.empty_back_capacity());
+   }
+   template<class T, class Allocator, class Policy>
+   T min(const sda<T, Allocator, Policy>& a)
+   {
+      return min(first(a), a.size());
+   }
+   template<class T, class Allocator, class Policy>
+   T max(const sda<T, Allocator, Policy>& a)
+   {
+      return max(first(a), a.size());
+   }
+   //    index of the first smallest / largest element
+   template<class T, class Allocator, class Policy>
+   std::size_t argmin(const sda<T, Allocator, Policy>& a)
+   {
+      return find(first(a), a.size(), min(a), a.empty_back_capacity());
+   }
+   template<class T, class Allocator, class Policy>
+   std::size_t argmax(const sda<T, Allocator, Policy>& a)
+   {
+      return find(first(a), a.size(), max(a), a.empty_back_capacity());
+   }
+   template<class T, class Allocator, class Policy>
+   sum_type<T> sum(const sda<T, Allocator, Policy>& a)
+   {
+      return sum(first(a), a.size());
+   }
+   template<class T, class Allocator, class Policy>
+   void prefix_sum(sda<T, Allocator, Policy>& a)
+   {
+      if(!a.empty()) prefix_sum(std::addressof(*a.begin()), a.size());
+   }
+}
+
+
+#endif
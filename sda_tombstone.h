@@ -0,0 +1,600 @@
+/*
+MIT License
+
+Copyright 2020 Than Minh Duy (macodeth)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+OR OTHER DEALINGS IN THE SOFTWARE.
+
+*/
+
+
+#ifndef SYMMETRIC_DYNAMIC_ARRAY_TOMBSTONE
+#define SYMMETRIC_DYNAMIC_ARRAY_TOMBSTONE
+
+
+
+#include<algorithm>
+#include<cstddef>
+#include<cstdint>
+#include<initializer_list>
+#include<iterator>
+#include<memory>
+#include<stdexcept>
+#include<type_traits>
+#include<utility>
+
+#include "sda.h"
+
+
+
+//
+//    lazy erase: an erased element stays in the array as a
+//    tombstone, a bitmap tells live slots from dead ones and a
+//    Fenwick tree of live counts per 64-slot word finds the
+//    n-th live element in O(log n)
+//
+//       array_ : a  b  c  d  e  f  g  h
+//       live_  : 1  0  1  1  0  0  1  1      operator[](3) = g
+//
+//    the bitmap has free words at both ends so push_front and
+//    push_back keep working, both ends of the array are always
+//    live: erasing there pops for real, tombstones next to an
+//    end are popped with it
+//
+//    once tombstones exceed dead_percent of the array, one pass
+//    packs the front half toward the middle and the back half
+//    toward the middle, each live element moves at most once
+//
+//    an insert in the middle shifts the elements between pos and
+//    the nearest tombstone and revives it, the other live elements
+//    stay in place; an erased element is reset to value_type() at
+//    once, so what it owns is released before compaction
+//
+//    no bitmap until the first tombstone: reads go straight to the
+//    array
+//
+
+
+template<class T, class Allocator = std::allocator<T>>
+class sda_tombstone
+{
+   public:
+   typedef sda<T, Allocator> array_type;
+   typedef typename array_type::allocator_type allocator_type;
+   typedef typename array_type::value_type value_type;
+   typedef typename array_type::size_type size_type;
+   typedef typename array_type::difference_type difference_type;
+   typedef typename array_type::reference reference;
+   typedef typename array_type::const_reference const_reference;
+
+   static constexpr size_type default_dead_percent = 25;
+
+
+   private:
+   typedef std::uint64_t word_type;
+
+   array_type array_;
+   sda<word_type> live_;         // empty while there is no tombstone
+   sda<size_type> tree_;         // Fenwick tree over live_, 1-based
+   size_type origin_ = 0;        // bit of array_[0]
+   size_type dead_ = 0;
+   size_type dead_percent_ = default_dead_percent;
+
+
+   //-------------------------
+   //    BITS
+   //-------------------------
+   static size_type popcount(word_type w) noexcept
+   {
+#if defined(__GNUC__) || defined(__clang__)
+      return __builtin_popcountll(w);
+#else
+      size_type n = 0;
+      for(; w; w &= w - 1) n++;
+      return n;
+#endif
+   }
+   static size_type lowest_bit(word_type w) noexcept
+   {
+      return popcount((w & (~w + 1)) - 1);
+   }
+   static size_type highest_bit(word_type w) noexcept
+   {
+      size_type n = 0;
+      while(w >>= 1) n++;
+      return n;
+   }
+
+   bool clean() const noexcept
+   {
+      return live_.empty();
+   }
+   bool live(size_type i) const noexcept
+   {
+      size_type b = origin_ + i;
+      return live_[b >> 6] >> (b & 63) & 1;
+   }
+   void add(size_type word, size_type delta) noexcept
+   {
+      for(size_type i = word + 1; i < tree_.size(); i += i & (~i + 1)) tree_[i] += delta;
+   }
+   void set_live(size_type i, bool on) noexcept
+   {
+      size_type b = origin_ + i;
+      live_[b >> 6] ^= word_type(1) << (b & 63);
+      add(b >> 6, on ? 1 : size_type(-1));
+   }
+
+   //    bitmap of the whole array, a quarter of its words
+   //    free at each end, filled a word at a time
+   void open()
+   {
+      size_type words = (array_.size() + 63) / 64;
+      size_type room = words / 4 + 1;
+      live_.clear();
+      live_.resize_back(words + 2 * room, 0);
+      origin_ = room * 64;
+      size_type full = array_.size() / 64;
+      for(size_type k = 0; k < full; k++) live_[room + k] = ~word_type(0);
+      if(array_.size() % 64) live_[room + full] = (word_type(1) << (array_.size() % 64)) - 1;
+      tree_.clear();
+      tree_.resize_back(live_.size() + 1, 0);
+      for(size_type i = 1; i < tree_.size(); i++)
+      {
+         tree_[i] += popcount(live_[i - 1]);
+         size_type parent = i + (i & (~i + 1));
+         if(parent < tree_.size()) tree_[parent] += tree_[i];
+      }
+   }
+   void close() noexcept
+   {
+      live_.clear();
+      tree_.clear();
+      origin_ = 0;
+      dead_ = 0;
+   }
+
+   //    array_ index of the n-th live element
+   size_type select(size_type n) const noexcept
+   {
+      if(clean()) return n;
+      size_type step = 1;
+      while(step * 2 < tree_.size()) step *= 2;
+      size_type word = 0;
+      for(; step; step >>= 1)
+         if(word + step < tree_.size() && tree_[word + step] <= n)
+         {
+            word += step;
+            n -= tree_[word];
+         }
+      word_type w = live_[word];
+      for(; n; n--) w &= w - 1;
+      return word * 64 + lowest_bit(w) - origin_;
+   }
+   //    the array is never empty here and both ends are live
+   size_type next_live(size_type i) const noexcept
+   {
+      if(++i >= array_.size() || clean()) return i;
+      size_type b = origin_ + i;
+      size_type word = b >> 6;
+      word_type w = live_[word] & (~word_type(0) << (b & 63));
+      while(!w) w = live_[++word];
+      return word * 64 + lowest_bit(w) - origin_;
+   }
+   size_type prev_live(size_type i) const noexcept
+   {
+      if(clean() || i == array_.size()) return i - 1;
+      size_type b = origin_ + i - 1;
+      size_type word = b >> 6;
+      word_type w = live_[word] & (~word_type(0) >> (63 - (b & 63)));
+      while(!w) w = live_[--word];
+      return word * 64 + highest_bit(w) - origin_;
+   }
+   //    nearest dead slot before i / from i on, none if there
+   //    is none (the free words outside the array stop the scan)
+   static constexpr size_type none = size_type(-1);
+   size_type prev_dead(size_type i) const noexcept
+   {
+      size_type b = origin_ + i - 1;
+      size_type word = b >> 6;
+      word_type w = ~live_[word] & (~word_type(0) >> (63 - (b & 63)));
+      while(!w && word) w = ~live_[--word];
+      size_type d = word * 64 + highest_bit(w);
+      return w && d >= origin_ ? d - origin_ : none;
+   }
+   size_type next_dead(size_type i) const noexcept
+   {
+      size_type b = origin_ + i;
+      size_type word = b >> 6;
+      word_type w = ~live_[word] & (~word_type(0) << (b & 63));
+      while(!w && ++word < live_.size()) w = ~live_[word];
+      size_type d = word * 64 + lowest_bit(w) - origin_;
+      return w && d < array_.size() ? d : none;
+   }
+   //    word k of the bitmap becomes w, the tree follows
+   void set_word(size_type k, word_type w) noexcept
+   {
+      size_type before = popcount(live_[k]);
+      size_type after = popcount(w);
+      live_[k] = w;
+      if(after != before) add(k, after - before);
+   }
+   //    a live element was inserted at array_[i]: the bits above
+   //    it move up one place, or the bits below it down one place
+   //    (origin_ moves), whichever side is shorter and has room
+   void insert_bit(size_type i) noexcept
+   {
+      size_type n = array_.size() - 1;
+      bool up = (n - i <= i && origin_ + n < live_.size() * 64) || origin_ == 0;
+      if(up)
+      {
+         size_type b = origin_ + i;
+         size_type first = b >> 6;
+         for(size_type k = (origin_ + n) >> 6; k > first; k--)
+            set_word(k, live_[k] << 1 | live_[k - 1] >> 63);
+         word_type below = (word_type(1) << (b & 63)) - 1;
+         word_type w = live_[first];
+         set_word(first, (w & below) | (w & ~below) << 1 | word_type(1) << (b & 63));
+      }
+      else
+      {
+         origin_--;
+         size_type b = origin_ + i;
+         size_type last = b >> 6;
+         for(size_type k = origin_ >> 6; k < last; k++)
+            set_word(k, live_[k] >> 1 | live_[k + 1] << 63);
+         word_type above = (b & 63) == 63 ? 0 : ~word_type(0) << ((b & 63) + 1);
+         word_type w = live_[last];
+         set_word(last, (w >> 1 & ~above) | (w & above) | word_type(1) << (b & 63));
+      }
+   }
+   //    what a dead element owns goes now, not at compaction
+   void bury(size_type i)
+   {
+      if constexpr (!std::is_trivially_destructible<value_type>::value)
+         array_[i] = value_type();
+      else (void)i;
+   }
+
+   //    pop dead slots at both ends, the bitmap goes with
+   //    the last tombstone
+   void trim()
+   {
+      while(!array_.empty() && !live(array_.size() - 1))
+      {
+         array_.pop_back();
+         dead_--;
+      }
+      while(!array_.empty() && !live(0))
+      {
+         array_.pop_front();
+         origin_++;
+         dead_--;
+      }
+      if(dead_ == 0) close();
+   }
+   //    mark array_[i] dead, or pop it at an end
+   void kill(size_type i)
+   {
+      if(clean())
+      {
+         if(i == 0) return array_.pop_front();
+         if(i == array_.size() - 1) return array_.pop_back();
+         open();
+      }
+      set_live(i, false);
+      dead_++;
+      if(i == 0 || i == array_.size() - 1) trim();
+      else bury(i);
+   }
+   void check_dead()
+   {
+      if(dead_ * 100 > array_.size() * dead_percent_) compact();
+   }
+
+
+   public:
+   //    bidirectional, skips tombstones, invalidated by any change
+   template<bool Const>
+   class iterator_base
+   {
+      typedef typename std::conditional<Const, const sda_tombstone, sda_tombstone>::type owner;
+      owner* a_ = nullptr;
+      size_type i_ = 0;
+      friend class sda_tombstone;
+      template<bool> friend class iterator_base;
+      iterator_base(owner* a, size_type i) noexcept : a_(a), i_(i) {}
+
+      public:
+      typedef std::bidirectional_iterator_tag iterator_category;
+      typedef typename sda_tombstone::value_type value_type;
+      typedef typename sda_tombstone::difference_type difference_type;
+      typedef typename std::conditional<Const, const value_type*, value_type*>::type pointer;
+      typedef typename std::conditional<Const, const value_type&, value_type&>::type reference;
+
+      iterator_base() = default;
+      operator iterator_base<true>() const noexcept { return iterator_base<true>(a_, i_); }
+
+      reference operator*() const { return a_->array_[i_]; }
+      pointer operator->() const { return &a_->array_[i_]; }
+      iterator_base& operator++() noexcept { i_ = a_->next_live(i_); return *this; }
+      iterator_base& operator--() noexcept { i_ = a_->prev_live(i_); return *this; }
+      iterator_base operator++(int) noexcept { iterator_base t = *this; ++*this; return t; }
+      iterator_base operator--(int) noexcept { iterator_base t = *this; --*this; return t; }
+      bool operator==(const iterator_base& o) const noexcept { return i_ == o.i_; }
+      bool operator!=(const iterator_base& o) const noexcept { return i_ != o.i_; }
+   };
+   typedef iterator_base<false> iterator;
+   typedef iterator_base<true> const_iterator;
+
+
+   sda_tombstone() = default;
+
+   explicit sda_tombstone(size_type dead_percent) : dead_percent_(dead_percent) {}
+
+   explicit sda_tombstone(array_type&& array, size_type dead_percent = default_dead_percent) noexcept
+   : array_(std::move(array)), dead_percent_(dead_percent) {}
+
+   sda_tombstone(std::initializer_list<value_type> il) : array_(il) {}
+
+   //------------------
+   //    CAPACITY
+   //------------------
+   size_type size() const noexcept
+   {
+      return array_.size() - dead_;
+   }
+   bool empty() const noexcept
+   {
+      return array_.empty();
+   }
+   //    tombstones waiting for compaction
+   size_type dead() const noexcept
+   {
+      return dead_;
+   }
+   void clear() noexcept
+   {
+      array_.clear();
+      close();
+   }
+
+   //----------------------------------------------
+   //    COMPACT
+   //    [0, mid) is packed toward mid from the
+   //    right, [mid, end) toward mid from the left
+   //----------------------------------------------
+   void compact()
+   {
+      if(clean()) return;
+      if(dead_ == 0) return close();
+      size_type n = array_.size();
+      size_type mid = n / 2;
+      size_type w = mid;
+      for(size_type i = mid; i < n; i++)
+         if(live(i))
+         {
+            if(i != w) array_[w] = std::move(array_[i]);
+            w++;
+         }
+      while(array_.size() > w) array_.pop_back();
+      w = mid;
+      for(size_type i = mid; i-- > 0;)
+         if(live(i))
+         {
+            if(i != --w) array_[w] = std::move(array_[i]);
+         }
+      for(; w; w--) array_.pop_front();
+      close();
+   }
+   //    the compacted array
+   array_type& array()
+   {
+      compact();
+      return array_;
+   }
+
+   //------------------
+   //    ACCESS
+   //------------------
+   reference operator[] (size_type n)
+   {
+      return array_[select(n)];
+   }
+   const_reference operator[] (size_type n) const
+   {
+      return array_[select(n)];
+   }
+   reference at(size_type n)
+   {
+      if(n >= size()) throw std::out_of_range("std::out_of_range");
+      return (*this)[n];
+   }
+   const_reference at(size_type n) const
+   {
+      if(n >= size()) throw std::out_of_range("std::out_of_range");
+      return (*this)[n];
+   }
+   reference front()
+   {
+      return array_.front();
+   }
+   const_reference front() const
+   {
+      return array_.front();
+   }
+   reference back()
+   {
+      return array_.back();
+   }
+   const_reference back() const
+   {
+      return array_.back();
+   }
+   iterator begin() noexcept
+   {
+      return iterator(this, 0);
+   }
+   iterator end() noexcept
+   {
+      return iterator(this, array_.size());
+   }
+   const_iterator begin() const noexcept
+   {
+      return const_iterator(this, 0);
+   }
+   const_iterator end() const noexcept
+   {
+      return const_iterator(this, array_.size());
+   }
+
+   //------------------------------------------
+   //    PUSH, INSERT
+   //    compact when the bitmap has no room
+   //------------------------------------------
+   template<class... Args>
+   void emplace_back(Args&&... args)
+   {
+      if(!clean() && origin_ + array_.size() == live_.size() * 64) compact();
+      array_.emplace_back(std::forward<Args>(args)...);
+      if(!clean()) set_live(array_.size() - 1, true);
+   }
+   template<class... Args>
+   void emplace_front(Args&&... args)
+   {
+      if(!clean() && origin_ == 0) compact();
+      array_.emplace_front(std::forward<Args>(args)...);
+      if(!clean())
+      {
+         origin_--;
+         set_live(0, true);
+      }
+   }
+   void push_back(const value_type& val)
+   {
+      emplace_back(val);
+   }
+   void push_back(value_type&& val)
+   {
+      emplace_back(std::move(val));
+   }
+   void push_front(const value_type& val)
+   {
+      emplace_front(val);
+   }
+   void push_front(value_type&& val)
+   {
+      emplace_front(std::move(val));
+   }
+   //    the cheaper of: shift the elements between pos and the
+   //    nearest tombstone by one and revive it, or a plain sda
+   //    insert with the bits of the shorter side shifted too;
+   //    the bitmap stays open when the last tombstone is used
+   //    up, so an erase after it does not build it again
+   template<class... Args>
+   void emplace(size_type pos, Args&&... args)
+   {
+      if(pos == size()) return emplace_back(std::forward<Args>(args)...);
+      if(pos == 0) return emplace_front(std::forward<Args>(args)...);
+      if(clean())
+      {
+         array_.emplace(array_.begin() + pos, std::forward<Args>(args)...);
+         return;
+      }
+      size_type i = select(pos);
+      size_type left = dead_ ? prev_dead(i) : none;
+      size_type right = dead_ ? next_dead(i) : none;
+      size_type to_left = left == none ? none : i - 1 - left;
+      size_type to_right = right == none ? none : right - i;
+      if(std::min(i, array_.size() - i) < std::min(to_left, to_right))
+      {
+         if(origin_ == 0 && origin_ + array_.size() == live_.size() * 64)
+         {
+            compact();
+            array_.emplace(array_.begin() + pos, std::forward<Args>(args)...);
+            return;
+         }
+         array_.emplace(array_.begin() + i, std::forward<Args>(args)...);
+         insert_bit(i);
+         return;
+      }
+      if(to_left <= to_right)
+      {
+         std::move(array_.begin() + left + 1, array_.begin() + i, array_.begin() + left);
+         set_live(left, true);
+         i--;
+      }
+      else
+      {
+         std::move_backward(array_.begin() + i, array_.begin() + right, array_.begin() + right + 1);
+         set_live(right, true);
+      }
+      array_[i] = value_type(std::forward<Args>(args)...);
+      dead_--;
+   }
+   void insert(size_type pos, const value_type& val)
+   {
+      emplace(pos, val);
+   }
+   void insert(size_type pos, value_type&& val)
+   {
+      emplace(pos, std::move(val));
+   }
+
+   //------------------------------------------
+   //    ERASE
+   //    O(log n), amortized compaction
+   //------------------------------------------
+   void erase(size_type pos)
+   {
+      kill(select(pos));
+      check_dead();
+   }
+   void erase(size_type first, size_type last)
+   {
+      if(first == last) return;
+      if(clean())
+      {
+         array_.erase(array_.begin() + first, array_.begin() + last);
+         return;
+      }
+      size_type i = select(first);
+      for(size_type k = last - first; k; k--)
+      {
+         size_type next = next_live(i);
+         set_live(i, false);
+         bury(i);
+         dead_++;
+         i = next;
+      }
+      trim();
+      check_dead();
+   }
+   void pop_back()
+   {
+      kill(array_.size() - 1);
+   }
+   void pop_front()
+   {
+      kill(0);
+   }
+};
+
+
+#endif
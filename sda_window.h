@@ -0,0 +1,283 @@
+/*
+MIT License
+
+Copyright 2020 Than Minh Duy (macodeth)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+OR OTHER DEALINGS IN THE SOFTWARE.
+
+*/
+
+
+#ifndef SYMMETRIC_DYNAMIC_ARRAY_WINDOW
+#define SYMMETRIC_DYNAMIC_ARRAY_WINDOW
+
+
+
+#include<functional>
+#include<memory>
+#include<type_traits>
+#include<utility>
+
+#include "sda.h"
+
+
+
+//
+//    sliding window: push at the back, expire at the front
+//
+//    aggregate (two stacks, amortized O(1) per push / pop):
+//
+//       values_  : v0 v1 v2 | v3 v4 v5 v6
+//       suffix_  : s0 s1 s2          s0 = v0 + v1 + v2, s1 = v1 + v2 ...
+//       back_    :            v3 + v4 + v5 + v6
+//
+//       aggregate() = suffix_.front() + back_
+//
+//    pop_front takes suffix_ with it, once suffix_ is empty the
+//    back part is folded into suffix_ from right to left (flip)
+//
+//    min / max : monotonic queues of sequence numbers
+//    Agg has to be associative, not commutative
+//    Compare = void turns min / max tracking off
+//
+
+
+template<class T, class Agg = std::plus<T>, class Compare = std::less<T>, class Allocator = std::allocator<T>>
+class sda_window
+{
+   public:
+   typedef sda<T, Allocator> array_type;
+   typedef typename array_type::allocator_type allocator_type;
+   typedef typename array_type::value_type value_type;
+   typedef typename array_type::size_type size_type;
+   typedef typename array_type::const_reference const_reference;
+   typedef typename array_type::const_iterator const_iterator;
+
+   static constexpr bool track_extrema = !std::is_void<Compare>::value;
+
+   typedef typename std::conditional<track_extrema, Compare, std::less<T>>::type compare_type;
+
+
+   private:
+   typedef sda<size_type, typename std::allocator_traits<Allocator>::template rebind_alloc<size_type>> index_type;
+
+   array_type values_;
+   array_type suffix_;
+   value_type back_{};
+   index_type min_;
+   index_type max_;
+   size_type first_ = 0;     // sequence number of values_.front()
+   Agg agg_;
+   compare_type comp_;
+
+
+   //    a window keeps drifting to the back of its block,
+   //    slide to the front instead of growing while the
+   //    empty front capacity is larger than the data
+   template<class A, class V>
+   static void push_back(A& a, V&& v)
+   {
+      if(a.empty_back_capacity() == 0 && a.empty_front_capacity() > a.size())
+         a.slide_to_front();
+      a.push_back(std::forward<V>(v));
+   }
+
+   //    elements behind suffix_
+   size_type back_size() const noexcept
+   {
+      return values_.size() - suffix_.size();
+   }
+
+   //    fold every element into suffix_, right to left
+   void flip()
+   {
+      suffix_.clear();
+      suffix_.slide_to_back();
+      suffix_.reserve_front(values_.size());
+      for(size_type i = values_.size(); i-- > 0;)
+      {
+         if(suffix_.empty()) suffix_.push_front(values_[i]);
+         else suffix_.push_front(agg_(values_[i], suffix_.front()));
+      }
+   }
+
+   //    sequence number order: front is the oldest survivor
+   void expire_extrema()
+   {
+      if constexpr (track_extrema)
+      {
+         while(!min_.empty() && min_.front() < first_) min_.pop_front();
+         while(!max_.empty() && max_.front() < first_) max_.pop_front();
+      }
+   }
+   const_reference at_sequence(size_type s) const
+   {
+      return values_[s - first_];
+   }
+
+
+   public:
+   sda_window() = default;
+
+   explicit sda_window(const Agg& agg, const compare_type& comp = compare_type())
+   : agg_(agg), comp_(comp) {}
+
+   //------------------
+   //    CAPACITY
+   //------------------
+   size_type size() const noexcept
+   {
+      return values_.size();
+   }
+   bool empty() const noexcept
+   {
+      return values_.empty();
+   }
+   void reserve(size_type n)
+   {
+      values_.reserve(n);
+      suffix_.reserve(n);
+      if constexpr (track_extrema)
+      {
+         min_.reserve(n);
+         max_.reserve(n);
+      }
+   }
+   void clear() noexcept
+   {
+      first_ += values_.size();
+      values_.clear();
+      suffix_.clear();
+      min_.clear();
+      max_.clear();
+   }
+
+   //-----------------------------------------
+   //    ACCESS
+   //    0 is the oldest element in the window
+   //-----------------------------------------
+   const_reference operator[] (size_type n) const
+   {
+      return values_[n];
+   }
+   const_reference front() const
+   {
+      return values_.front();
+   }
+   const_reference back() const
+   {
+      return values_.back();
+   }
+   const_iterator begin() const noexcept
+   {
+      return values_.begin();
+   }
+   const_iterator end() const noexcept
+   {
+      return values_.end();
+   }
+
+   //-----------------------------------------
+   //    AGGREGATE
+   //    window must not be empty
+   //-----------------------------------------
+   value_type aggregate() const
+   {
+      if(suffix_.empty()) return back_;
+      if(back_size() == 0) return suffix_.front();
+      return agg_(suffix_.front(), back_);
+   }
+   //    aggregate() / size(), for sums
+   value_type mean() const
+   {
+      return aggregate() / static_cast<value_type>(size());
+   }
+   const_reference min() const
+   {
+      static_assert(track_extrema, "min() needs a Compare");
+      return at_sequence(min_.front());
+   }
+   const_reference max() const
+   {
+      static_assert(track_extrema, "max() needs a Compare");
+      return at_sequence(max_.front());
+   }
+
+   //-----------------------------------------
+   //    PUSH
+   //-----------------------------------------
+   void push(const value_type& val)
+   {
+      if constexpr (track_extrema)
+      {
+         size_type s = first_ + values_.size();
+         while(!min_.empty() && !comp_(at_sequence(min_.back()), val)) min_.pop_back();
+         while(!max_.empty() && !comp_(val, at_sequence(max_.back()))) max_.pop_back();
+         push_back(min_, s);
+         push_back(max_, s);
+      }
+      back_ = back_size() ? agg_(back_, val) : val;
+      push_back(values_, val);
+   }
+   template<class InputIterator>
+   void push(InputIterator first, InputIterator last)
+   {
+      for(; first != last; ++first) push(*first);
+   }
+
+   //-----------------------------------------
+   //    EXPIRE
+   //    pop           : drop the oldest element
+   //    expire(k)     : drop the k oldest elements
+   //    expire_while  : drop while pred(front())
+   //-----------------------------------------
+   void pop()
+   {
+      if(suffix_.empty()) flip();
+      values_.pop_front();
+      suffix_.pop_front();
+      first_++;
+      expire_extrema();
+   }
+   void expire(size_type k)
+   {
+      if(k >= values_.size())
+      {
+         clear();
+         return;
+      }
+      values_.resize_front(values_.size() - k);
+      if(k <= suffix_.size())
+         suffix_.resize_front(suffix_.size() - k);
+      else
+         flip();
+      first_ += k;
+      expire_extrema();
+   }
+   template<class Predicate>
+   void expire_while(Predicate pred)
+   {
+      size_type k = 0;
+      while(k < values_.size() && pred(values_[k])) k++;
+      expire(k);
+   }
+};
+
+
+#endif
@@ -0,0 +1,85 @@
+#ifndef SYMMETRIC_DYNAMIC_ARRAY_CHECK
+#define SYMMETRIC_DYNAMIC_ARRAY_CHECK
+
+#include<iostream>
+#include<algorithm>
+#include<memory>
+#include<string>
+#include<cstdlib>
+
+//
+//
+//	helpers shared by the checks: element values, a random fill
+//	from both ends, comparison with a model container, an
+//	allocator that counts its allocations, RIGHT / WRONG
+
+
+// strings long enough to live on the heap, so a missed move,
+// copy or destroy shows up under the sanitizers
+template<class T>
+T make(int i) { return T(i); }
+template<>
+inline std::string make<std::string>(int i) { return std::to_string(i) + "_long_enough_to_leave_the_small_buffer"; }
+
+// n values from "from" on, each pushed at a random end of a and
+// of the model v
+template<class A, class V>
+void fill(A& a, V& v, int n, int from)
+{
+	for(int i = 0; i < n; i++)
+	{
+		auto x = make<typename V::value_type>(from + i);
+		if(std::rand() % 2)
+		{
+			a.push_back(x);
+			v.push_back(x);
+		}
+		else
+		{
+			a.push_front(x);
+			v.insert(v.begin(), x);
+		}
+	}
+}
+
+template<class A, class V>
+bool same(const A& a, const V& v)
+{
+	return std::equal(a.begin(), a.end(), v.begin(), v.end());
+}
+
+inline std::size_t allocations = 0;
+inline std::size_t live_bytes = 0;
+
+template<class T>
+struct counting_allocator
+{
+	typedef T value_type;
+
+	counting_allocator() = default;
+	template<class U>
+	counting_allocator(const counting_allocator<U>&) noexcept {}
+
+	T* allocate(std::size_t n)
+	{
+		allocations++;
+		live_bytes += n * sizeof(T);
+		return std::allocator<T>().allocate(n);
+	}
+	void deallocate(T* p, std::size_t n) noexcept
+	{
+		live_bytes -= n * sizeof(T);
+		std::allocator<T>().deallocate(p, n);
+	}
+	template<class U>
+	bool operator==(const counting_allocator<U>&) const noexcept { return true; }
+	template<class U>
+	bool operator!=(const counting_allocator<U>&) const noexcept { return false; }
+};
+
+inline void print(bool right)
+{
+	std::cout << (right ? "RIGHT" : "WRONG") << std::endl;
+}
+
+#endif
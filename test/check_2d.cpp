@@ -0,0 +1,201 @@
+#include<iostream>
+#include<algorithm>
+#include<vector>
+#include<string>
+#include<cstdlib>
+
+#include "sda2d.h"
+#include "check.h"
+
+using namespace std;
+
+//
+//
+//	CHECK 2D
+//	sda2d against vector<vector<T>> for row and column insert and
+//	erase at every position, pushes on the four edges, reserve
+//	and shrink_to_fit, with a non-trivial T; row edits leave the
+//	cells of the other rows in place
+
+
+// the model keeps the column count apart so 0 rows still have columns
+template<class T>
+struct model
+{
+	size_t cols = 0;
+	vector<vector<T>> cells;
+
+	void insert_rows(size_t pos, size_t n, const T& val)
+	{
+		cells.insert(cells.begin() + pos, n, vector<T>(cols, val));
+	}
+	void erase_rows(size_t first, size_t last)
+	{
+		cells.erase(cells.begin() + first, cells.begin() + last);
+	}
+	void insert_cols(size_t pos, size_t n, const T& val)
+	{
+		for(auto& row : cells) row.insert(row.begin() + pos, n, val);
+		cols += n;
+	}
+	void erase_cols(size_t first, size_t last)
+	{
+		for(auto& row : cells) row.erase(row.begin() + first, row.begin() + last);
+		cols -= last - first;
+	}
+};
+
+template<class T>
+bool same(const sda2d<T>& a, const model<T>& m)
+{
+	if(a.rows() != m.cells.size() || a.cols() != m.cols) return false;
+	if(a.row_capacity() < a.rows() || a.col_capacity() < a.cols()) return false;
+	for(size_t r = 0; r < a.rows(); r++)
+	{
+		if(!equal(a.row(r), a.row(r) + a.cols(), m.cells[r].begin(), m.cells[r].end())) return false;
+		if(a.cols() && a.at(r, a.cols() - 1) != m.cells[r].back()) return false;
+	}
+	return true;
+}
+
+template<class T>
+void check()
+{
+	sda2d<T> a(3, 4, make<T>(-1));
+	model<T> m;
+	m.cols = 4;
+	m.insert_rows(0, 3, make<T>(-1));
+	bool right = same(a, m);
+	for(int i = 0; i < 4000; i++)
+	{
+		T val = make<T>(i);
+		size_t rows = m.cells.size();
+		size_t n = rand() % 3;
+		switch(rand() % 10)
+		{
+			case 0:
+			{
+				size_t p = rand() % (rows + 1);
+				a.insert_rows(p, n, val);
+				m.insert_rows(p, n, val);
+				break;
+			}
+			case 1:
+			{
+				size_t p = rand() % (m.cols + 1);
+				a.insert_cols(p, n, val);
+				m.insert_cols(p, n, val);
+				break;
+			}
+			case 2:
+				if(rows)
+				{
+					size_t p = rand() % rows;
+					size_t q = min(rows, p + n);
+					a.erase_rows(p, q);
+					m.erase_rows(p, q);
+				}
+				break;
+			case 3:
+				if(m.cols)
+				{
+					size_t p = rand() % m.cols;
+					size_t q = min(m.cols, p + n);
+					a.erase_cols(p, q);
+					m.erase_cols(p, q);
+				}
+				break;
+			case 4:
+				a.push_back_row(val);
+				m.insert_rows(rows, 1, val);
+				break;
+			case 5:
+				a.push_front_row(val);
+				m.insert_rows(0, 1, val);
+				break;
+			case 6:
+				a.push_back_col(val);
+				m.insert_cols(m.cols, 1, val);
+				break;
+			case 7:
+				a.push_front_col(val);
+				m.insert_cols(0, 1, val);
+				break;
+			case 8:
+				if(rows && m.cols)
+				{
+					size_t r = rand() % rows, c = rand() % m.cols;
+					a(r, c) = val;
+					m.cells[r][c] = val;
+				}
+				break;
+			case 9:
+				if(rand() % 2) a.reserve(rows + rand() % 10, m.cols + rand() % 10);
+				else a.shrink_to_fit();
+				break;
+		}
+		right = right && same(a, m);
+		// keep the grid small enough to compare every step
+		if(rows > 40)
+		{
+			a.erase_rows(0, 20);
+			m.erase_rows(0, 20);
+		}
+		if(m.cols > 40)
+		{
+			a.erase_cols(10, 30);
+			m.erase_cols(10, 30);
+		}
+	}
+	sda2d<T> b;
+	b.swap(a);
+	right = right && same(b, m) && a.rows() == 0;
+	b.clear();
+	right = right && b.empty() && b.rows() == 0 && b.cols() == 0;
+	cout << (right ? "RIGHT" : "WRONG") << endl;
+}
+
+// row edits move row handles only: the other rows stay where they
+// are, erased rows give their slots to the next inserts
+template<class T>
+void check_rows()
+{
+	sda2d<T> a(200, 30, make<T>(0));
+	model<T> m;
+	m.cols = 30;
+	m.insert_rows(0, 200, make<T>(0));
+	for(size_t r = 0; r < 200; r++) a(r, 0) = m.cells[r][0] = make<T>(int(r));
+	a.reserve(300, 30);
+	bool right = a.row_capacity() == 300;
+	for(int i = 0; i < 2000; i++)
+	{
+		vector<const T*> rows;
+		for(size_t r = 0; r < a.rows(); r++) rows.push_back(a.row(r));
+		size_t p = rand() % (a.rows() + 1), n = 1 + rand() % 3;
+		if(rand() % 2 && a.rows() + n <= a.row_capacity())
+		{
+			a.insert_rows(p, n, make<T>(i));
+			m.insert_rows(p, n, make<T>(i));
+			rows.insert(rows.begin() + p, n, nullptr);
+		}
+		else if(p + n <= a.rows())
+		{
+			a.erase_rows(p, p + n);
+			m.erase_rows(p, p + n);
+			rows.erase(rows.begin() + p, rows.begin() + p + n);
+		}
+		for(size_t r = 0; r < a.rows(); r++)
+			right = right && (!rows[r] || rows[r] == a.row(r));
+		right = right && a.row_capacity() == 300;
+	}
+	right = right && same(a, m);
+	cout << (right ? "RIGHT" : "WRONG") << endl;
+}
+
+int main()
+{
+	check<int>();
+	check<string>();
+	check_rows<int>();
+	check_rows<string>();
+}
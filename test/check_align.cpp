@@ -0,0 +1,113 @@
+#include<iostream>
+#include<algorithm>
+#include<deque>
+#include<vector>
+#include<cstdint>
+#include<cstdlib>
+
+#include "sda.h"
+
+using namespace std;
+
+//
+//
+//	CHECK ALIGN
+//	with sda_aligned_policy data() sits on a 64 byte boundary
+//	after a reallocation at the back, reserve, slide and assign,
+//	element sizes 4, 12 and 24 bytes (boundaries reachable from a
+//	16 byte aligned block), the contents match a deque; a second
+//	shrink_to_fit keeps the block
+
+
+struct rgb
+{
+	int r, g, b;
+	bool operator==(const rgb& o) const { return r == o.r && g == o.g && b == o.b; }
+};
+
+template<class T>
+T make(int i) { return T(i); }
+template<>
+vector<int> make<vector<int>>(int i) { return vector<int>(i % 7 + 1, i); }
+template<>
+rgb make<rgb>(int i) { return rgb{i, -i, i * 2}; }
+
+template<class A>
+bool aligned(const A& a)
+{
+	return a.empty() || reinterpret_cast<uintptr_t>(a.data()) % sda_aligned_policy::alignment == 0;
+}
+
+template<class T>
+void check()
+{
+	sda<T, allocator<T>, sda_aligned_policy> a;
+	deque<T> d;
+	bool right = true;
+	for(int i = 0; i < 20000; i++)
+	{
+		const T* before = a.data();
+		int op = rand() % 5;
+		if(op == 0)
+		{
+			a.push_back(make<T>(i));
+			d.push_back(make<T>(i));
+		}
+		else if(op == 1)
+		{
+			a.push_front(make<T>(i));
+			d.push_front(make<T>(i));
+		}
+		else if(op == 2 && !d.empty())
+		{
+			size_t p = rand() % d.size();
+			a.erase(a.begin() + p);
+			d.erase(d.begin() + p);
+		}
+		else
+		{
+			size_t p = rand() % (d.size() + 1);
+			a.insert(a.begin() + p, make<T>(i));
+			d.insert(d.begin() + p, make<T>(i));
+		}
+		// a reallocation at the back keeps data() on the boundary
+		if(op == 0 && a.data() != before)
+			right = right && aligned(a);
+		if(i % 997 == 0)
+		{
+			const T* before_reserve = a.data();
+			a.reserve(a.size() * 3);
+			right = right && (a.data() == before_reserve || aligned(a));
+			a.slide_to_front();
+			right = right && aligned(a);
+			a.slide_to_back();
+			right = right && aligned(a);
+			// room for 7 plus the way to the next boundary
+			if(a.capacity() - a.size() >= 7 + 64)
+			{
+				a.slide_to_front(7);
+				right = right && aligned(a) && a.empty_front_capacity() >= 7;
+			}
+			a.shrink_to_fit();
+			const T* shrunk = a.data();
+			a.shrink_to_fit();
+			right = right && aligned(a) && a.data() == shrunk;
+		}
+	}
+	right = right && equal(a.begin(), a.end(), d.begin(), d.end());
+
+	sda<T, allocator<T>, sda_aligned_policy> b(d.begin(), d.end()), c(100, make<T>(5));
+	right = right && aligned(b) && aligned(c) && equal(b.begin(), b.end(), d.begin(), d.end());
+	b.assign(d.begin(), d.begin() + 5);
+	right = right && aligned(b) && b.size() == 5;
+	c.assign(1000, make<T>(1));
+	right = right && aligned(c) && c.size() == 1000;
+	cout << (right ? "RIGHT" : "WRONG") << endl;
+}
+
+int main()
+{
+	check<int>();
+	check<vector<int>>();
+	check<rgb>();
+}
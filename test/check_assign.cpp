@@ -0,0 +1,157 @@
+#include<iostream>
+#include<algorithm>
+#include<vector>
+#include<string>
+#include<cstdlib>
+#include<new>
+
+#include "sda.h"
+#include "check.h"
+
+using namespace std;
+
+//
+//
+//	CHECK ASSIGN
+//	assign, copy and move assignment and sda(sda&&, alloc) against
+//	vector, with an allocator that counts its construct and destroy
+//	calls: they must be made even for trivial types, and with
+//	allocators that propagate or not, compare equal or not
+
+
+long constructs = 0, destroys = 0;
+
+template<class T, bool Propagate>
+struct tracing_allocator
+{
+	typedef T value_type;
+	typedef integral_constant<bool, Propagate> propagate_on_container_copy_assignment;
+	typedef integral_constant<bool, Propagate> propagate_on_container_move_assignment;
+	typedef integral_constant<bool, Propagate> propagate_on_container_swap;
+	template<class U>
+	struct rebind { typedef tracing_allocator<U, Propagate> other; };
+
+	int tag = 0;
+
+	tracing_allocator() = default;
+	explicit tracing_allocator(int t) : tag(t) {}
+	template<class U>
+	tracing_allocator(const tracing_allocator<U, Propagate>& o) noexcept : tag(o.tag) {}
+
+	T* allocate(size_t n) { return allocator<T>().allocate(n); }
+	void deallocate(T* p, size_t n) noexcept { allocator<T>().deallocate(p, n); }
+
+	template<class U, class... Args>
+	void construct(U* p, Args&&... args)
+	{
+		constructs++;
+		::new((void*)p) U(std::forward<Args>(args)...);
+	}
+	template<class U>
+	void destroy(U* p)
+	{
+		destroys++;
+		p->~U();
+	}
+
+	template<class U>
+	bool operator==(const tracing_allocator<U, Propagate>& o) const noexcept { return tag == o.tag; }
+	template<class U>
+	bool operator!=(const tracing_allocator<U, Propagate>& o) const noexcept { return tag != o.tag; }
+};
+
+// the byte kernels stay for allocators that do not look
+static_assert(sda<int>::byte_fill && sda<int>::trivial_destroy, "std::allocator fast path");
+static_assert(!sda<int, tracing_allocator<int, true>>::byte_fill, "allocator construct bypassed");
+static_assert(!sda<int, tracing_allocator<int, true>>::trivial_destroy, "allocator destroy bypassed");
+
+template<class T, bool Propagate>
+void check(bool equal_alloc)
+{
+	typedef tracing_allocator<T, Propagate> alloc;
+	typedef sda<T, alloc> array;
+	const int other_tag = equal_alloc ? 1 : 2;
+	bool right = true;
+
+	for(int round = 0; round < 2000; round++)
+	{
+		array a(alloc(1)), b{alloc(other_tag)};
+		vector<T> va, vb;
+		fill(a, va, rand() % 100, 0);
+		fill(b, vb, rand() % 100, 1000);
+		size_t old_size = a.size(), n = rand() % 200;
+		long c0 = constructs, d0 = destroys;
+		int tag = 1;
+
+		switch(rand() % 6)
+		{
+			case 0:
+				// every element built and every old one destroyed by the allocator
+				a.assign(n, make<T>(5));
+				va.assign(n, make<T>(5));
+				right = right && constructs - c0 == long(n) && destroys - d0 >= long(old_size);
+				break;
+			case 1:
+				a.clear();
+				va.clear();
+				right = right && destroys - d0 == long(old_size);
+				a.resize_back(n);
+				va.resize(n);
+				right = right && constructs - c0 == long(n);
+				break;
+			case 2:
+				a.assign(b.begin(), b.end());
+				va.assign(vb.begin(), vb.end());
+				right = right && destroys - d0 >= long(old_size);
+				break;
+			case 3:
+				a = b;
+				va = vb;
+				if(Propagate) tag = other_tag;
+				right = right && same(b, vb);
+				break;
+			case 4:
+				a = move(b);
+				va = vb;
+				vb.clear();
+				if(Propagate) tag = other_tag;
+				// elements of unequal allocators are moved one by one
+				else if(!equal_alloc) right = right && destroys - d0 >= long(old_size + va.size());
+				right = right && b.empty();
+				break;
+			case 5:
+			{
+				const T* data = b.data();
+				array c(move(b), alloc(1));
+				right = right && c.get_allocator().tag == 1 && same(c, vb) && b.empty();
+				right = right && (equal_alloc ? c.data() == data : destroys - d0 == long(vb.size()));
+				a = move(c);
+				va = vb;
+				vb.clear();
+				break;
+			}
+		}
+		right = right && a.get_allocator().tag == tag && same(a, va) && same(b, vb);
+		// both stay usable
+		a.push_front(make<T>(3));
+		a.push_back(make<T>(4));
+		b.push_back(make<T>(6));
+		va.insert(va.begin(), make<T>(3));
+		va.push_back(make<T>(4));
+		vb.push_back(make<T>(6));
+		right = right && same(a, va) && same(b, vb);
+	}
+	cout << (right ? "RIGHT" : "WRONG") << endl;
+}
+
+int main()
+{
+	check<int, true>(true);
+	check<int, true>(false);
+	check<int, false>(true);
+	check<int, false>(false);
+	check<string, true>(false);
+	check<string, false>(false);
+	// every element the allocator built, it destroyed
+	cout << (constructs <= destroys ? "RIGHT" : "WRONG") << endl;
+}
@@ -0,0 +1,205 @@
+#include<iostream>
+#include<algorithm>
+#include<list>
+#include<vector>
+#include<string>
+#include<stdexcept>
+#include<cstdlib>
+
+#include "compact_sda.h"
+#include "check.h"
+
+using namespace std;
+
+//
+//
+//	CHECK COMPACT
+//	compact_sda is one pointer wide and behaves like vector for
+//	pushes at both ends, single, fill and range insert, erase,
+//	resize, copies and moves; an empty one allocates nothing,
+//	sizes past 2^32 - 1 throw, edits move the nearer side
+
+
+static_assert(sizeof(compact_sda<int>) == sizeof(void*), "compact_sda must be one pointer");
+static_assert(sizeof(compact_sda<string>) == sizeof(void*), "compact_sda must be one pointer");
+
+template<class T>
+bool same(const compact_sda<T>& a, const vector<T>& v)
+{
+	return a.size() == v.size() && a.empty() == v.empty() && equal(a.begin(), a.end(), v.begin(), v.end())
+		&& equal(a.rbegin(), a.rend(), v.rbegin(), v.rend())
+		&& a.capacity() >= a.size() && a.empty_front_capacity() + a.empty_back_capacity() + a.size() == a.capacity();
+}
+
+template<class T>
+void check()
+{
+	compact_sda<T> a;
+	vector<T> v;
+	bool right = same(a, v);
+	for(int i = 0; i < 20000; i++)
+	{
+		T val = make<T>(i);
+		size_t p = rand() % (v.size() + 1);
+		int op = rand() % 14;
+		if(op < 3)
+		{
+			a.push_back(val);
+			v.push_back(val);
+		}
+		else if(op < 6)
+		{
+			a.push_front(val);
+			v.insert(v.begin(), val);
+		}
+		else if(op == 6)
+		{
+			right = right && *a.insert(a.begin() + p, val) == val;
+			v.insert(v.begin() + p, val);
+		}
+		else if(op == 7)
+		{
+			size_t n = rand() % 10;
+			a.insert(a.begin() + p, n, val);
+			v.insert(v.begin() + p, n, val);
+		}
+		else if(op == 8)
+		{
+			// single pass and multi pass ranges
+			list<T> l(rand() % 10, val);
+			a.insert(a.begin() + p, l.begin(), l.end());
+			v.insert(v.begin() + p, l.begin(), l.end());
+		}
+		else if(op == 9 && !v.empty())
+		{
+			p = rand() % v.size();
+			a.erase(a.begin() + p);
+			v.erase(v.begin() + p);
+		}
+		else if(op == 10 && !v.empty())
+		{
+			p = rand() % v.size();
+			size_t q = min(v.size(), p + rand() % 10);
+			a.erase(a.begin() + p, a.begin() + q);
+			v.erase(v.begin() + p, v.begin() + q);
+		}
+		else if(op == 11 && !v.empty())
+		{
+			a.pop_back();
+			v.pop_back();
+		}
+		else if(op == 12 && !v.empty())
+		{
+			a.pop_front();
+			v.erase(v.begin());
+		}
+		else if(op == 13)
+		{
+			size_t n = v.size() + rand() % 5 - min<size_t>(v.size(), 2);
+			a.resize(n, val);
+			v.resize(n, val);
+		}
+		right = right && a.size() == v.size();
+		if(!v.empty())
+			right = right && a.front() == v.front() && a.back() == v.back() && a.at(v.size() / 2) == v[v.size() / 2];
+		if(i % 500 == 0)
+		{
+			right = right && same(a, v);
+			a.reserve_front(a.size() + 50);
+			a.reserve_back(a.size() + 30);
+			right = right && a.empty_front_capacity() >= 50 && a.empty_back_capacity() >= 30 && same(a, v);
+			a.shrink_to_fit();
+			right = right && same(a, v);
+		}
+	}
+	right = right && same(a, v);
+
+	// copies and moves
+	compact_sda<T> b(a);
+	compact_sda<T> c(move(b));
+	compact_sda<T> d;
+	d = c;
+	compact_sda<T> e({make<T>(1), make<T>(2)});
+	e = move(d);
+	right = right && b.empty() && same(c, v) && same(e, v);
+	e.assign(5, make<T>(7));
+	c.assign(v.begin(), v.begin() + v.size() / 2);
+	right = right && same(e, vector<T>(5, make<T>(7))) && same(c, vector<T>(v.begin(), v.begin() + v.size() / 2));
+	c.swap(e);
+	right = right && same(c, vector<T>(5, make<T>(7)));
+	bool thrown = false;
+	try
+	{
+		c.at(5);
+	}
+	catch(const out_of_range&)
+	{
+		thrown = true;
+	}
+	c.clear();
+	right = right && thrown && c.empty();
+	cout << (right ? "RIGHT" : "WRONG") << endl;
+}
+
+template<class T>
+void check_edges()
+{
+	typedef compact_sda<T, counting_allocator<T>> array;
+	allocations = 0;
+	bool right = true;
+
+	// empty states and their copies own no block
+	{
+		array a, b(a), c(move(b));
+		a = c;
+		a.assign(size_t(0), make<T>(1));
+		a.insert(a.end(), c.begin(), c.end());
+		a.resize(0);
+		a.reserve(0);
+		a.swap(c);
+		right = right && allocations == 0 && a.capacity() == 0 && a.data() == nullptr;
+		a.push_back(make<T>(1));
+		a.pop_back();
+		a.shrink_to_fit();
+		right = right && allocations == 1 && live_bytes == 0 && a.capacity() == 0;
+	}
+
+	// offsets are 32 bits wide
+	{
+		array a;
+		bool thrown = false;
+		try
+		{
+			a.reserve(size_t(a.max_size()) + 1);
+		}
+		catch(const length_error&)
+		{
+			thrown = true;
+		}
+		right = right && thrown && a.max_size() == 0xFFFFFFFFu && a.capacity() == 0;
+	}
+
+	// like sda, the side with fewer elements moves
+	{
+		array a;
+		a.reserve(3000);
+		for(int i = 0; i < 1000; i++) a.push_back(make<T>(i));
+		const T* middle = &a[500];
+		a.insert(a.begin() + 10, make<T>(-1));
+		right = right && &a[501] == middle;
+		a.erase(a.begin() + 990);
+		a.insert(a.end() - 10, 3, make<T>(-2));
+		right = right && &a[501] == middle && a.capacity() == 3000 && a[990] == make<T>(-2);
+		a.erase(a.begin() + 1, a.begin() + 5);
+		right = right && &a[497] == middle;
+	}
+	print(right);
+}
+
+int main()
+{
+	check<int>();
+	check<string>();
+	check_edges<int>();
+	check_edges<string>();
+}
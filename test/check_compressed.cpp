@@ -0,0 +1,165 @@
+#include<iostream>
+#include<algorithm>
+#include<vector>
+#include<cstdint>
+#include<cstdlib>
+
+#include "sda_compressed.h"
+
+using namespace std;
+
+//
+//
+//	CHECK COMPRESSED
+//	sda_compressed against vector, print "WRONG"
+//	if any operation gives a different sequence
+
+
+template<class A, class B>
+void check(const A& a, const B& b)
+{
+	bool right = a.size() == b.size() && equal(b.begin(), b.end(), a.begin())
+		&& equal(b.rbegin(), b.rend(), a.rbegin());
+	for(size_t i = 0; right && i < b.size(); i++)
+		if(a[i] != b[i]) right = false;
+	cout << (right ? "RIGHT" : "WRONG") << endl;
+}
+
+template<class Int>
+Int random_value()
+{
+	return Int(rand() % 1000 - (is_signed<Int>::value ? 500 : 0));
+}
+
+template<class Int>
+void run(int n)
+{
+	//
+	// random push, insert, erase, set
+	//
+	vector<Int> v1;
+	sda_compressed<Int, 16> a1;
+	for(int i = 0; i < n; i++)
+	{
+		Int value = random_value<Int>();
+		size_t pos = rand() % (v1.size() + 1);
+		switch(rand() % 8)
+		{
+			case 0: case 1: v1.push_back(value); a1.push_back(value); break;
+			case 2: v1.insert(v1.begin(), value); a1.push_front(value); break;
+			case 3: v1.insert(v1.begin() + pos, value); a1.insert(pos, value); break;
+			case 4:
+				if(pos < v1.size()) { v1.erase(v1.begin() + pos); a1.erase(pos); }
+				break;
+			case 5:
+				if(!v1.empty()) { v1.pop_back(); a1.pop_back(); }
+				break;
+			case 6:
+			{
+				size_t count = min<size_t>(rand() % 40, v1.size() - pos);
+				v1.erase(v1.begin() + pos, v1.begin() + pos + count);
+				a1.erase(pos, pos + count);
+				break;
+			}
+			case 7:
+				if(pos < v1.size()) { v1[pos] = value; a1.set(pos, value); }
+				break;
+		}
+	}
+	check(a1, v1);
+
+	//
+	// sorted pushes (delta blocks), then range erases across blocks
+	//
+	vector<Int> v2;
+	sda_compressed<Int, 32> a2;
+	Int value = Int(is_signed<Int>::value ? -100 : 0);
+	for(int i = 0; i < n; i++)
+	{
+		value = Int(value + rand() % 3);
+		v2.push_back(value);
+		a2.push_back(value);
+	}
+	check(a2, v2);
+	for(int i = 0; i < 50 && !v2.empty(); i++)
+	{
+		size_t pos = rand() % v2.size();
+		size_t count = min<size_t>(rand() % 200, v2.size() - pos);
+		v2.erase(v2.begin() + pos, v2.begin() + pos + count);
+		a2.erase(pos, pos + count);
+		if(rand() % 2) { v2.push_back(v2.empty() ? 0 : v2.back()); a2.push_back(v2.back()); }
+	}
+	check(a2, v2);
+	a2.erase(0, a2.size());
+	v2.clear();
+	check(a2, v2);
+
+	//
+	// pushes at the front: descending steps (delta blocks), small
+	// offsets (frame of reference), erases from the front, and
+	// inserts that split the last block before more pushes
+	//
+	vector<Int> v4;
+	sda_compressed<Int, 16> a4;
+	Int low = Int(is_signed<Int>::value ? 100 : 120);
+	for(int i = 0; i < n; i++)
+	{
+		switch(rand() % 6)
+		{
+			case 0: case 1:
+				low = Int(low - rand() % 2);
+				if(low < Int(is_signed<Int>::value ? -100 : 0)) low = Int(is_signed<Int>::value ? 100 : 120);
+				v4.insert(v4.begin(), low);
+				a4.push_front(low);
+				break;
+			case 2:
+			{
+				Int value = Int(low + rand() % 8);
+				v4.insert(v4.begin(), value);
+				a4.push_front(value);
+				break;
+			}
+			case 3:
+				if(!v4.empty()) { v4.erase(v4.begin()); a4.pop_front(); }
+				break;
+			case 4:
+			{
+				// into the last block, then pushes behind it
+				size_t pos = v4.size() - min<size_t>(v4.size(), rand() % 16);
+				Int value = random_value<Int>();
+				v4.insert(v4.begin() + pos, value);
+				a4.insert(pos, value);
+				v4.push_back(value);
+				a4.push_back(value);
+				break;
+			}
+			case 5:
+				v4.push_back(low);
+				a4.push_back(low);
+				break;
+		}
+	}
+	check(a4, v4);
+	a4.shrink_to_fit();
+	check(a4, v4);
+
+	//
+	// copies and iterators
+	//
+	sda_compressed<Int, 16> a3(a1);
+	vector<Int> v3;
+	for(auto it = a3.begin(); it != a3.end(); ) v3.push_back(*it++);
+	check(a3, v3);
+	check(a1, v3);
+	// reverse, stepping through copies
+	vector<Int> r3;
+	for(auto it = a3.rbegin(); it != a3.rend(); ) r3.push_back(*it++);
+	cout << (equal(r3.rbegin(), r3.rend(), v3.begin(), v3.end()) ? "RIGHT" : "WRONG") << endl;
+}
+
+int main()
+{
+	run<int>(20000);
+	run<uint64_t>(20000);
+	run<int8_t>(20000);
+}
@@ -0,0 +1,158 @@
+#include<iostream>
+#include<algorithm>
+#include<atomic>
+#include<stdexcept>
+#include<thread>
+#include<vector>
+#include<cstdlib>
+
+#include "concurrent_sda.h"
+
+using namespace std;
+
+//
+//
+//	CHECK CONCURRENT
+//	writer threads insert and erase values, a background thread
+//	rebalances, a reader takes snapshots and a positional thread
+//	erases from the front: every snapshot is sorted, the final
+//	content is exactly what the writers kept; without a balancer
+//	writers split overfull segments themselves while readers look
+//
+//	g++ -pthread, also worth a run with -fsanitize=thread
+
+
+int main()
+{
+	concurrent_sda<int> a(64);
+	const int threads = 8, per = 5000, negatives = 2000;
+	for(int i = 0; i < negatives; i++) a.insert(-1 - i);
+
+	vector<vector<int>> kept(threads);
+	atomic<bool> done{false};
+	atomic<bool> sorted{true};
+	atomic<bool> positional{true};
+	atomic<int> snapshots{0};
+
+	thread balancer([&]
+	{
+		while(!done)
+		{
+			if(a.needs_rebalance()) a.rebalance();
+			this_thread::yield();
+		}
+	});
+	thread reader([&]
+	{
+		while(!done)
+		{
+			sda<int> s = a.snapshot();
+			if(!is_sorted(s.begin(), s.end())) sorted = false;
+			snapshots++;
+		}
+	});
+	// writers never insert negatives, so the front stays negative
+	thread front([&]
+	{
+		for(int i = 0; i < negatives / 2; i++)
+		{
+			if(a.at(0) >= 0) positional = false;
+			a.erase_at(0);
+		}
+	});
+	vector<thread> writers;
+	for(int t = 0; t < threads; t++)
+		writers.emplace_back([&, t]
+		{
+			unsigned seed = t + 1;
+			vector<int> mine;
+			for(int i = 0; i < per; i++)
+			{
+				int v = rand_r(&seed) % 100000;
+				a.insert(v);
+				mine.push_back(v);
+				if(i % 3 == 0)
+				{
+					int e = mine[rand_r(&seed) % mine.size()];
+					if(a.erase(e)) mine.erase(find(mine.begin(), mine.end(), e));
+					else sorted = false;
+				}
+			}
+			kept[t] = mine;
+		});
+	for(auto& w : writers) w.join();
+	front.join();
+	done = true;
+	balancer.join();
+	reader.join();
+
+	vector<int> all;
+	// erase_at(0) took the most negative half
+	for(int i = 0; i < negatives / 2; i++) all.push_back(-1 - i);
+	for(auto& k : kept) all.insert(all.end(), k.begin(), k.end());
+	sort(all.begin(), all.end());
+	sda<int> s = a.snapshot();
+	cout << (sorted && positional && snapshots > 0 ? "RIGHT" : "WRONG") << endl;
+	cout << (a.size() == all.size() && equal(s.begin(), s.end(), all.begin(), all.end()) ? "RIGHT" : "WRONG") << endl;
+
+	// positional access and for_each after a final rebalance
+	a.rebalance();
+	bool right = a.segment_count() > 1 && a.at(0) == all.front() && a.at(all.size() - 1) == all.back()
+		&& a.contains(all[10]) && !a.contains(-negatives - 1);
+	a.erase_at(all.size() / 2);
+	all.erase(all.begin() + all.size() / 2);
+	size_t i = 0;
+	a.for_each([&](int v) { right = right && i < all.size() && v == all[i++]; });
+	cout << (right && i == all.size() ? "RIGHT" : "WRONG") << endl;
+
+	// equal values spill over fences
+	concurrent_sda<int> d(4);
+	for(int k = 0; k < 100; k++) d.insert(7);
+	d.rebalance();
+	int erased = 0;
+	while(d.erase(7)) erased++;
+	d.insert(1);
+	d.clear();
+	bool thrown = false;
+	try
+	{
+		d.at(0);
+	}
+	catch(const out_of_range&)
+	{
+		thrown = true;
+	}
+	cout << (erased == 100 && d.empty() && d.segment_count() == 1 && thrown ? "RIGHT" : "WRONG") << endl;
+
+	// no balancer: a writer past 4 * segment_size splits its own
+	// segment, readers keep finding every value they inserted
+	{
+		concurrent_sda<int> c(16);
+		atomic<bool> found{true};
+		vector<thread> ingest;
+		for(int t = 0; t < threads; t++)
+			ingest.emplace_back([&, t]
+			{
+				unsigned seed = t + 100;
+				for(int i = 0; i < per; i++)
+				{
+					int v = rand_r(&seed) % 100000;
+					c.insert(v);
+					if(!c.contains(v)) found = false;
+				}
+			});
+		for(auto& w : ingest) w.join();
+		vector<int> all;
+		for(int t = 0; t < threads; t++)
+		{
+			unsigned seed = t + 100;
+			for(int i = 0; i < per; i++) all.push_back(rand_r(&seed) % 100000);
+		}
+		sort(all.begin(), all.end());
+		sda<int> s = c.snapshot();
+		// split segments hold about 4 * 16 at most
+		bool right = found && c.segment_count() >= all.size() / (4 * 16 + threads);
+		right = right && equal(s.begin(), s.end(), all.begin(), all.end());
+		cout << (right ? "RIGHT" : "WRONG") << endl;
+	}
+}
@@ -0,0 +1,90 @@
+#include<iostream>
+#include<array>
+#include<string>
+
+#include "sda.h"
+
+using namespace std;
+
+//
+//
+//	CHECK CONSTEXPR
+//	build with -std=c++20: the same sequence of operations
+//	evaluated at compile time and at run time must agree
+
+
+#ifdef SDA_HAS_CONSTEXPR
+
+constexpr int build_sum()
+{
+	sda<int> a;
+	for(int i = 0; i < 20; i++) a.push_back(i);
+	for(int i = 0; i < 20; i++) a.push_front(-i);
+	a.insert(a.begin() + 5, 100);
+	a.erase(a.begin() + 3, a.begin() + 8);
+	a.pop_back();
+	a.pop_front();
+	sda<int> b(a);
+	b.insert(b.begin() + 2, {7, 8, 9});
+	b.resize_back(50, 3);
+	b.resize_front(10);
+	int s = 0;
+	for(auto it = b.rbegin(); it != b.rend(); ++it) s += *it;
+	return s + int(b.size()) + b.front() + b.back() + b.at(3);
+}
+
+constexpr array<int, 8> table()
+{
+	sda<int> a;
+	for(int i = 0; i < 4; i++)
+	{
+		a.push_back(i * i);
+		a.push_front(-i);
+	}
+	array<int, 8> r{};
+	copy(a.begin(), a.end(), r.begin());
+	return r;
+}
+
+constexpr size_t strings()
+{
+	sda<string> a;
+	a.push_back("abc");
+	a.push_front("de");
+	a.emplace(a.begin() + 1, "x");
+	for(int i = 0; i < 30; i++) a.push_front("p");
+	a.erase(a.begin() + 5);
+	return a.size() + a[30].size();
+}
+
+constexpr size_t shrink()
+{
+	sda<int, allocator<int>, sda_shrink_policy> a;
+	for(int i = 0; i < 1000; i++) a.push_back(i);
+	for(int i = 0; i < 990; i++) a.pop_back();
+	return a.capacity();
+}
+
+constexpr auto tab = table();
+static_assert(tab[0] == -3 && tab[3] == 0 && tab[4] == 0 && tab[7] == 9);
+static_assert(strings() == 33);
+static_assert(build_sum() == 49);
+static_assert(shrink() < 1000);
+
+int main()
+{
+	constexpr int s = build_sum();
+	constexpr size_t c = shrink();
+	cout << (s == build_sum() ? "RIGHT" : "WRONG") << endl;
+	cout << (c == shrink() ? "RIGHT" : "WRONG") << endl;
+	cout << (tab == table() && strings() == 33 ? "RIGHT" : "WRONG") << endl;
+}
+
+#else
+
+int main()
+{
+	cout << "constant evaluation needs C++20" << endl;
+}
+
+#endif
@@ -0,0 +1,138 @@
+#include<iostream>
+#include<algorithm>
+#include<vector>
+#include<stdexcept>
+#include<cstdint>
+#include<cstdlib>
+
+#include "sda_external.h"
+
+using namespace std;
+
+//
+//
+//	CHECK EXTERNAL
+//	sda_external against vector with blocks of 16 elements and a
+//	cache of a few blocks, so nearly every operation reads or
+//	evicts; with and without the I/O thread, the cache resized
+//	and the array cleared on the way
+
+
+template<class V>
+bool same(sda_external<uint32_t>& a, const V& v)
+{
+	if(a.size() != v.size()) return false;
+	bool right = equal(v.begin(), v.end(), a.begin(), a.end());
+	right = right && equal(v.rbegin(), v.rend(), a.rbegin(), a.rend());
+	size_t i = 0;
+	a.for_each([&](uint32_t x) { right = right && x == v[i++]; });
+	a.for_each_reverse([&](uint32_t x) { right = right && x == v[--i]; });
+	// a middle range, one block at a time
+	size_t first = v.size() / 3, last = v.size() - v.size() / 4;
+	i = first;
+	a.for_each(first, last, [&](uint32_t x) { right = right && x == v[i++]; });
+	return right && i == last && a.stats().frames * a.block_size() * sizeof(uint32_t) <= a.cache_bytes();
+}
+
+void check(bool background_io)
+{
+	const size_t block_bytes = 16 * sizeof(uint32_t);
+	sda_external<uint32_t> a(4 * block_bytes, block_bytes, nullptr, background_io);
+	vector<uint32_t> v;
+	bool right = a.block_size() == 16 && a.cache_bytes() == 4 * block_bytes;
+
+	for(int i = 0; i < 60000; i++)
+	{
+		uint32_t x = rand();
+		size_t pos = rand() % (v.size() + 1);
+		switch(rand() % 12)
+		{
+			case 0: a.push_back(x); v.push_back(x); break;
+			case 1: a.push_front(x); v.insert(v.begin(), x); break;
+			case 2: case 3: a.insert(pos, x); v.insert(v.begin() + pos, x); break;
+			case 4:
+			{
+				// splits and hands elements to neighbours
+				size_t n = rand() % 40;
+				a.insert(pos, n, x);
+				v.insert(v.begin() + pos, n, x);
+				break;
+			}
+			case 5:
+			{
+				vector<uint32_t> r(rand() % 50);
+				for(auto& y : r) y = rand();
+				a.insert(pos, r.begin(), r.end());
+				v.insert(v.begin() + pos, r.begin(), r.end());
+				break;
+			}
+			case 6:
+			{
+				// merges blocks left nearly empty
+				size_t n = min<size_t>(rand() % 40, v.size() - pos);
+				a.erase(pos, n);
+				v.erase(v.begin() + pos, v.begin() + pos + n);
+				break;
+			}
+			case 7:
+				if(!v.empty()) { a.pop_back(); v.pop_back(); }
+				if(!v.empty()) { a.pop_front(); v.erase(v.begin()); }
+				break;
+			case 8:
+				if(pos < v.size()) { a.set(pos, x); v[pos] = x; }
+				break;
+			case 9:
+				right = right && (pos < v.size() ? a[pos] == v[pos] && a.at(pos) == v[pos] : true);
+				right = right && (v.empty() || (a.front() == v.front() && a.back() == v.back()));
+				break;
+			case 10:
+				// dirty blocks are written before frames go away
+				if(rand() % 50 == 0)
+				{
+					a.set_cache_bytes((4 + rand() % 12) * block_bytes);
+					right = right && same(a, v);
+				}
+				break;
+			case 11:
+				if(rand() % 100 == 0) a.flush();
+				if(rand() % 1000 == 0)
+				{
+					right = right && same(a, v);
+					a.clear();
+					v.clear();
+					right = right && a.empty() && a.block_count() == 0;
+				}
+				break;
+		}
+		if(i % 5000 == 0) right = right && same(a, v);
+	}
+	right = right && same(a, v);
+
+	// a cache of the minimum size still holds every block in turn
+	a.set_cache_bytes(0);
+	right = right && a.cache_bytes() == 4 * block_bytes && same(a, v);
+	try
+	{
+		a.at(v.size());
+		right = false;
+	}
+	catch(const out_of_range&) {}
+
+	// clear and reuse, the blocks go through the file again
+	a.clear();
+	v.clear();
+	for(uint32_t i = 0; i < 5000; i++)
+	{
+		a.push_back(i);
+		v.push_back(i);
+	}
+	a.set_cache_bytes(64 * block_bytes);
+	right = right && same(a, v) && a.stats().writes > 0;
+	cout << (right ? "RIGHT" : "WRONG") << endl;
+}
+
+int main()
+{
+	check(true);
+	check(false);
+}
@@ -0,0 +1,100 @@
+#include<iostream>
+#include<algorithm>
+#include<vector>
+#include<stdexcept>
+#include<cstdlib>
+
+#include "sda_handles.h"
+
+using namespace std;
+
+//
+//
+//	CHECK HANDLES
+//	sda_handles against a vector of (value, handle) pairs under
+//	random insert and erase: every live handle finds its position
+//	and value, every erased handle stays stale after its slot
+//	is reused
+
+
+typedef sda_handles<int>::handle handle;
+
+int main()
+{
+	sda_handles<int> a;
+	vector<pair<int, handle>> live;
+	vector<handle> erased;
+	bool right = true;
+	for(int i = 0; i < 40000; i++)
+	{
+		int op = rand() % 10;
+		if(op < 5)
+		{
+			size_t p = rand() % (live.size() + 1);
+			handle h = a.insert(p, i);
+			live.insert(live.begin() + p, {i, h});
+		}
+		else if(op == 5)
+			live.push_back({i, a.push_back(i)});
+		else if(op == 6)
+			live.insert(live.begin(), {i, a.push_front(i)});
+		else if(op == 7 && !live.empty())
+		{
+			size_t p = rand() % live.size();
+			size_t q = min(live.size(), p + rand() % 5);
+			a.erase(p, q);
+			for(size_t k = p; k < q; k++) erased.push_back(live[k].second);
+			live.erase(live.begin() + p, live.begin() + q);
+		}
+		else if(op == 8 && !live.empty())
+		{
+			size_t p = rand() % live.size();
+			a.erase_handle(live[p].second);
+			erased.push_back(live[p].second);
+			live.erase(live.begin() + p);
+		}
+		else if(!live.empty())
+		{
+			if(rand() % 2)
+			{
+				erased.push_back(live.back().second);
+				a.pop_back();
+				live.pop_back();
+			}
+			else
+			{
+				erased.push_back(live.front().second);
+				a.pop_front();
+				live.erase(live.begin());
+			}
+		}
+		if(i % 97 == 0)
+		{
+			for(size_t k = 0; k < live.size(); k++)
+			{
+				handle h = live[k].second;
+				right = right && a.contains(h) && a.position(h) == k && a.get(h) == live[k].first
+					&& a.at(h) == live[k].first && a.handle_at(k) == h && a[k] == live[k].first;
+			}
+			for(handle h : erased)
+				right = right && !a.contains(h);
+		}
+	}
+	right = right && a.size() == live.size();
+	cout << (right ? "RIGHT" : "WRONG") << endl;
+
+	// a stale handle throws from at(), also after clear
+	bool thrown = false;
+	try
+	{
+		a.at(erased.back());
+	}
+	catch(const out_of_range&)
+	{
+		thrown = true;
+	}
+	handle before = live.empty() ? a.push_back(1) : live.front().second;
+	a.clear();
+	handle after = a.push_back(2);
+	cout << (thrown && !a.contains(before) && a.contains(after) && a.at(after) == 2 ? "RIGHT" : "WRONG") << endl;
+}
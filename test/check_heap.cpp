@@ -0,0 +1,95 @@
+#include<iostream>
+#include<functional>
+#include<set>
+#include<string>
+#include<vector>
+#include<cstdlib>
+
+#include "sda_minmax_heap.h"
+#include "check.h"
+
+using namespace std;
+
+//
+//
+//	CHECK HEAP
+//	sda_minmax_heap against multiset: min() and max() after
+//	every push, pop_min, pop_max, range push and rebuild,
+//	with many equal values and with a reversed Compare
+
+
+template<class T, class Compare>
+void check()
+{
+	sda_minmax_heap<T, Compare> h;
+	multiset<T, Compare> m;
+	bool right = true;
+	for(int i = 0; i < 30000; i++)
+	{
+		int op = rand() % 10;
+		if(op < 5 || m.empty())
+		{
+			T v = make<T>(rand() % 500);
+			if(op == 0)
+				h.emplace(v);
+			else
+				h.push(v);
+			m.insert(v);
+		}
+		else if(op < 7)
+		{
+			h.pop_min();
+			m.erase(m.begin());
+		}
+		else if(op < 9)
+		{
+			h.pop_max();
+			m.erase(prev(m.end()));
+		}
+		else
+		{
+			// small batches bubble up, large ones heapify
+			vector<T> batch(rand() % 2 ? rand() % 4 : m.size() + rand() % 50);
+			for(auto& v : batch) v = make<T>(rand() % 500);
+			h.push(batch.begin(), batch.end());
+			m.insert(batch.begin(), batch.end());
+		}
+		right = right && h.size() == m.size();
+		if(!m.empty())
+			right = right && h.min() == *m.begin() && h.max() == *prev(m.end());
+		if(m.size() > 2000)
+		{
+			h.clear();
+			m.clear();
+		}
+	}
+
+	// drain from both ends
+	vector<T> all;
+	for(int i = 0; i < 1000; i++) all.push_back(make<T>(rand() % 100));
+	sda_minmax_heap<T, Compare> g(all.begin(), all.end());
+	multiset<T, Compare> n(all.begin(), all.end());
+	while(!n.empty())
+	{
+		right = right && g.min() == *n.begin() && g.max() == *prev(n.end());
+		if(n.size() % 2)
+		{
+			g.pop_min();
+			n.erase(n.begin());
+		}
+		else
+		{
+			g.pop_max();
+			n.erase(prev(n.end()));
+		}
+	}
+	right = right && g.empty();
+	cout << (right ? "RIGHT" : "WRONG") << endl;
+}
+
+int main()
+{
+	check<int, less<int>>();
+	check<int, greater<int>>();
+	check<string, less<string>>();
+}
@@ -0,0 +1,203 @@
+#include<iostream>
+#include<algorithm>
+#include<deque>
+#include<string>
+#include<cstdlib>
+
+#include "sda_incremental.h"
+#include "check.h"
+
+using namespace std;
+
+//
+//
+//	CHECK INCREMENTAL
+//	sda_incremental against deque with a small step so most
+//	operations happen while elements are still moving: pushes
+//	and pops at both ends, insert and erase, pops that empty
+//	the new block before the old one; insert, erase and reserve
+//	during a move edit one block and leave the rest pending, the
+//	new block is a single allocation
+
+
+template<class T, class A>
+bool same(const sda_incremental<T, A>& a, const deque<T>& d)
+{
+	if(a.size() != d.size()) return false;
+	if(d.empty()) return a.empty();
+	return a.front() == d.front() && a.back() == d.back() && a[d.size() / 2] == d[d.size() / 2];
+}
+
+template<class T>
+void check(size_t step)
+{
+	sda_incremental<T> a(step, 16);
+	deque<T> d;
+	bool right = true;
+	size_t while_moving = 0;
+	for(int i = 0; i < 100000; i++)
+	{
+		if(a.pending()) while_moving++;
+		int op = rand() % 20;
+		T v = make<T>(i);
+		if(op < 7)
+		{
+			a.push_back(v);
+			d.push_back(v);
+		}
+		else if(op < 12)
+		{
+			a.push_front(v);
+			d.push_front(v);
+		}
+		else if(op < 15 && !d.empty())
+		{
+			a.pop_back();
+			d.pop_back();
+		}
+		else if(op < 18 && !d.empty())
+		{
+			a.pop_front();
+			d.pop_front();
+		}
+		else if(op == 18)
+		{
+			size_t p = rand() % (d.size() + 1);
+			a.insert(p, v);
+			d.insert(d.begin() + p, v);
+		}
+		else if(!d.empty())
+		{
+			size_t p = rand() % d.size();
+			size_t q = min(d.size(), p + rand() % 3);
+			a.erase(p, q);
+			d.erase(d.begin() + p, d.begin() + q);
+		}
+		right = right && same(a, d);
+		if(i % 1000 == 0)
+			right = right && equal(a.begin(), a.end(), d.begin(), d.end());
+	}
+	right = right && while_moving > 100;
+
+	// grow at one end, then pop everything from that end while the
+	// old block still holds the rest
+	for(int back = 0; back < 2; back++)
+	{
+		sda_incremental<T> b(1, 16);
+		deque<T> e;
+		int i = 0;
+		while(b.pending() == 0 || b.size() < 1000)
+		{
+			T v = make<T>(i++);
+			if(back)
+			{
+				b.push_back(v);
+				e.push_back(v);
+			}
+			else
+			{
+				b.push_front(v);
+				e.push_front(v);
+			}
+		}
+		while(!e.empty())
+		{
+			if(back)
+			{
+				b.pop_back();
+				e.pop_back();
+			}
+			else
+			{
+				b.pop_front();
+				e.pop_front();
+			}
+			right = right && same(b, e);
+		}
+		right = right && b.empty() && b.pending() == 0;
+	}
+	cout << (right ? "RIGHT" : "WRONG") << endl;
+}
+
+// positional edits right after a grow, with a step of 1 nearly
+// everything is still in the old block
+template<class T>
+void check_moving(bool back)
+{
+	sda_incremental<T, counting_allocator<T>> a(1, 16);
+	deque<T> d;
+	int i = 0;
+	size_t grown = 0;
+	while(a.pending() == 0 || a.size() < 10000)
+	{
+		T v = make<T>(i++);
+		size_t before = allocations;
+		if(back)
+		{
+			a.push_back(v);
+			d.push_back(v);
+		}
+		else
+		{
+			a.push_front(v);
+			d.push_front(v);
+		}
+		if(a.pending() && !grown) grown = allocations - before;
+	}
+	// the grow allocated once, the move is at its start
+	size_t pending = a.pending();
+	bool right = grown == 1 && pending > a.size() / 2;
+	for(int k = 0; k < 300; k++)
+	{
+		T v = make<T>(i++);
+		size_t p = rand() % (d.size() + 1);
+		switch(k % 4)
+		{
+			case 0:
+				a.insert(p, v);
+				d.insert(d.begin() + p, v);
+				break;
+			case 1:
+				// the boundary and both ends
+				p = k % 3 == 0 ? a.size() - a.pending() : k % 3 == 1 ? 0 : d.size();
+				a.insert(p, v);
+				d.insert(d.begin() + p, v);
+				break;
+			case 2:
+			{
+				p = rand() % d.size();
+				size_t q = min(d.size(), p + rand() % 5);
+				a.erase(p, q);
+				d.erase(d.begin() + p, d.begin() + q);
+				break;
+			}
+			case 3:
+				a.reserve(a.size() + rand() % 20000);
+				break;
+		}
+		right = right && same(a, d);
+	}
+	// a step per edit, nothing drained
+	right = right && a.pending() > 0 && a.pending() + 600 > pending;
+	right = right && equal(a.begin(), a.end(), d.begin(), d.end());
+	while(a.pending())
+	{
+		T v = make<T>(i++);
+		size_t p = d.size() / 2;
+		a.insert(p, v);
+		d.insert(d.begin() + p, v);
+	}
+	right = right && equal(a.begin(), a.end(), d.begin(), d.end()) && a.array().size() == d.size();
+	cout << (right ? "RIGHT" : "WRONG") << endl;
+}
+
+int main()
+{
+	check<int>(1);
+	check<int>(64);
+	check<string>(3);
+	check_moving<int>(true);
+	check_moving<int>(false);
+	check_moving<string>(true);
+	check_moving<string>(false);
+}
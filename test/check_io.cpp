@@ -0,0 +1,214 @@
+#include<iostream>
+#include<string>
+#include<cerrno>
+#include<cstdlib>
+#include<cstdio>
+
+#include<fcntl.h>
+#include<signal.h>
+#include<unistd.h>
+
+#include "sda_io.h"
+#include "check.h"
+
+using namespace std;
+
+//
+//
+//	CHECK IO
+//	sda_io over a pipe: reads land in the empty capacity and are
+//	committed, short reads keep what arrived, repeated appends
+//	grow geometrically; read_front does one read and does not wait
+//	for the rest, reads retry when a signal came before any byte,
+//	a scatter read refuses an array given twice
+
+
+void interrupted(int) {}
+
+template<class A>
+string text(const A& a)
+{
+	return string(a.begin(), a.end());
+}
+
+int main()
+{
+	string data;
+	for(int i = 0; i < 100000; i++) data += char('a' + rand() % 26);
+
+	//
+	// read_back until end of file, 1000 appends of 4096 bytes
+	// must not reallocate each time
+	//
+	{
+		int fd[2];
+		if(pipe(fd) != 0) return 1;
+		sda<char, counting_allocator<char>> a;
+		allocations = 0;
+		if(fork() == 0)
+		{
+			close(fd[0]);
+			for(size_t done = 0; done < data.size(); done += 1000)
+				if(::write(fd[1], data.data() + done, 1000) != 1000) _exit(1);
+			_exit(0);
+		}
+		close(fd[1]);
+		while(sda_io::read_back(fd[0], a, 4096) > 0) {}
+		close(fd[0]);
+		print(text(a) == data);
+
+		sda<char, counting_allocator<char>> b;
+		allocations = 0;
+		for(int i = 0; i < 1000; i++)
+		{
+			auto spare = b.append_uninitialized(4096);
+			spare.data()[0] = char(i);
+			b.commit_back(4096);
+		}
+		for(int i = 0; i < 1000; i++)
+		{
+			auto spare = b.prepend_uninitialized(4096);
+			spare.data()[0] = char(i);
+			b.commit_front(4096);
+		}
+		print(b.size() == 8192000 && b[4096000] == char(0) && b[0] == char(999) && allocations < 100);
+	}
+
+	//
+	// read_front: the bytes come out in order in front of the
+	// array, the last read is short at end of file
+	//
+	{
+		int fd[2];
+		if(pipe(fd) != 0) return 1;
+		if(::write(fd[1], data.data(), 10000) != 10000) return 1;
+		close(fd[1]);
+		sda<char> a;
+		a.push_back('!');
+		ssize_t r1 = sda_io::read_front(fd[0], a, 6000);
+		ssize_t r2 = sda_io::read_front(fd[0], a, 6000);
+		ssize_t r3 = sda_io::read_front(fd[0], a, 6000);
+		close(fd[0]);
+		print(r1 == 6000 && r2 == 4000 && r3 == 0
+			&& text(a) == data.substr(6000, 4000) + data.substr(0, 6000) + "!");
+	}
+
+	//
+	// read_front: an error after some bytes keeps them,
+	// an error with nothing read returns -1
+	//
+	{
+		int fd[2];
+		if(pipe(fd) != 0) return 1;
+		fcntl(fd[0], F_SETFL, O_NONBLOCK);
+		if(::write(fd[1], "0123456789", 10) != 10) return 1;
+		sda<char> a;
+		a.push_back('!');
+		ssize_t r1 = sda_io::read_front(fd[0], a, 100);
+		ssize_t r2 = sda_io::read_front(fd[0], a, 100);
+		close(fd[0]);
+		close(fd[1]);
+		print(r1 == 10 && r2 == -1 && text(a) == "0123456789!");
+	}
+
+	//
+	// readv_back and writev
+	//
+	{
+		int fd[2];
+		if(pipe(fd) != 0) return 1;
+		sda<char> header(4, 'H'), payload(8, 'p');
+		ssize_t w = sda_io::writev(fd[1], {&header, &payload});
+		close(fd[1]);
+		sda<char> h, p;
+		ssize_t r = sda_io::readv_back(fd[0], {&h, &p}, {4, 100});
+		close(fd[0]);
+		print(w == 12 && r == 12 && text(h) == "HHHH" && text(p) == "pppppppp");
+	}
+
+	//
+	// read_front returns what one read gave, with the writer
+	// still open it does not wait for the other 90 bytes
+	//
+	{
+		int fd[2];
+		if(pipe(fd) != 0) return 1;
+		if(::write(fd[1], "0123456789", 10) != 10) return 1;
+		sda<char> a;
+		a.push_back('!');
+		ssize_t r = sda_io::read_front(fd[0], a, 100);
+		close(fd[0]);
+		close(fd[1]);
+		print(r == 10 && text(a) == "0123456789!");
+	}
+
+	//
+	// a signal before any byte: the read is retried, not -1
+	//
+	{
+		int fd[2];
+		if(pipe(fd) != 0) return 1;
+		struct sigaction sa = {};
+		sa.sa_handler = interrupted;
+		sigaction(SIGUSR1, &sa, nullptr);
+		pid_t parent = getpid();
+		if(fork() == 0)
+		{
+			usleep(50000);
+			kill(parent, SIGUSR1);
+			usleep(50000);
+			_exit(::write(fd[1], "abc", 3) == 3 ? 0 : 1);
+		}
+		close(fd[1]);
+		sda<char> a;
+		ssize_t r = sda_io::read_front(fd[0], a, 10);
+		close(fd[0]);
+		print(r == 3 && text(a) == "abc");
+	}
+
+	//
+	// pread_front and readv_front from a file, both short at the
+	// end, the file position stays for pread
+	//
+	{
+		FILE* f = tmpfile();
+		if(!f) return 1;
+		int fd = fileno(f);
+		if(::write(fd, data.data(), 1000) != 1000) return 1;
+		lseek(fd, 0, SEEK_SET);
+		sda<char> a, h, p;
+		a.push_back('!');
+		ssize_t r1 = sda_io::pread_front(fd, a, 100, 500);
+		ssize_t r2 = sda_io::pread_front(fd, a, 100, 950);
+		bool right = r1 == 100 && r2 == 50 && lseek(fd, 0, SEEK_CUR) == 0;
+		right = right && text(a) == data.substr(950, 50) + data.substr(500, 100) + "!";
+		lseek(fd, 990, SEEK_SET);
+		h.push_back('h');
+		p.push_back('p');
+		ssize_t r3 = sda_io::readv_front(fd, {&h, &p}, {4, 100});
+		right = right && r3 == 10 && text(h) == data.substr(990, 4) + "h" && text(p) == data.substr(994, 6) + "p";
+		fclose(f);
+		print(right);
+	}
+
+	//
+	// one array twice in a scatter read fails before reserving
+	//
+	{
+		int fd[2];
+		if(pipe(fd) != 0) return 1;
+		if(::write(fd[1], "0123456789", 10) != 10) return 1;
+		sda<char> a, b;
+		a.push_back('!');
+		errno = 0;
+		ssize_t r1 = sda_io::readv_back(fd[0], {&a, &b, &a}, {4, 4, 4096});
+		bool right = r1 == -1 && errno == EINVAL && text(a) == "!" && b.empty();
+		errno = 0;
+		ssize_t r2 = sda_io::readv_front(fd[0], {&a, &a}, {4, 4});
+		right = right && r2 == -1 && errno == EINVAL && text(a) == "!";
+		ssize_t r3 = sda_io::readv_back(fd[0], {&a, &b}, {4, 4096});
+		close(fd[0]);
+		close(fd[1]);
+		print(right && r3 == 10 && text(a) == "!0123" && text(b) == "456789");
+	}
+}
@@ -0,0 +1,185 @@
+#include<iostream>
+#include<algorithm>
+#include<stdexcept>
+#include<string>
+#include<cstdlib>
+
+#include "sda_journal.h"
+#include "check.h"
+
+using namespace std;
+
+//
+//
+//	CHECK JOURNAL
+//	every operation of a journaled_sda replayed into a plain sda
+//	gives the same elements and the same front and back capacity,
+//	a replica fed batch by batch stays equal after every batch,
+//	a damaged trace is rejected, so is a record that does not fit
+//	the replica: it throws before anything is written out of bounds
+
+
+typedef unsigned long long value;
+
+template<class J>
+void random_op(J& j, int i)
+{
+	typedef typename J::value_type T;
+	T v = make<T>(i);
+	size_t n = j.size();
+	size_t p = rand() % (n + 1);
+	switch(rand() % 20)
+	{
+		case 0: case 1: case 2: j.push_back(v); break;
+		case 3: case 4: j.push_front(v); break;
+		case 5: if(n) j.pop_back(); break;
+		case 6: if(n) j.pop_front(); break;
+		case 7: j.insert(j.begin() + p, v); break;
+		case 8: j.insert(j.begin() + p, size_t(rand() % 5), v); break;
+		case 9:
+		{
+			T w[] = {v, make<T>(i + 1), make<T>(i + 2)};
+			j.insert(j.begin() + p, w, w + 3);
+			break;
+		}
+		case 10:
+			// join needs the room in this block
+			if(j.capacity() - n >= 2) j.join(j.begin() + p, 2, v);
+			break;
+		case 11:
+			if(n)
+			{
+				p = rand() % n;
+				j.erase(j.begin() + p, j.begin() + min(n, p + rand() % 4));
+			}
+			break;
+		case 12: if(n) j.set(rand() % n, v); break;
+		case 13: j.reserve(n + rand() % 50); break;
+		case 14: j.reserve_front(n + rand() % 50); break;
+		case 15: j.reserve_back(n + rand() % 50); break;
+		case 16:
+		{
+			size_t room = j.array().empty_front_capacity() + j.array().empty_back_capacity();
+			if(rand() % 2) j.slide_to_front(room ? rand() % room : 0);
+			else j.slide_to_back(room ? rand() % room : 0);
+			break;
+		}
+		case 17:
+			if(rand() % 2) j.resize_front(n + rand() % 5 - min<size_t>(n, 2), v);
+			else j.resize_back(n + rand() % 5 - min<size_t>(n, 2));
+			break;
+		case 18: if(rand() % 10 == 0) j.shrink_to_fit(); break;
+		case 19: if(rand() % 50 == 0) j.clear(); break;
+	}
+}
+
+int main()
+{
+	//
+	// one trace, replayed from the start
+	//
+	{
+		journaled_sda<value> j;
+		for(int i = 0; i < 20000; i++) random_op(j, i);
+		sda<value> copy;
+		sda_journal_reader in(j.journal().data(), j.journal().size());
+		in.replay(copy);
+		cout << (same(copy, j.array()) && copy.empty_front_capacity() == j.array().empty_front_capacity()
+			&& copy.empty_back_capacity() == j.array().empty_back_capacity() ? "RIGHT" : "WRONG") << endl;
+	}
+
+	//
+	// a replica brought up to date batch by batch, starting
+	// from an array that already has elements
+	//
+	{
+		sda<value> start;
+		for(value v = 0; v < 100; v++) start.push_back(v);
+		journaled_sda<value> j(start);
+		sda<value> replica;
+		bool right = true;
+		for(int batch = 0; batch < 500; batch++)
+		{
+			int ops = rand() % 50;
+			for(int i = 0; i < ops; i++) random_op(j, batch * 100 + i);
+			sda_journal_reader in(j.journal().data(), j.journal().size());
+			in.replay(replica);
+			j.journal().clear();
+			right = right && same(replica, j.array());
+		}
+		cout << (right ? "RIGHT" : "WRONG") << endl;
+	}
+
+	//
+	// values that are not trivially copyable are not written,
+	// the replay keeps the shape with value_type()
+	//
+	{
+		journaled_sda<string> j;
+		for(int i = 0; i < 2000; i++) random_op(j, i);
+		sda<string> copy;
+		sda_journal_reader in(j.journal().data(), j.journal().size());
+		in.replay(copy);
+		cout << (in.value_size() == 0 && copy.size() == j.size() ? "RIGHT" : "WRONG") << endl;
+	}
+
+	//
+	// a cut trace throws
+	//
+	{
+		journaled_sda<value> j;
+		for(int i = 0; i < 100; i++) j.insert(j.begin(), 3, value(i));
+		bool thrown = false;
+		try
+		{
+			sda<value> copy;
+			sda_journal_reader in(j.journal().data(), j.journal().size() - 5);
+			in.replay(copy);
+		}
+		catch(const runtime_error&)
+		{
+			thrown = true;
+		}
+		cout << (thrown ? "RIGHT" : "WRONG") << endl;
+	}
+
+	//
+	// records past the end of a 10 element replica throw and
+	// leave it as it was
+	//
+	{
+		const size_t bad[][3] = {
+			{size_t(sda_op::erase), 8, 3}, {size_t(sda_op::erase), 11, 0},
+			{size_t(sda_op::erase), 5, size_t(-1)}, {size_t(sda_op::insert), 11, 1},
+			{size_t(sda_op::join), 1000, 1}, {size_t(sda_op::set), 10, 1},
+			{size_t(sda_op::resize_back), 2, 3}, {size_t(sda_op::resize_front), 0, 1},
+			{size_t(sda_op::slide_to_front), 1000, 0}, {size_t(sda_op::slide_to_back), size_t(-1), 0},
+			{size_t(sda_op::pop_back), 0, 0}};
+		bool right = true;
+		for(auto& b : bad)
+		{
+			sda_journal trace(sizeof(value));
+			sda_op code = sda_op(b[0]);
+			trace.op(code);
+			if(code != sda_op::pop_back) trace.put(b[1]);
+			if(code != sda_op::set && code != sda_op::slide_to_front && code != sda_op::slide_to_back && code != sda_op::pop_back)
+				trace.put(b[2]);
+			if(code != sda_op::erase)
+				for(size_t i = 0; i < b[2] && i < 3; i++) trace.values(&b[1], 1);
+			sda<value> copy(code == sda_op::pop_back ? 0 : 10, 7);
+			copy.shrink_to_fit();
+			bool thrown = false;
+			try
+			{
+				sda_journal_reader in(trace.data(), trace.size());
+				in.replay(copy);
+			}
+			catch(const runtime_error&)
+			{
+				thrown = true;
+			}
+			right = right && thrown && copy.size() == (code == sda_op::pop_back ? 0 : 10);
+		}
+		cout << (right ? "RIGHT" : "WRONG") << endl;
+	}
+}
\ No newline at end of file
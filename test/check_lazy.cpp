@@ -0,0 +1,86 @@
+#include<iostream>
+#include<algorithm>
+#include<vector>
+#include<string>
+#include<cstdlib>
+
+#include "lazy_sda.h"
+
+using namespace std;
+
+//
+//
+//	CHECK LAZY
+//	lazy_sda against vector, print "WRONG"
+//	if any operation gives a different sequence
+
+
+template<class B>
+void check(lazy_sda<string>& a, const B& b)
+{
+	bool right = a.size() == b.size();
+	// through the log first, then merged
+	for(size_t i = 0; right && i < b.size(); i++)
+		if(a.peek(i) != b[i]) right = false;
+	right = right && equal(b.begin(), b.end(), a.begin(), a.end()) && a.pending() == 0;
+	cout << (right ? "RIGHT" : "WRONG") << endl;
+}
+
+int main()
+{
+	const int n = 2000;
+
+	for(int round = 0; round < 10; round++)
+	{
+		vector<string> v;
+		lazy_sda<string> a;
+		for(int i = 0; i < n; i++)
+		{
+			string value = to_string(rand() % 1000);
+			size_t pos = rand() % (v.size() + 1);
+			switch(rand() % 8)
+			{
+				case 0: v.push_back(value); a.push_back(value); break;
+				case 1: v.insert(v.begin(), value); a.push_front(value); break;
+				case 2: case 3: v.insert(v.begin() + pos, value); a.insert(pos, value); break;
+				case 4:
+				{
+					size_t count = rand() % 4;
+					v.insert(v.begin() + pos, count, value);
+					a.insert(pos, count, value);
+					break;
+				}
+				case 5:
+					if(pos < v.size()) { v.erase(v.begin() + pos); a.erase(pos); }
+					break;
+				case 6:
+				{
+					// slice out a range, cutting pieces on both sides
+					size_t last = pos + rand() % (v.size() - pos + 1);
+					v.erase(v.begin() + pos, v.begin() + last);
+					a.erase(pos, last);
+					break;
+				}
+				case 7:
+					// a read in the middle merges the log
+					if(rand() % 20 == 0 && !v.empty() && a[0] != v[0]) cout << "WRONG" << endl;
+					break;
+			}
+		}
+		check(a, v);
+	}
+
+	//
+	// release() hands over the merged array
+	//
+	lazy_sda<string> a;
+	vector<string> v;
+	for(int i = 0; i < n; i++)
+	{
+		size_t pos = rand() % (v.size() + 1);
+		v.insert(v.begin() + pos, to_string(i));
+		a.insert(pos, to_string(i));
+	}
+	sda<string> released = a.release();
+	cout << (a.empty() && equal(v.begin(), v.end(), released.begin(), released.end()) ? "RIGHT" : "WRONG") << endl;
+}
@@ -0,0 +1,121 @@
+#include<iostream>
+#include<algorithm>
+#include<functional>
+#include<forward_list>
+#include<iterator>
+#include<type_traits>
+#include<list>
+#include<vector>
+#include<string>
+#include<cstdlib>
+
+#include "sda.h"
+#include "check.h"
+
+using namespace std;
+
+//
+//
+//	CHECK MERGE
+//	merge_sorted and inplace_merge against std::merge and
+//	std::inplace_merge, equal keys carry a tag so stability
+//	is checked, repeated small merges grow geometrically,
+//	single pass iterators are refused at compile time
+
+
+struct kv
+{
+	int k;
+	string tag;
+	bool operator<(const kv& o) const { return k < o.k; }
+	bool operator>(const kv& o) const { return k > o.k; }
+	bool operator==(const kv& o) const { return k == o.k && tag == o.tag; }
+};
+
+// merge_sorted measures the range before it merges
+template<class A, class I, class = void>
+struct can_merge : false_type {};
+template<class A, class I>
+struct can_merge<A, I, void_t<decltype(declval<A&>().merge_sorted(declval<I>(), declval<I>()))>> : true_type {};
+static_assert(can_merge<sda<int>, forward_list<int>::iterator>::value, "forward iterators merge");
+static_assert(!can_merge<sda<int>, istream_iterator<int>>::value, "input iterators are refused");
+
+template<class Compare>
+void check(Compare comp)
+{
+	bool right = true;
+	for(int round = 0; round < 3000; round++)
+	{
+		sda<kv> a;
+		vector<kv> v;
+		int n = rand() % 100;
+		for(int i = 0; i < n; i++) v.push_back({rand() % 50, "a" + to_string(i)});
+		stable_sort(v.begin(), v.end(), comp);
+		for(auto& x : v)
+			a.push_back(x);
+		if(rand() % 3 == 0) a.reserve_front(a.size() + rand() % 100);
+		if(rand() % 3 == 0) a.reserve_back(a.size() + rand() % 100);
+
+		vector<kv> b;
+		int m = rand() % 60;
+		for(int i = 0; i < m; i++) b.push_back({rand() % 50, "b" + to_string(i)});
+		stable_sort(b.begin(), b.end(), comp);
+		vector<kv> expect;
+		merge(v.begin(), v.end(), b.begin(), b.end(), back_inserter(expect), comp);
+		switch(rand() % 3)
+		{
+			case 0:
+				a.merge_sorted(b.begin(), b.end(), comp);
+				break;
+			case 1:
+			{
+				forward_list<kv> f(b.begin(), b.end());
+				a.merge_sorted(f.begin(), f.end(), comp);
+				break;
+			}
+			case 2:
+			{
+				list<kv> l(b.begin(), b.end());
+				a.merge_sorted(l.begin(), l.end(), comp);
+				break;
+			}
+		}
+		right = right && equal(a.begin(), a.end(), expect.begin(), expect.end());
+
+		// two sorted runs in one array
+		sda<kv> c;
+		vector<kv> e;
+		size_t split = rand() % (expect.size() + 1);
+		vector<kv> run(expect.begin() + split, expect.end());
+		for(auto& x : run) x.k = rand() % 50;
+		stable_sort(run.begin(), run.end(), comp);
+		e.assign(expect.begin(), expect.begin() + split);
+		e.insert(e.end(), run.begin(), run.end());
+		for(auto& x : e) c.push_back(x);
+		if(rand() % 2) c.shrink_to_fit();
+		inplace_merge(e.begin(), e.begin() + split, e.end(), comp);
+		c.inplace_merge(c.begin() + split, comp);
+		right = right && equal(c.begin(), c.end(), e.begin(), e.end());
+	}
+	cout << (right ? "RIGHT" : "WRONG") << endl;
+}
+
+int main()
+{
+	check(less<kv>());
+	check(greater<kv>());
+
+	// merging small batches into a growing array
+	sda<int, counting_allocator<int>> a;
+	vector<int> v;
+	allocations = 0;
+	for(int i = 0; i < 5000; i++)
+	{
+		int batch[] = {rand() % 1000, rand() % 1000, rand() % 1000};
+		sort(batch, batch + 3);
+		a.merge_sorted(batch, batch + 3);
+		v.insert(v.end(), batch, batch + 3);
+	}
+	sort(v.begin(), v.end());
+	cout << (equal(a.begin(), a.end(), v.begin(), v.end()) && allocations < 100 ? "RIGHT" : "WRONG") << endl;
+}
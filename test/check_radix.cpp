@@ -0,0 +1,140 @@
+#include<iostream>
+#include<algorithm>
+#include<vector>
+#include<cstdint>
+#include<cstdlib>
+
+#include "sda_radix_sort.h"
+
+using namespace std;
+
+//
+//
+//	CHECK RADIX
+//	sda_radix_sort and sda_radix_sort_parallel against sort and
+//	stable_sort for signed and unsigned keys and a key extractor,
+//	with the scratch in the front slack, in the back slack, split
+//	over both sides (slide first) and missing (grow)
+
+
+struct order
+{
+	int32_t price;
+	uint64_t time;
+	uint32_t id;
+	bool operator==(const order& o) const { return price == o.price && time == o.time && id == o.id; }
+};
+
+template<class T>
+T random_value()
+{
+	uint64_t r = (uint64_t(rand()) << 33) ^ (uint64_t(rand()) << 11) ^ uint64_t(rand());
+	// few distinct high digits now and then, so passes get skipped
+	if(rand() % 4 == 0) r &= 0xFFFF;
+	return T(r);
+}
+template<>
+order random_value<order>()
+{
+	return order{int32_t(rand() % 2001) - 1000, uint64_t(rand() % 50), uint32_t(rand())};
+}
+
+// the same elements with the scratch placed as asked
+template<class T>
+sda<T> layout(const vector<T>& v, int where)
+{
+	sda<T> a;
+	size_t n = v.size();
+	switch(where)
+	{
+		case 0:
+			// front slack
+			a.reserve_front(2 * n + 1);
+			for(size_t i = n; i-- > 0; ) a.push_front(v[i]);
+			a.slide_to_back();
+			break;
+		case 1:
+			// back slack
+			a.reserve_back(2 * n + 1);
+			for(const T& x : v) a.push_back(x);
+			a.slide_to_front();
+			break;
+		case 2:
+			// n / 2 + 1 on each side, neither is enough alone
+			a.reserve(2 * n + 2);
+			for(const T& x : v) a.push_back(x);
+			a.slide_to_front(a.capacity() - n - (n / 2 + 1));
+			break;
+		default:
+			// no slack at all
+			a.assign(v.begin(), v.end());
+			a.shrink_to_fit();
+			break;
+	}
+	return a;
+}
+
+template<class T>
+void check()
+{
+	bool right = true;
+	size_t sizes[] = {0, 1, 2, 63, 64, 65, 1000, 4097, 100000};
+	for(size_t n : sizes)
+		for(int where = 0; where < 4; where++)
+		{
+			vector<T> v(n);
+			for(T& x : v) x = random_value<T>();
+			vector<T> expect(v);
+			sort(expect.begin(), expect.end());
+
+			sda<T> a = layout(v, where);
+			sda_radix_sort(a);
+			right = right && equal(a.begin(), a.end(), expect.begin(), expect.end());
+
+			sda<T> b = layout(v, where);
+			sda_radix_sort_parallel(b, 1 + where);
+			right = right && equal(b.begin(), b.end(), expect.begin(), expect.end());
+		}
+	cout << (right ? "RIGHT" : "WRONG") << endl;
+}
+
+template<class Key, class Less>
+void check_key(Key key, Less less)
+{
+	bool right = true;
+	size_t sizes[] = {0, 1, 50, 5000, 100000};
+	for(size_t n : sizes)
+		for(int where = 0; where < 4; where++)
+		{
+			vector<order> v(n);
+			for(order& x : v) x = random_value<order>();
+			vector<order> expect(v);
+			stable_sort(expect.begin(), expect.end(), less);
+
+			sda<order> a = layout(v, where);
+			sda_radix_sort(a, key);
+			right = right && equal(a.begin(), a.end(), expect.begin(), expect.end());
+
+			sda<order> b = layout(v, where);
+			sda_radix_sort_parallel(b, key, where == 3 ? 0 : 4);
+			right = right && equal(b.begin(), b.end(), expect.begin(), expect.end());
+		}
+	cout << (right ? "RIGHT" : "WRONG") << endl;
+}
+
+int main()
+{
+	check<int8_t>();
+	check<uint8_t>();
+	check<int16_t>();
+	check<int32_t>();
+	check<uint32_t>();
+	check<int64_t>();
+	check<uint64_t>();
+
+	// signed key and unsigned key, equal keys keep their order
+	check_key([](const order& o) { return o.price; },
+		[](const order& x, const order& y) { return x.price < y.price; });
+	check_key([](const order& o) { return o.time; },
+		[](const order& x, const order& y) { return x.time < y.time; });
+}
@@ -1,6 +1,8 @@
 #include<iostream>
 #include<algorithm>
 #include<vector>
+#include<sstream>
+#include<iterator>
 
 #include "sda.h"
 
@@ -131,4 +133,23 @@ int main()
 	}
 	check(v6, a6);
 
+
+	//
+	// insert from single pass iterator
+	//
+	vector<int> v7;
+	sda<int> a7;
+	for(int i = 0; i < n / 10; i++)
+	{
+		stringstream ss;
+		size_t count = rand() % 11;
+		for(size_t j = 0; j < count; j++) ss << rand() << ' ';
+		size_t pos = rand() % (v7.size() + 1);
+		string s = ss.str();
+		stringstream s1(s), s2(s);
+		v7.insert(v7.begin() + pos, istream_iterator<int>(s1), istream_iterator<int>());
+		a7.insert(a7.begin() + pos, istream_iterator<int>(s2), istream_iterator<int>());
+	}
+	check(v7, a7);
+
 }
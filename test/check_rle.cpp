@@ -0,0 +1,114 @@
+#include<iostream>
+#include<algorithm>
+#include<vector>
+#include<string>
+#include<cstdlib>
+
+#include "sda_rle.h"
+#include "check.h"
+
+using namespace std;
+
+//
+//
+//	CHECK RLE
+//	sda_rle against vector for fill insert, range erase, set and
+//	pushes at both ends, runs are maximal: no two adjacent runs
+//	hold equal values and the runs cover the sequence exactly
+
+
+template<class T>
+bool same(const sda_rle<T>& a, const vector<T>& v)
+{
+	if(a.size() != v.size() || !equal(a.begin(), a.end(), v.begin(), v.end()))
+		return false;
+	size_t covered = 0;
+	for(size_t i = 0; i < a.run_count(); i++)
+	{
+		if(a.run_position(i) != covered || a.run_length(i) == 0) return false;
+		if(i > 0 && a.run_value(i) == a.run_value(i - 1)) return false;
+		covered += a.run_length(i);
+	}
+	// as many runs as a plain run-length encoding of v
+	size_t runs = v.empty() ? 0 : 1;
+	for(size_t i = 1; i < v.size(); i++)
+		if(!(v[i] == v[i - 1])) runs++;
+	return covered == v.size() && a.run_count() == runs;
+}
+
+template<class T>
+void check()
+{
+	sda_rle<T> a;
+	vector<T> v;
+	bool right = true;
+	for(int i = 0; i < 20000; i++)
+	{
+		// few values so runs meet and merge often
+		T val = make<T>(rand() % 3);
+		int op = rand() % 8;
+		if(op < 3)
+		{
+			size_t p = rand() % (v.size() + 1);
+			size_t n = rand() % 20;
+			a.insert(p, n, val);
+			v.insert(v.begin() + p, n, val);
+		}
+		else if(op == 3 && !v.empty())
+		{
+			size_t p = rand() % v.size();
+			size_t q = min(v.size(), p + rand() % 30);
+			a.erase(p, q);
+			v.erase(v.begin() + p, v.begin() + q);
+		}
+		else if(op == 4 && !v.empty())
+		{
+			size_t p = rand() % v.size();
+			a.set(p, val);
+			v[p] = val;
+		}
+		else if(op == 5)
+		{
+			a.push_back(val);
+			v.push_back(val);
+		}
+		else if(op == 6)
+		{
+			a.push_front(val);
+			v.insert(v.begin(), val);
+		}
+		else if(!v.empty())
+		{
+			if(rand() % 2)
+			{
+				a.pop_back();
+				v.pop_back();
+			}
+			else
+			{
+				a.pop_front();
+				v.erase(v.begin());
+			}
+		}
+		right = right && same(a, v);
+		if(!v.empty())
+		{
+			size_t p = rand() % v.size();
+			right = right && a[p] == v[p] && a.front() == v.front() && a.back() == v.back();
+		}
+		if(v.size() > 3000)
+		{
+			a.erase(0, 2000);
+			v.erase(v.begin(), v.begin() + 2000);
+		}
+	}
+	// reverse iteration
+	right = right && equal(v.rbegin(), v.rend(), reverse_iterator<typename sda_rle<T>::const_iterator>(a.end()));
+	cout << (right ? "RIGHT" : "WRONG") << endl;
+}
+
+int main()
+{
+	check<int>();
+	check<string>();
+}
@@ -0,0 +1,207 @@
+#include<iostream>
+#include<algorithm>
+#include<deque>
+#include<cstring>
+#include<cstdlib>
+#include<memory>
+#include<new>
+
+#include "sda_shm.h"
+
+#ifdef SDA_SHM_SEGMENT
+#include<sys/wait.h>
+#endif
+
+using namespace std;
+
+//
+//
+//	CHECK SHM
+//	offset_ptr survives a move of the memory holding it, sda with
+//	shm_allocator against deque for a non-trivial element type,
+//	the arena gets every byte back, a copy of the whole arena at
+//	another address reads and grows, a second process reads the
+//	segment
+
+
+int live = 0;
+
+// non-trivial, no pointer outside the arena
+struct quote
+{
+	char symbol[8];
+	int price;
+
+	quote(int p = 0) : price(p)
+	{
+		snprintf(symbol, sizeof(symbol), "Q%d", p % 1000);
+		live++;
+	}
+	quote(const quote& o) : price(o.price)
+	{
+		memcpy(symbol, o.symbol, sizeof(symbol));
+		live++;
+	}
+	quote& operator=(const quote& o)
+	{
+		price = o.price;
+		memcpy(symbol, o.symbol, sizeof(symbol));
+		return *this;
+	}
+	~quote()
+	{
+		live--;
+	}
+	bool operator==(const quote& o) const { return price == o.price && strcmp(symbol, o.symbol) == 0; }
+};
+
+typedef sda<quote, shm_allocator<quote>> shm_quotes;
+typedef sda<int, shm_allocator<int>, sda_aligned_policy> shm_ints;
+
+void check(bool right)
+{
+	cout << (right ? "RIGHT" : "WRONG") << endl;
+}
+
+int main()
+{
+	//
+	// offset_ptr: a node pointing into itself, copied byte by byte
+	//
+	{
+		struct node
+		{
+			int v[4];
+			offset_ptr<int> p;
+		};
+		alignas(node) unsigned char from[sizeof(node)], to[sizeof(node)];
+		node* a = ::new(from) node{{1, 2, 3, 4}, nullptr};
+		a->p = a->v + 2;
+		memcpy(to, from, sizeof(node));
+		node* b = reinterpret_cast<node*>(to);
+		offset_ptr<int> q = b->p;
+		offset_ptr<int> n;
+		check(*b->p == 3 && b->p.get() == b->v + 2 && q[-2] == 1 && (q - 1) < q && q - offset_ptr<int>(b->v) == 2
+			&& !n && n == nullptr && q != nullptr);
+	}
+
+	//
+	// an arena in ordinary memory
+	//
+	const size_t bytes = 16 << 20;
+	unique_ptr<max_align_t[]> one(new max_align_t[bytes / sizeof(max_align_t)]);
+	unique_ptr<max_align_t[]> two(new max_align_t[bytes / sizeof(max_align_t)]);
+	sda_shm_arena* arena = ::new(one.get()) sda_shm_arena(bytes);
+	size_t empty = arena->available();
+	{
+		shm_quotes* a = ::new(arena->allocate(sizeof(shm_quotes))) shm_quotes(shm_allocator<quote>(arena));
+		arena->set_root(a);
+		deque<quote> d;
+		bool right = true;
+		for(int i = 0; i < 50000; i++)
+		{
+			size_t p = rand() % (d.size() + 1);
+			int k = rand() % 8;
+			if(k < 2)
+			{
+				a->push_back(quote(i));
+				d.push_back(quote(i));
+			}
+			else if(k < 4)
+			{
+				a->push_front(quote(i));
+				d.push_front(quote(i));
+			}
+			else if(k == 4)
+			{
+				a->insert(a->begin() + p, 3, quote(i));
+				d.insert(d.begin() + p, 3, quote(i));
+			}
+			else if(k == 5 && !d.empty())
+			{
+				p = rand() % d.size();
+				a->erase(a->begin() + p);
+				d.erase(d.begin() + p);
+			}
+			else if(k == 6 && !d.empty())
+			{
+				a->pop_back();
+				d.pop_back();
+			}
+			else if(!d.empty())
+			{
+				a->pop_front();
+				d.pop_front();
+			}
+			if(i % 5000 == 0)
+			{
+				a->shrink_to_fit();
+				right = right && equal(a->begin(), a->end(), d.begin(), d.end());
+			}
+		}
+		right = right && equal(a->begin(), a->end(), d.begin(), d.end());
+		check(right);
+
+		// the whole arena at another address
+		memcpy(two.get(), one.get(), bytes);
+		sda_shm_arena* copy = reinterpret_cast<sda_shm_arena*>(two.get());
+		shm_quotes* c = static_cast<shm_quotes*>(copy->root());
+		// the copy is dropped without destructors, its elements were never counted
+		int before = live;
+		c->push_back(quote(-1));
+		c->insert(c->begin() + c->size() / 2, 100, quote(-2));
+		d.push_back(quote(-1));
+		d.insert(d.begin() + d.size() / 2, 100, quote(-2));
+		check(copy->valid() && c->get_allocator().arena() == copy
+			&& equal(c->begin(), c->end(), d.begin(), d.end()));
+		live = before + 101;
+
+		a->~shm_quotes();
+		arena->deallocate(a, sizeof(shm_quotes));
+
+		// copies, moves and an aligned sda share the arena
+		shm_allocator<int> ints(arena);
+		shm_ints e(ints);
+		for(int i = 0; i < 1000; i++) e.push_front(i);
+		e.shrink_to_fit();
+		shm_ints f(e);
+		shm_ints g(std::move(f));
+		g.insert(g.begin() + 500, 7, 7);
+		check(e.size() == 1000 && g.size() == 1007 && g[500] == 7 && f.empty()
+			&& reinterpret_cast<uintptr_t>(e.data().get()) % 64 == 0);
+	}
+	check(arena->available() == empty && live == 0);
+
+#ifdef SDA_SHM_SEGMENT
+	//
+	// another process maps the segment
+	//
+	const char* name = "/sda_check_shm";
+	sda_shm_segment::remove(name);
+	{
+		sda_shm_segment w = sda_shm_segment::create(name, 1 << 20);
+		shm_quotes* a = w.construct<shm_quotes>();
+		long sum = 0;
+		for(int i = 0; i < 10000; i++)
+		{
+			a->push_front(quote(i));
+			sum += i;
+		}
+		pid_t pid = fork();
+		if(pid == 0)
+		{
+			sda_shm_segment r = sda_shm_segment::open(name);
+			const shm_quotes* b = r.find<shm_quotes>();
+			long read = 0;
+			for(const quote& q : *b) read += q.price;
+			_exit(read == sum && b->size() == 10000 && b->front().price == 9999 ? 0 : 1);
+		}
+		int status = 0;
+		waitpid(pid, &status, 0);
+		check(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+		a->~shm_quotes();
+		w.arena()->deallocate(a, sizeof(shm_quotes));
+	}
+	sda_shm_segment::remove(name);
+#endif
+}
@@ -0,0 +1,103 @@
+#include<iostream>
+#include<algorithm>
+#include<vector>
+#include<cstdlib>
+
+#include "sda.h"
+#include "check.h"
+
+using namespace std;
+
+//
+//
+//	CHECK SHRINK
+//	auto shrink of sda_policy: after erase, pop and resize the
+//	empty capacity of each side stays under
+//	shrink_high * size() + shrink_min, the memory goes back to
+//	the allocator and the elements are kept
+
+
+// small limits: relocation, never page release
+struct small_policy : sda_policy
+{
+	static constexpr size_t shrink_high = 2;
+	static constexpr size_t shrink_min = 16;
+};
+
+// blocks of 4 KB and up release pages in place first
+struct release_policy : sda_policy
+{
+	static constexpr size_t shrink_high = 2;
+	static constexpr size_t release_bytes = 4096;
+};
+
+// pages given back in place keep the capacity, until the whole
+// empty capacity passes shrink_realloc * size() + shrink_min
+template<class Policy, class A>
+bool bounded(const A& a)
+{
+	size_t high = Policy::shrink_high * a.size() + Policy::shrink_min;
+	if(a.empty_front_capacity() <= high && a.empty_back_capacity() <= high) return true;
+	return a.capacity() * sizeof(int) >= Policy::release_bytes
+		&& a.empty_capacity() <= Policy::shrink_realloc * a.size() + Policy::shrink_min;
+}
+
+template<class Policy>
+void run(bool relocates)
+{
+	const int n = 100000;
+	typedef sda<int, counting_allocator<int>, Policy> array;
+	bool right = true;
+	{
+		array a;
+		vector<int> v;
+		for(int i = 0; i < n; i++)
+		{
+			int value = rand();
+			a.push_back(value);
+			v.push_back(value);
+		}
+		size_t full = live_bytes;
+
+		// pops at both ends
+		for(int i = 0; i < n / 2; i++)
+		{
+			if(i % 2) { a.pop_back(); v.pop_back(); }
+			else { a.pop_front(); v.erase(v.begin()); }
+			if(!bounded<Policy>(a)) right = false;
+		}
+		right = right && same(a, v);
+
+		// single and range erases
+		while(v.size() > 100)
+		{
+			size_t pos = rand() % v.size();
+			size_t count = min<size_t>(rand() % 100, v.size() - pos);
+			a.erase(a.begin() + pos, a.begin() + pos + count);
+			v.erase(v.begin() + pos, v.begin() + pos + count);
+			if(!bounded<Policy>(a)) right = false;
+		}
+		right = right && same(a, v);
+
+		// resize down
+		a.resize_back(10);
+		v.resize(10);
+		right = right && same(a, v) && bounded<Policy>(a);
+		if(relocates) right = right && live_bytes < full / 100;
+	}
+	right = right && live_bytes == 0;
+	cout << (right ? "RIGHT" : "WRONG") << endl;
+}
+
+int main()
+{
+	run<small_policy>(true);
+	run<sda_shrink_policy>(true);
+	run<release_policy>(false);
+
+	// default policy never shrinks
+	sda<int> a(1000);
+	size_t capacity = a.capacity();
+	a.erase(a.begin(), a.begin() + 990);
+	cout << (a.capacity() == capacity ? "RIGHT" : "WRONG") << endl;
+}
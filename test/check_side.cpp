@@ -0,0 +1,139 @@
+#include<iostream>
+#include<algorithm>
+#include<vector>
+#include<string>
+#include<cstdlib>
+
+#include "sda.h"
+#include "check.h"
+
+using namespace std;
+
+//
+//
+//	CHECK SIDE
+//	the side insert and emplace take: a side with room wins over
+//	a nearer side that must reallocate, within a bounded band;
+//	realloc_percent = realloc_fixed = 0 is the plain nearest end
+
+
+struct nearest_policy : sda_policy
+{
+	static constexpr size_t realloc_percent = 0;
+	static constexpr size_t realloc_fixed = 0;
+};
+
+// trivially destructible, but moved by hand
+struct tracked
+{
+	int x = 0;
+	tracked() = default;
+	tracked(int v) : x(v) {}
+	tracked(tracked&& o) noexcept : x(o.x) {}
+	tracked(const tracked& o) : x(o.x) {}
+	tracked& operator=(const tracked&) = default;
+	bool operator==(const tracked& o) const { return x == o.x; }
+};
+
+// size elements, slack empty slots in front, none behind
+template<class A>
+A with_front_slack(size_t size, size_t slack)
+{
+	A a;
+	a.reserve_back(size);
+	for(size_t i = 0; i < size; i++) a.emplace_back(int(i));
+	a.reserve_front(size + slack);
+	return a;
+}
+
+int main()
+{
+	//
+	// just past the midpoint the back is nearer but full:
+	// the front has room, nothing reallocates
+	//
+	{
+		bool right = true;
+		for(int step = 0; step < 4; step++)
+		{
+			sda<int> a = with_front_slack<sda<int>>(1000, 300);
+			vector<int> v(a.begin(), a.end());
+			right = right && a.empty_back_capacity() == 0 && a.empty_front_capacity() >= 300;
+			const int* data = a.data();
+			size_t capacity = a.capacity();
+			size_t pos = a.size() / 2 + 1;
+			int many[3] = {-4, -5, -6};
+			switch(step)
+			{
+				case 0: a.insert(a.begin() + pos, -1); break;
+				case 1: a.emplace(a.begin() + pos, -2); break;
+				case 2: a.insert(a.begin() + pos, 3, -3); break;
+				case 3: a.insert(a.begin() + pos, many, many + 3); break;
+			}
+			switch(step)
+			{
+				case 0: v.insert(v.begin() + pos, -1); break;
+				case 1: v.insert(v.begin() + pos, -2); break;
+				case 2: v.insert(v.begin() + pos, 3, -3); break;
+				case 3: v.insert(v.begin() + pos, many, many + 3); break;
+			}
+			// same block, the front half moved into the slack
+			right = right && a.capacity() == capacity && a.data() + a.size() == data + 1000 && same(a, v);
+			right = right && a.empty_back_capacity() == 0;
+		}
+		print(right);
+	}
+
+	//
+	// the band is bounded: next to the back end reallocating
+	// is cheaper than shifting nearly everything
+	//
+	{
+		sda<int> a = with_front_slack<sda<int>>(1000, 300);
+		vector<int> v(a.begin(), a.end());
+		size_t capacity = a.capacity();
+		a.insert(a.end() - 3, -1);
+		v.insert(v.end() - 3, -1);
+		print(a.insert_at_back(a.size() - 3, 1) && a.capacity() > capacity && same(a, v));
+	}
+
+	//
+	// both knobs at 0: the nearer end, full or not
+	//
+	{
+		sda<int, allocator<int>, nearest_policy> a = with_front_slack<sda<int, allocator<int>, nearest_policy>>(1000, 300);
+		vector<int> v(a.begin(), a.end());
+		size_t capacity = a.capacity();
+		size_t pos = a.size() / 2 + 1;
+		a.insert(a.begin() + pos, -1);
+		v.insert(v.begin() + pos, -1);
+		bool right = a.capacity() > capacity && same(a, v);
+		for(int i = 0; i < 20000; i++)
+		{
+			size_t p = rand() % (a.size() + 1), n = 1 + rand() % 3;
+			// ties go to the front
+			right = right && a.insert_at_back(p, n) == (a.size() - p < p);
+			if(rand() % 2) { a.insert(a.begin() + p, n, i); v.insert(v.begin() + p, n, i); }
+			else { a.erase(a.begin() + p / 2); v.erase(v.begin() + p / 2); }
+		}
+		print(right && same(a, v));
+	}
+
+	//
+	// reallocation weight: doubled unless moves and destructors
+	// are both trivial
+	//
+	{
+		sda<int> a(1000, 1);
+		sda<string> s(1000, "x");
+		sda<tracked> t(1000, tracked(1));
+		a.shrink_to_fit();
+		s.shrink_to_fit();
+		t.shrink_to_fit();
+		bool right = a.insert_cost(10, 1, true) == 990 + 250 + 64;
+		right = right && s.insert_cost(10, 1, true) == 990 + 500 + 64;
+		right = right && t.insert_cost(10, 1, true) == 990 + 500 + 64;
+		right = right && a.insert_cost(10, 1, false) == 10 + 250 + 64;
+		print(right);
+	}
+}
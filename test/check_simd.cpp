@@ -0,0 +1,115 @@
+#include<iostream>
+#include<algorithm>
+#include<limits>
+#include<vector>
+#include<cstdint>
+#include<cstdlib>
+
+#include "sda_simd.h"
+
+using namespace std;
+
+//
+//
+//	CHECK SIMD
+//	every kernel at every isa_limit() level against the scalar
+//	loops, sizes around and between the lane counts, with and
+//	without empty back capacity for the masked tail loads
+
+
+using namespace sda_simd;
+
+template<class T>
+T random_value()
+{
+	// few distinct values so find and count hit, extremes for unsigned compares
+	T v = T(rand() % 101);
+	if constexpr (is_signed<T>::value) v = T(v - 50);
+	if constexpr (is_unsigned<T>::value)
+		if(rand() % 8 == 0) v = T(numeric_limits<T>::max() - v);
+	return v;
+}
+
+template<class T>
+sda<T> layout(const vector<T>& v, bool slack)
+{
+	sda<T> a;
+	if(slack) a.reserve_back(v.size() + 64);
+	a.assign(v.begin(), v.end());
+	if(!slack) a.shrink_to_fit();
+	return a;
+}
+
+template<class T>
+bool same_at_level(const vector<T>& v, bool slack)
+{
+	typedef typename sda<T>::const_iterator iterator;
+	const sda<T> a = layout(v, slack);
+	size_t n = v.size();
+	bool right = true;
+	for(int k = 0; k < 4; k++)
+	{
+		T x = n ? v[rand() % n] : T(0);
+		if(k == 3) x = T(77);
+		right = right && size_t(sda_simd::find(a, x) - a.begin()) == scalar::find(v.data(), n, x, 0);
+		right = right && sda_simd::count(a, x) == scalar::count(v.data(), n, x, 0);
+		T lo = min(x, random_value<T>()), hi = max(x, random_value<T>());
+		iterator f = sda_simd::find_between(a, lo, hi);
+		right = right && size_t(f - a.begin()) == scalar::find_between(v.data(), n, lo, hi, 0);
+	}
+	if(n)
+	{
+		right = right && sda_simd::min(a) == scalar::min(v.data(), n) && sda_simd::max(a) == scalar::max(v.data(), n);
+		right = right && argmin(a) == size_t(min_element(v.begin(), v.end()) - v.begin());
+		right = right && argmax(a) == size_t(max_element(v.begin(), v.end()) - v.begin());
+	}
+	// small values keep float sums exact, unsigned ones wrap the same way
+	right = right && sda_simd::sum(a) == scalar::sum(v.data(), n);
+	sda<T> b = layout(v, slack);
+	vector<T> w(v);
+	sda_simd::prefix_sum(b);
+	scalar::prefix_sum(w.data(), n);
+	return right && equal(b.begin(), b.end(), w.begin(), w.end());
+}
+
+template<class T>
+void check()
+{
+	bool right = true;
+	isa levels[] = {isa::scalar, isa::avx2, isa::avx512};
+	for(size_t n = 0; n < 140; n++)
+		for(int repeat = 0; repeat < 3; repeat++)
+		{
+			vector<T> v(n);
+			for(T& x : v) x = random_value<T>();
+			for(isa level : levels)
+			{
+				isa_limit() = level;
+				right = right && same_at_level(v, false) && same_at_level(v, true);
+			}
+		}
+	for(size_t n : {1000, 1001, 1023, 4099})
+	{
+		vector<T> v(n);
+		for(T& x : v) x = random_value<T>();
+		for(isa level : levels)
+		{
+			isa_limit() = level;
+			right = right && same_at_level(v, false) && same_at_level(v, true);
+		}
+	}
+	isa_limit() = isa::avx512;
+	cout << (right ? "RIGHT" : "WRONG") << endl;
+}
+
+int main()
+{
+	check<int32_t>();
+	check<uint32_t>();
+	check<int64_t>();
+	check<uint64_t>();
+	check<float>();
+	check<double>();
+	// plain loops
+	check<int16_t>();
+}
@@ -0,0 +1,192 @@
+#include<iostream>
+#include<algorithm>
+#include<vector>
+#include<string>
+#include<cstdlib>
+
+#include "sda.h"
+#include "check.h"
+
+using namespace std;
+
+//
+//
+//	CHECK SPLICE
+//	split_off, append, prepend and splice against vector, both
+//	arrays grown from either end so either block can be taken
+//	over, also with allocators that do not compare equal; the
+//	longer part keeps its block, a larger array with room around
+//	it is taken over instead of copied
+
+
+template<class T>
+struct tagged_allocator
+{
+	typedef T value_type;
+
+	int tag = 0;
+
+	tagged_allocator() = default;
+	explicit tagged_allocator(int t) : tag(t) {}
+	template<class U>
+	tagged_allocator(const tagged_allocator<U>& o) noexcept : tag(o.tag) {}
+
+	T* allocate(size_t n) { return allocator<T>().allocate(n); }
+	void deallocate(T* p, size_t n) noexcept { allocator<T>().deallocate(p, n); }
+
+	template<class U>
+	bool operator==(const tagged_allocator<U>& o) const noexcept { return tag == o.tag; }
+	template<class U>
+	bool operator!=(const tagged_allocator<U>& o) const noexcept { return tag != o.tag; }
+};
+
+template<class T, class Allocator>
+void check(bool equal_alloc)
+{
+	typedef sda<T, Allocator> array;
+	bool right = true;
+	for(int round = 0; round < 2000; round++)
+	{
+		array a(Allocator(1)), b(Allocator(equal_alloc ? 1 : 2));
+		vector<T> va, vb;
+		fill(a, va, rand() % 100, 0);
+		fill(b, vb, rand() % 100, 1000);
+		size_t p = rand() % (va.size() + 1);
+		switch(rand() % 4)
+		{
+			case 0:
+				a.append(move(b));
+				va.insert(va.end(), vb.begin(), vb.end());
+				break;
+			case 1:
+				a.prepend(move(b));
+				va.insert(va.begin(), vb.begin(), vb.end());
+				break;
+			case 2:
+				right = right && size_t(a.splice(a.begin() + p, move(b)) - a.begin()) == p;
+				va.insert(va.begin() + p, vb.begin(), vb.end());
+				break;
+			case 3:
+			{
+				array c = a.split_off(p);
+				vector<T> vc(va.begin() + p, va.end());
+				va.erase(va.begin() + p, va.end());
+				c.push_back(make<T>(7));
+				c.push_front(make<T>(8));
+				vc.push_back(make<T>(7));
+				vc.insert(vc.begin(), make<T>(8));
+				right = right && equal(c.begin(), c.end(), vc.begin(), vc.end());
+				vb.clear();
+				b.clear();
+				break;
+			}
+		}
+		right = right && b.empty() && equal(a.begin(), a.end(), va.begin(), va.end());
+		// both stay usable
+		a.insert(a.begin() + a.size() / 2, make<T>(3));
+		va.insert(va.begin() + va.size() / 2, make<T>(3));
+		b.push_back(make<T>(4));
+		right = right && equal(a.begin(), a.end(), va.begin(), va.end()) && b.size() == 1;
+	}
+
+	// repeated appends of small arrays stay linear
+	array big(Allocator(1));
+	for(int i = 0; i < 100000; i++)
+	{
+		array x({make<T>(i), make<T>(i + 1)}, Allocator(equal_alloc ? 1 : 2));
+		big.append(move(x));
+	}
+	right = right && big.size() == 200000 && big[199999] == make<T>(100000);
+	cout << (right ? "RIGHT" : "WRONG") << endl;
+}
+
+// n values, room empty slots on both sides
+template<class A>
+A with_room(size_t n, size_t room, int from, int tag)
+{
+	typedef typename A::value_type T;
+	A a{typename A::allocator_type(tag)};
+	a.reserve_back(n + room);
+	for(size_t i = 0; i < n; i++) a.push_back(make<T>(from + int(i)));
+	a.reserve_front(n + room + room);
+	return a;
+}
+
+template<class T>
+void check_blocks()
+{
+	typedef sda<T, tagged_allocator<T>> array;
+	bool right = true;
+
+	// split_off moves the shorter part out
+	{
+		array a = with_room<array>(1000, 0, 0, 1), b = with_room<array>(1000, 0, 0, 1);
+		vector<T> v(a.begin(), a.end());
+		const T* da = a.data();
+		const T* db = b.data();
+		array c = a.split_off(100);
+		array d = b.split_off(900);
+		right = right && c.data() == da + 100 && a.data() != da && b.data() == db && d.data() != db + 900;
+		right = right && same(a, vector<T>(v.begin(), v.begin() + 100)) && same(c, vector<T>(v.begin() + 100, v.end()));
+		right = right && same(b, vector<T>(v.begin(), v.begin() + 900)) && same(d, vector<T>(v.begin() + 900, v.end()));
+		array e = c.split_off(0), f = d.split_off(d.size());
+		right = right && c.empty() && e.size() == 900 && f.empty() && d.size() == 100;
+	}
+
+	// append, prepend, splice: the larger array with room takes
+	// the smaller one in, its block is kept
+	for(int op = 0; op < 3; op++)
+	{
+		array a = with_room<array>(10, 0, 0, 1), b = with_room<array>(1000, 20, 100, 1);
+		vector<T> va(a.begin(), a.end()), vb(b.begin(), b.end());
+		const T* db = b.data();
+		if(op == 0)
+		{
+			a.append(move(b));
+			va.insert(va.end(), vb.begin(), vb.end());
+			right = right && a.data() == db - 10;
+		}
+		else if(op == 1)
+		{
+			a.prepend(move(b));
+			va.insert(va.begin(), vb.begin(), vb.end());
+			right = right && a.data() == db;
+		}
+		else
+		{
+			a.splice(a.begin() + 4, move(b));
+			va.insert(va.begin() + 4, vb.begin(), vb.end());
+			right = right && a.data() == db - 4;
+		}
+		right = right && same(a, va) && b.empty();
+	}
+
+	// the smaller array fits here: nothing moves but its elements
+	{
+		array a = with_room<array>(1000, 20, 0, 1), b = with_room<array>(10, 0, 100, 1);
+		const T* da = a.data();
+		a.append(move(b));
+		right = right && a.data() == da && a.size() == 1010 && a.back() == make<T>(109) && b.empty();
+	}
+
+	// a block of another allocator is never taken over
+	{
+		array a = with_room<array>(10, 0, 0, 1), b = with_room<array>(1000, 20, 100, 2);
+		vector<T> va(a.begin(), a.end());
+		va.insert(va.end(), b.begin(), b.end());
+		const T* db = b.data();
+		a.append(move(b));
+		right = right && a.data() != db - 10 && a.get_allocator().tag == 1 && same(a, va) && b.empty();
+	}
+	print(right);
+}
+
+int main()
+{
+	check<int, tagged_allocator<int>>(true);
+	check<int, tagged_allocator<int>>(false);
+	check<string, tagged_allocator<string>>(true);
+	check<string, tagged_allocator<string>>(false);
+	check_blocks<int>();
+	check_blocks<string>();
+}
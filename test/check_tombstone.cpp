@@ -0,0 +1,195 @@
+#include<iostream>
+#include<algorithm>
+#include<iterator>
+#include<vector>
+#include<string>
+#include<cstdlib>
+#include<memory>
+
+#include "sda_tombstone.h"
+#include "check.h"
+
+using namespace std;
+
+//
+//
+//	CHECK TOMBSTONE
+//	sda_tombstone against vector: erase in the middle leaves
+//	tombstones, pops at both ends, insert and compaction, forward
+//	and reverse iteration over the live elements; inserts between
+//	erases move fewer elements than plain sda, erased elements
+//	release what they own at once
+
+
+template<class T>
+bool same(sda_tombstone<T>& a, const vector<T>& v)
+{
+	const sda_tombstone<T>& c = a;
+	return a.size() == v.size() && equal(v.begin(), v.end(), a.begin(), a.end())
+		&& equal(v.rbegin(), v.rend(), make_reverse_iterator(c.end()), make_reverse_iterator(c.begin()));
+}
+
+template<class T>
+void check(size_t dead_percent)
+{
+	sda_tombstone<T> a(dead_percent);
+	vector<T> v;
+	bool right = true;
+	size_t with_tombstones = 0;
+	for(int i = 0; i < 30000; i++)
+	{
+		T val = make<T>(i);
+		int op = rand() % 14;
+		if(op < 5)
+		{
+			a.push_back(val);
+			v.push_back(val);
+		}
+		else if(op < 7)
+		{
+			a.push_front(val);
+			v.insert(v.begin(), val);
+		}
+		else if(op == 7)
+		{
+			size_t p = rand() % (v.size() + 1);
+			a.insert(p, val);
+			v.insert(v.begin() + p, val);
+		}
+		else if(op < 11 && !v.empty())
+		{
+			size_t p = rand() % v.size();
+			a.erase(p);
+			v.erase(v.begin() + p);
+		}
+		else if(op == 11 && !v.empty())
+		{
+			size_t p = rand() % v.size();
+			size_t q = min(v.size(), p + rand() % 10);
+			a.erase(p, q);
+			v.erase(v.begin() + p, v.begin() + q);
+		}
+		else if(op == 12 && !v.empty())
+		{
+			a.pop_back();
+			v.pop_back();
+		}
+		else if(!v.empty())
+		{
+			a.pop_front();
+			v.erase(v.begin());
+		}
+		if(a.dead()) with_tombstones++;
+		right = right && a.size() == v.size();
+		if(!v.empty())
+		{
+			size_t p = rand() % v.size();
+			right = right && a[p] == v[p] && a.at(p) == v[p] && a.front() == v.front() && a.back() == v.back();
+		}
+		if(i % 500 == 0)
+			right = right && same(a, v);
+		if(i % 5000 == 0)
+		{
+			a.compact();
+			right = right && a.dead() == 0 && same(a, v);
+		}
+	}
+	right = right && same(a, v) && with_tombstones > 1000;
+	// drain from both ends through the tombstones
+	while(!v.empty())
+	{
+		if(v.size() % 2)
+		{
+			a.pop_back();
+			v.pop_back();
+		}
+		else
+		{
+			a.pop_front();
+			v.erase(v.begin());
+		}
+		if(!v.empty())
+			right = right && a.front() == v.front() && a.back() == v.back();
+	}
+	right = right && a.empty() && a.begin() == a.end();
+	cout << (right ? "RIGHT" : "WRONG") << endl;
+}
+
+// every move of an element
+size_t moves = 0;
+struct counted
+{
+	int x = 0;
+	counted() = default;
+	counted(int v) : x(v) {}
+	counted(const counted& o) : x(o.x) { moves++; }
+	counted& operator=(const counted& o) { x = o.x; moves++; return *this; }
+	bool operator==(const counted& o) const { return x == o.x; }
+};
+
+// alternating insert / erase in the middle: inserts use up the
+// tombstones or shift one side, never a whole compaction per
+// operation, so fewer moves than plain sda
+void check_alternating()
+{
+	sda_tombstone<counted> a;
+	sda<counted> b;
+	vector<int> v;
+	for(int i = 0; i < 20000; i++)
+	{
+		a.push_back(i);
+		b.push_back(i);
+		v.push_back(i);
+	}
+	size_t tombstone_moves = 0, sda_moves = 0;
+	for(int i = 0; i < 4000; i++)
+	{
+		size_t p = v.size() / 4 + rand() % (v.size() / 2);
+		size_t q = v.size() / 4 + rand() % (v.size() / 2);
+		moves = 0;
+		a.erase(p);
+		a.insert(q, counted(-i));
+		tombstone_moves += moves;
+		moves = 0;
+		b.erase(b.begin() + p);
+		b.insert(b.begin() + q, counted(-i));
+		sda_moves += moves;
+		v.erase(v.begin() + p);
+		v.insert(v.begin() + q, -i);
+	}
+	bool right = a.size() == v.size() && tombstone_moves < sda_moves;
+	for(size_t i = 0; right && i < v.size(); i++) right = a[i].x == v[i];
+	cout << (right ? "RIGHT" : "WRONG") << endl;
+}
+
+// an erased element lets go of what it owns at once
+void check_release()
+{
+	sda_tombstone<shared_ptr<int>> a;
+	vector<shared_ptr<int>> held;
+	for(int i = 0; i < 100; i++)
+	{
+		held.push_back(make_shared<int>(i));
+		a.push_back(held.back());
+	}
+	bool right = true;
+	a.erase(50);
+	a.erase(10, 20);
+	right = right && a.dead() == 11 && held[50].use_count() == 1;
+	for(int i = 10; i < 20; i++) right = right && held[i].use_count() == 1;
+	right = right && held[9].use_count() == 2 && held[20].use_count() == 2 && *a[10] == 20;
+	// the tombstones are revived by inserts
+	a.insert(10, make_shared<int>(-1));
+	a.insert(40, make_shared<int>(-2));
+	right = right && a.dead() == 9 && *a[10] == -1 && *a[40] == -2 && a.size() == 91;
+	cout << (right ? "RIGHT" : "WRONG") << endl;
+}
+
+int main()
+{
+	check<int>(25);
+	check<int>(90);
+	check<string>(50);
+	check_alternating();
+	check_release();
+}
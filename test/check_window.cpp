@@ -0,0 +1,133 @@
+#include<iostream>
+#include<algorithm>
+#include<numeric>
+#include<functional>
+#include<deque>
+#include<string>
+#include<cstdlib>
+
+#include "sda_window.h"
+
+using namespace std;
+
+//
+//
+//	CHECK WINDOW
+//	sda_window against recomputing aggregate, min and max over
+//	a deque after every push, pop and expire, with sums and with
+//	non-commutative aggregates (2x2 matrix product, concatenation)
+
+
+struct mat
+{
+	long a, b, c, d;
+	bool operator==(const mat& o) const { return a == o.a && b == o.b && c == o.c && d == o.d; }
+};
+
+// product mod 1000003, associative but not commutative
+struct product
+{
+	mat operator()(const mat& x, const mat& y) const
+	{
+		const long p = 1000003;
+		return mat{(x.a * y.a + x.b * y.c) % p, (x.a * y.b + x.b * y.d) % p,
+			(x.c * y.a + x.d * y.c) % p, (x.c * y.b + x.d * y.d) % p};
+	}
+};
+
+struct concat
+{
+	string operator()(const string& x, const string& y) const { return x + y; }
+};
+
+long make_long() { return long(rand() % 1000) - 500; }
+mat make_mat() { return mat{rand() % 10L, rand() % 10L, rand() % 10L, rand() % 10L}; }
+string make_string() { return string(1 + rand() % 3, char('a' + rand() % 26)); }
+
+template<class W, class Agg, class Make, class Extrema>
+void check(W& w, Agg agg, Make make, Extrema extrema)
+{
+	typedef typename W::value_type T;
+	deque<T> d;
+	bool right = true;
+	for(int i = 0; i < 50000; i++)
+	{
+		int op = rand() % 10;
+		if(op < 6)
+		{
+			T v = make();
+			w.push(v);
+			d.push_back(v);
+		}
+		else if(op < 9 && !d.empty())
+		{
+			w.pop();
+			d.pop_front();
+		}
+		else
+		{
+			size_t k = min<size_t>(rand() % 8, d.size());
+			w.expire(k);
+			d.erase(d.begin(), d.begin() + k);
+		}
+		right = right && w.size() == d.size();
+		if(!d.empty())
+		{
+			right = right && w.aggregate() == accumulate(d.begin() + 1, d.end(), d.front(), agg);
+			right = right && extrema(w, d) && w.front() == d.front() && w.back() == d.back();
+		}
+		if(i % 1000 == 0)
+			right = right && equal(w.begin(), w.end(), d.begin(), d.end());
+		// keep the window short enough to recompute
+		if(d.size() > 200)
+		{
+			w.expire(100);
+			d.erase(d.begin(), d.begin() + 100);
+		}
+	}
+	cout << (right ? "RIGHT" : "WRONG") << endl;
+}
+
+int main()
+{
+	auto no_extrema = [](const auto&, const auto&) { return true; };
+
+	sda_window<long> sum;
+	check(sum, plus<long>(), make_long, [](const auto& w, const deque<long>& d)
+	{
+		return w.min() == *min_element(d.begin(), d.end()) && w.max() == *max_element(d.begin(), d.end());
+	});
+
+	// reversed order: min() is the largest
+	sda_window<long, plus<long>, greater<long>> reversed;
+	check(reversed, plus<long>(), make_long, [](const auto& w, const deque<long>& d)
+	{
+		return w.min() == *max_element(d.begin(), d.end()) && w.max() == *min_element(d.begin(), d.end());
+	});
+
+	sda_window<mat, product, void> matrices;
+	check(matrices, product(), make_mat, no_extrema);
+
+	sda_window<string, concat> strings;
+	check(strings, concat(), make_string, [](const auto& w, const deque<string>& d)
+	{
+		return w.min() == *min_element(d.begin(), d.end()) && w.max() == *max_element(d.begin(), d.end());
+	});
+
+	// expire_while and the range push
+	sda_window<long> e;
+	deque<long> d;
+	for(int i = 0; i < 1000; i++)
+	{
+		long v = make_long();
+		e.push(v);
+		d.push_back(v);
+	}
+	e.expire_while([](long v) { return v < 300; });
+	while(!d.empty() && d.front() < 300) d.pop_front();
+	long more[] = {1, 2, 3, 6};
+	e.push(more, more + 4);
+	d.insert(d.end(), more, more + 4);
+	cout << (equal(e.begin(), e.end(), d.begin(), d.end())
+		&& e.aggregate() == accumulate(d.begin(), d.end(), 0L) ? "RIGHT" : "WRONG") << endl;
+}